@@ -0,0 +1,53 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_ARENA_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_ARENA_H
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+namespace em {
+
+/**
+ * Size of the scratch buffer used while handling a single audio session.
+ *
+ * This comfortably fits a `MAX_PATH` image name and a formatted log line, which
+ * is all that handling a session currently needs.
+ */
+constexpr inline std::size_t SessionArenaSize = 4096ull;
+
+/**
+ * Monotonic memory resource backed by an inline buffer.
+ *
+ * Intended to be constructed on the stack for the duration of some short unit
+ * of work, such as a pass over all sessions or a single session notification,
+ * so that the temporary strings it needs do not touch the heap. If the buffer
+ * is exhausted then allocations fall back to the upstream resource instead of
+ * failing.
+ */
+template<std::size_t N>
+class ScratchArena final {
+public:
+  explicit ScratchArena(std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+      : mResource{mBuf.data(), mBuf.size(), upstream} {}
+
+  ScratchArena(const ScratchArena &) = delete;
+  ScratchArena &operator=(const ScratchArena &) = delete;
+
+  [[nodiscard]] std::pmr::memory_resource *resource() noexcept {
+    return &mResource;
+  }
+
+  /**
+   * Release everything allocated from the arena so that the inline buffer can
+   * be reused, e.g. between sessions in the same pass.
+   */
+  void reset() noexcept { mResource.release(); }
+
+private:
+  alignas(std::max_align_t) std::array<std::byte, N> mBuf;
+  std::pmr::monotonic_buffer_resource mResource;
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_ARENA_H
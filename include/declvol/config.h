@@ -18,6 +18,11 @@ std::filesystem::path local_app_data();
  */
 std::filesystem::path get_default_config_path();
 
+/**
+ * Return the path of the default snapshot file.
+ */
+std::filesystem::path get_default_snapshot_path();
+
 }// namespace em
 
 #endif// VOLUME_SETTER_INCLUDE_DECLVOL_CONFIG_H
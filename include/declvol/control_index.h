@@ -0,0 +1,132 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_CONTROL_INDEX_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_CONTROL_INDEX_H
+
+#include "declvol/profile.h"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace em {
+
+/**
+ * Index of the controls of a profile that match a session field exactly, such
+ * as its display name, rather than a suffix of its image path.
+ *
+ * Each kind of field has a hash table from the text to the control that wins
+ * for it, built once when the profile is loaded, so matching costs one lookup
+ * per kind of field that the profile uses however many controls it has. Fields
+ * that no control uses are never fetched. Ancestor controls are kept here too,
+ * since like fields they can differ between sessions of the same executable,
+ * in a hash table from suffix to control along with the lengths of the
+ * suffixes, so matching an ancestor costs one lookup per distinct length.
+ *
+ * Controls are recorded by their position in the profile, which decides which
+ * of them wins. The index refers to the controls of the profile, which must
+ * outlive it.
+ */
+class ControlIndex {
+public:
+  explicit ControlIndex(const VolumeProfile &profile);
+
+  /**
+   * Return whether any control matches the given kind of field.
+   */
+  [[nodiscard]] bool uses(MatchKind kind) const noexcept {
+    if (kind == MatchKind::Ancestor) return !mAncestors.empty();
+    return kind != MatchKind::Suffix && !mControls[slot(kind)].empty();
+  }
+
+  /**
+   * Return the control that wins for a session, out of `suffixMatch`, the
+   * control of the profile matching the session's image path if any, and the
+   * controls matching its other fields.
+   *
+   * As with suffixes, whichever control comes last in the profile wins.
+   * `fetch(kind)` is called at most once for each kind of field that some
+   * control uses, and should return the value of that field of the session as
+   * an optional string, which is empty if the field cannot be found.
+   */
+  template<class F>
+  const VolumeControl *match(const VolumeControl *suffixMatch, F &&fetch) const {
+    auto winner{position(suffixMatch)};
+    for (const auto kind : {MatchKind::DisplayName, MatchKind::IconPath, MatchKind::SessionId}) {
+      const auto &controls{mControls[slot(kind)]};
+      if (controls.empty()) continue;
+
+      const auto value{fetch(kind)};
+      if (!value) continue;
+      const auto it{controls.find(std::string_view{*value})};
+      if (it != controls.end() && (winner == None || it->second > winner)) winner = it->second;
+    }
+    return control(winner);
+  }
+
+  /**
+   * Return the control that wins for a process out of `winner` and the
+   * ancestor controls matching any of its ancestors.
+   *
+   * `walk(visit)` should call `visit(path)` with the image path of each
+   * ancestor of the process, nearest first, until `visit` returns true. Like
+   * suffix controls, ancestor controls match the end of the path, and however
+   * far away the ancestor is, whichever control comes last in the profile
+   * wins. The walk is therefore stopped as soon as no ancestor control can
+   * beat the winner.
+   */
+  template<class F>
+  const VolumeControl *match_ancestors(const VolumeControl *winner, F &&walk) const {
+    auto best{position(winner)};
+    if (mAncestors.empty() || (best != None && best > mLastAncestor)) return winner;
+    walk([this, &best](std::string_view path) {
+      for (const auto length : mAncestorLengths) {
+        if (length > path.size()) break;
+        const auto it{mAncestors.find(path.substr(path.size() - length))};
+        if (it != mAncestors.end() && (best == None || it->second > best)) best = it->second;
+      }
+      return best == mLastAncestor;
+    });
+    return control(best);
+  }
+
+private:
+  static constexpr std::size_t NumFieldKinds = 3ull;
+  // Position standing for no control.
+  static constexpr std::size_t None = static_cast<std::size_t>(-1);
+
+  static constexpr std::size_t slot(MatchKind kind) noexcept {
+    return static_cast<std::size_t>(kind) - 1;
+  }
+
+  /**
+   * Return the position in the profile of a control of the profile, or `None`
+   * if it is null.
+   */
+  [[nodiscard]] std::size_t position(const VolumeControl *control) const noexcept {
+    return control ? static_cast<std::size_t>(control - mProfile->controls.data()) : None;
+  }
+
+  /**
+   * Return the control at a position in the profile, or null if it is `None`.
+   */
+  [[nodiscard]] const VolumeControl *control(std::size_t position) const noexcept {
+    return position == None ? nullptr : &mProfile->controls[position];
+  }
+
+  const VolumeProfile *mProfile;
+  // Position of the control that wins for each text of each kind of field.
+  std::array<std::unordered_map<std::string_view, std::size_t>, NumFieldKinds> mControls;
+  // Position of the ancestor control that wins for each suffix, the distinct
+  // lengths of those suffixes in increasing order, and the position of the
+  // last ancestor control.
+  std::unordered_map<std::string_view, std::size_t> mAncestors;
+  std::vector<std::size_t> mAncestorLengths;
+  std::size_t mLastAncestor{None};
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_CONTROL_INDEX_H
@@ -0,0 +1,68 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_EMBEDDED_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_EMBEDDED_H
+
+#include "declvol/profile.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+
+namespace em {
+
+/**
+ * A volume control compiled into the executable.
+ */
+struct EmbeddedControl {
+  std::string_view suffix;
+  float volume;
+  std::int64_t fadeMs;
+  RampCurve curve;
+  MatchKind kind{MatchKind::Suffix};
+};
+
+/**
+ * A volume profile compiled into the executable.
+ *
+ * Embedded profiles are generated at build time from a config file by the
+ * `embed_profiles` tool. Inheritance has already been flattened and redundant
+ * controls removed, exactly as `parse_profiles_toml` would do at runtime.
+ */
+struct EmbeddedProfile {
+  std::string_view name;
+  std::span<const EmbeddedControl> controls;
+};
+
+/**
+ * Size of the arena needed to hold a typical embedded profile once it has been
+ * converted to a `VolumeProfile`.
+ */
+constexpr inline std::size_t EmbeddedProfileArenaSize = 16384ull;
+
+/**
+ * Return the embedded profile with the given name, or null if there is none.
+ *
+ * `profiles` must be sorted by name, which the generated tables always are.
+ */
+constexpr const EmbeddedProfile *find_embedded_profile(
+    std::span<const EmbeddedProfile> profiles, std::string_view name) {
+  const auto it{std::ranges::lower_bound(profiles, name, {}, &EmbeddedProfile::name)};
+  return it != profiles.end() && it->name == name ? &*it : nullptr;
+}
+
+/**
+ * Return an embedded profile as an ordinary `VolumeProfile` allocated from
+ * `resource`.
+ *
+ * With a stack-backed arena this does not touch the heap, so resolving an
+ * embedded profile needs neither file I/O, parsing, nor allocation. Indexes
+ * built from the result to match sessions allocate as usual.
+ */
+VolumeProfile to_volume_profile(const EmbeddedProfile &profile,
+                                std::pmr::memory_resource *resource);
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_EMBEDDED_H
@@ -0,0 +1,135 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_EVENT_LOOP_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_EVENT_LOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace em {
+
+/**
+ * Handle that an event loop can wait on.
+ *
+ * On Windows this is a `HANDLE` to a waitable object such as an event, which
+ * is ready when signalled. Elsewhere it is a file descriptor, which is ready
+ * when readable.
+ */
+#ifdef _WIN32
+using NativeHandle = void *;
+#else
+using NativeHandle = int;
+#endif
+
+/**
+ * Runs handlers for many event sources on a single thread.
+ *
+ * Handlers are run when their source becomes ready, when they are posted from
+ * any thread, or when their delay elapses. Everything runs on the thread that
+ * called `run`, so handlers never run concurrently with one another, and
+ * handlers posted from the same thread run in the order they were posted.
+ * While nothing is ready the thread sleeps in a single wait on every source at
+ * once.
+ *
+ * Only `post`, `post_after` and `stop` may be called from other threads.
+ */
+class EventLoop {
+public:
+  using clock = std::chrono::steady_clock;
+  using Handler = std::function<void()>;
+
+  EventLoop() = default;
+
+  EventLoop(const EventLoop &) = delete;
+  EventLoop &operator=(const EventLoop &) = delete;
+
+  virtual ~EventLoop() = default;
+
+  /**
+   * Call `handler` whenever `handle` is ready, until the source is removed.
+   *
+   * The handler must do whatever makes the handle no longer ready, such as
+   * reading from it or resetting it, or it will be called again straight away.
+   */
+  virtual void add_source(NativeHandle handle, Handler handler) = 0;
+
+  /**
+   * Stop calling the handler of `handle`. This may be called from a handler,
+   * including the handler being removed.
+   */
+  virtual void remove_source(NativeHandle handle) = 0;
+
+  /**
+   * Run `handler` on the loop thread as soon as possible.
+   *
+   * This function is thread-safe.
+   */
+  void post(Handler handler);
+
+  /**
+   * Run `handler` on the loop thread once `delay` has elapsed.
+   *
+   * This function is thread-safe.
+   */
+  void post_after(clock::duration delay, Handler handler);
+
+  /**
+   * Run handlers until `stop` is called.
+   *
+   * Handlers that are still waiting to run when the loop stops are dropped
+   * along with the loop.
+   */
+  void run();
+
+  /**
+   * Make `run` return once the handler currently running, if any, finishes.
+   *
+   * This function is thread-safe.
+   */
+  void stop();
+
+protected:
+  /**
+   * Block until a source is ready, `wake` is called, or `timeout` elapses,
+   * and call the handlers of any sources that are ready.
+   *
+   * With no timeout, this blocks until a source is ready or `wake` is called.
+   */
+  virtual void wait(std::optional<clock::duration> timeout) = 0;
+
+  /**
+   * Make a call to `wait`, either in progress or the next one, return.
+   *
+   * This function must be thread-safe.
+   */
+  virtual void wake() = 0;
+
+private:
+  /**
+   * Run every posted handler and every timed handler that is due, and return
+   * how long until the next timed handler is due, if there is one.
+   */
+  std::optional<clock::duration> run_ready();
+
+  std::mutex mMut;
+  std::vector<Handler> mPosted;
+  std::multimap<clock::time_point, Handler> mTimers;
+  std::atomic<bool> mStopped{false};
+};
+
+/**
+ * Return an event loop using the best mechanism available on the current
+ * platform.
+ *
+ * On Windows this waits with `WaitForMultipleObjects`, so can watch at most
+ * 63 sources. Elsewhere it uses epoll.
+ */
+std::unique_ptr<EventLoop> make_event_loop();
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_EVENT_LOOP_H
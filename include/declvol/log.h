@@ -0,0 +1,159 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_LOG_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_LOG_H
+
+#include "declvol/exception.h"
+#include "declvol/queue.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <semaphore>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace em {
+
+/**
+ * Type of errors that occur when setting up logging.
+ */
+class LogError : public VolumeException {
+public:
+  explicit LogError(const std::string &msg) : VolumeException(msg) {}
+};
+
+/**
+ * Severity of a log line.
+ */
+enum class LogLevel : std::uint8_t {
+  Info,
+  Warning,
+  Error,
+};
+
+/**
+ * Logger that writes lines from a background thread.
+ *
+ * Logging formats the line into a fixed-size record and pushes it onto a
+ * lock-free ring buffer, so it neither allocates nor waits on the console or
+ * file. A dedicated thread writes the lines out in order and flushes whenever
+ * it runs out of lines to write. If the buffer fills up, because the output is
+ * slower than the lines arrive, then new lines are dropped and counted rather
+ * than blocking the caller, and the writer reports how many were lost.
+ *
+ * Lines longer than `MaxLineSize` are truncated. Every queued line is written
+ * before the logger is destroyed.
+ */
+class Logger {
+public:
+  static constexpr std::size_t Capacity = 256ull;
+  static constexpr std::size_t MaxLineSize = 512ull;
+
+  /**
+   * Create a logger writing informational lines to standard output, and
+   * warnings and errors to standard error.
+   */
+  explicit Logger(LogLevel minLevel = LogLevel::Info);
+
+  /**
+   * Create a logger appending every line to a file, prefixed with the time and
+   * level of the line.
+   *
+   * \throws LogError if the file cannot be opened.
+   */
+  Logger(const std::filesystem::path &path, LogLevel minLevel = LogLevel::Info);
+
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+
+  ~Logger();
+
+  /**
+   * Return whether lines of the given level are written.
+   */
+  [[nodiscard]] bool enabled(LogLevel level) const noexcept {
+    return level >= mMinLevel;
+  }
+
+  /**
+   * Queue a formatted line to be written.
+   *
+   * This function is thread-safe and lock-free, and does not allocate.
+   */
+  template<class... Args>
+  void log(LogLevel level, std::format_string<Args...> fmt, Args &&...args) {
+    if (!enabled(level)) return;
+
+    Line line{level, std::chrono::system_clock::now(), 0, {}};
+    const auto result{std::format_to_n(line.text.data(), static_cast<std::ptrdiff_t>(line.text.size()),
+                                       fmt, std::forward<Args>(args)...)};
+    line.size = static_cast<std::uint32_t>(
+        std::min(static_cast<std::size_t>(result.size), line.text.size()));
+    push(line);
+  }
+
+  template<class... Args>
+  void info(std::format_string<Args...> fmt, Args &&...args) {
+    log(LogLevel::Info, fmt, std::forward<Args>(args)...);
+  }
+
+  template<class... Args>
+  void warn(std::format_string<Args...> fmt, Args &&...args) {
+    log(LogLevel::Warning, fmt, std::forward<Args>(args)...);
+  }
+
+  template<class... Args>
+  void error(std::format_string<Args...> fmt, Args &&...args) {
+    log(LogLevel::Error, fmt, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Wait until every line queued so far has been written.
+   */
+  void flush();
+
+  /**
+   * Return the number of lines dropped because the buffer was full.
+   */
+  [[nodiscard]] std::uint64_t dropped() const {
+    return mDropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Line {
+    LogLevel level;
+    std::chrono::system_clock::time_point time;
+    std::uint32_t size;
+    std::array<char, MaxLineSize> text;
+  };
+
+  void push(const Line &line);
+
+  void run(std::stop_token stop);
+
+  void write(const Line &line);
+
+  LogLevel mMinLevel;
+  std::ofstream mFile;
+  // Kept off the stack of whoever owns the logger because it is large.
+  std::unique_ptr<BoundedQueue<Line, Capacity>> mLines;
+  std::counting_semaphore<> mPending{0};
+  std::atomic<std::uint64_t> mPushed{0};
+  std::atomic<std::uint64_t> mWritten{0};
+  std::atomic<std::uint64_t> mDropped{0};
+  // Declared last so that the thread stops before anything it uses is
+  // destroyed.
+  std::jthread mThread;
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_LOG_H
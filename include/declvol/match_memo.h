@@ -0,0 +1,78 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_MATCH_MEMO_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_MATCH_MEMO_H
+
+#include "declvol/control_index.h"
+#include "declvol/profile.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace em {
+
+/**
+ * Memo of which control of a profile matches each recently seen image path.
+ *
+ * Most sessions come from the same few executables, so remembering the winning
+ * control for each saves scanning every suffix of the profile again. The memo
+ * owns the profile it was built for, so replacing the memo along with the
+ * profile invalidates it in one step and a memo can never answer for a profile
+ * other than its own.
+ *
+ * The memo is a direct-mapped table of `Capacity` entries, so its size is
+ * bounded and a path that collides with another simply replaces it. Paths that
+ * match no control are remembered too.
+ */
+class MatchMemo {
+public:
+  static constexpr std::size_t Capacity = 64ull;
+
+  explicit MatchMemo(std::shared_ptr<const VolumeProfile> profile)
+      : mProfile{std::move(profile)}, mIndex{*mProfile} {}
+
+  MatchMemo(const MatchMemo &) = delete;
+  MatchMemo &operator=(const MatchMemo &) = delete;
+
+  /**
+   * Return the profile that the memo is for.
+   */
+  [[nodiscard]] const VolumeProfile &profile() const noexcept {
+    return *mProfile;
+  }
+
+  /**
+   * Return the index of the profile's controls that match other fields of a
+   * session, built along with the memo.
+   */
+  [[nodiscard]] const ControlIndex &index() const noexcept {
+    return mIndex;
+  }
+
+  /**
+   * Return the control of the profile matching `name`, as `match_control`
+   * does, or null if there is none.
+   *
+   * If `hit` is given then it is set to whether the answer came from the memo.
+   * This function is thread-safe.
+   */
+  const VolumeControl *match(std::string_view name, bool *hit = nullptr);
+
+private:
+  struct Entry {
+    bool used{false};
+    std::string name;
+    const VolumeControl *control{};
+  };
+
+  std::shared_ptr<const VolumeProfile> mProfile;
+  ControlIndex mIndex;
+  std::mutex mMut;
+  std::array<Entry, Capacity> mEntries{};
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_MATCH_MEMO_H
@@ -3,14 +3,31 @@
 
 #include "declvol/windows.h"
 
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace em {
 
 /**
  * Return the full executable name of the given process.
+ *
+ * The name is allocated from `resource`, so passing a scratch arena lets
+ * callers on the session notification path avoid the heap entirely.
  */
-std::string get_process_image_name(const winrt::handle &processHandle);
+std::pmr::string get_process_image_name(
+    const winrt::handle &processHandle,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+/**
+ * Return the PID of the process that started the given process.
+ *
+ * The parent may since have exited, and its PID have been reused.
+ */
+DWORD get_parent_process_id(const winrt::handle &processHandle);
 
 /**
  * Return a handle to the given process with the
@@ -18,6 +35,39 @@ std::string get_process_image_name(const winrt::handle &processHandle);
  */
 winrt::handle open_process(DWORD pid);
 
+/**
+ * Maps the NT device paths that the kernel gives image names in, such as
+ * `\Device\HarddiskVolume3\Windows\explorer.exe`, to the drive letter paths
+ * that `get_process_image_name` returns.
+ *
+ * The devices behind each drive letter are read when the map is made, so a map
+ * should only be kept for as long as a batch of lookups.
+ */
+class DosDeviceMap {
+public:
+  DosDeviceMap();
+
+  /**
+   * Return `ntPath` with its device replaced by the drive letter of that
+   * device, or by `\\` for network shares, or as it is if neither is known.
+   */
+  [[nodiscard]] std::string to_dos_path(std::wstring_view ntPath) const;
+
+private:
+  // Device path of each drive letter, such as `\Device\HarddiskVolume3` and
+  // `C:`.
+  std::vector<std::pair<std::wstring, std::wstring>> mDevices;
+};
+
+/**
+ * Return the full executable name of the process with the given PID, or an
+ * empty optional if there is no such process.
+ *
+ * Unlike `get_process_image_name` this does not open the process, so it also
+ * works for protected processes and others that cannot be opened.
+ */
+std::optional<std::string> query_process_image_name(DWORD pid, const DosDeviceMap &devices);
+
 }// namespace em
 
 #endif// VOLUME_SETTER_INCLUDE_DECLVOL_PROCESS_H
@@ -0,0 +1,203 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_PROCESS_INDEX_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_PROCESS_INDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace em {
+
+/**
+ * Notified of processes starting and stopping.
+ */
+class ProcessObserver {
+public:
+  virtual ~ProcessObserver() = default;
+
+  /**
+   * Called with a process that started, and the PID of the process that
+   * started it, which is zero if it is not known.
+   */
+  virtual void process_started(std::uint32_t pid, std::uint32_t parentPid, std::string_view imagePath) = 0;
+
+  virtual void process_stopped(std::uint32_t pid) = 0;
+};
+
+/**
+ * Operating system interface for finding and watching running processes.
+ */
+class ProcessSource {
+public:
+  virtual ~ProcessSource() = default;
+
+  /**
+   * Report every running process whose image path can be determined to
+   * `observer.process_started`, from a single snapshot of the system.
+   */
+  virtual void snapshot(ProcessObserver &observer) = 0;
+
+  /**
+   * Return the image path of a single process, or an empty optional if it
+   * cannot be determined, such as because the process has exited or is
+   * protected.
+   */
+  virtual std::optional<std::string> image_path(std::uint32_t pid) = 0;
+
+  /**
+   * Return the PID of the process that started a single process, or an empty
+   * optional if it cannot be determined.
+   *
+   * The parent may since have exited, and its PID have been reused.
+   */
+  virtual std::optional<std::uint32_t> parent_pid(std::uint32_t pid) = 0;
+
+  /**
+   * Find the image paths of many processes at once, calling `f(i, path)` with
+   * the path of `pids[i]` for each `i` in order.
+   *
+   * Each path is passed on as soon as it is known, so that callers can act on
+   * it while the rest are resolved. Each distinct PID is only resolved once.
+   * Implementations should resolve the processes in whatever way is cheapest
+   * for many at once where they have one, such as without opening each
+   * process, and otherwise resolve each process individually, which is what
+   * the default implementation does.
+   * Where the full path of a process cannot be found, implementations may give
+   * just the file name of its image.
+   */
+  virtual void resolve(std::span<const std::uint32_t> pids,
+                       const std::function<void(std::size_t, std::optional<std::string_view>)> &f);
+
+  /**
+   * Start reporting processes starting and stopping to `observer` until the
+   * source is destroyed.
+   *
+   * The observer is called from a thread owned by the source, and must outlive
+   * it. Events may arrive some time after the process started or stopped.
+   */
+  virtual void watch(ProcessObserver &observer) = 0;
+};
+
+/**
+ * Return a process source using the best mechanism available on the current
+ * platform.
+ *
+ * On Windows this takes snapshots with the Tool Help library and is told of
+ * process events by WMI. Elsewhere it reads `/proc`, and notices events by
+ * periodically comparing snapshots.
+ */
+std::unique_ptr<ProcessSource> make_process_source();
+
+/**
+ * Index from PID to the image path and parent of every running process.
+ *
+ * The index is seeded from one snapshot when it is constructed and then kept
+ * current by process start and stop events, so that finding the image path of
+ * a process is usually a hash lookup rather than opening the process and
+ * querying it. Processes that the index has not yet heard about, because their
+ * start event has not arrived, are resolved directly and added.
+ *
+ * Ancestors are only ever looked up in the index. A process whose parent has
+ * exited has no ancestors beyond it, since the parent is removed from the
+ * index when it stops. If the parent's PID has already been reused by the time
+ * the process is looked up, the process that reused it is taken for its
+ * parent, which is the same mistake any tool relying on parent PIDs makes.
+ */
+class ProcessIndex final : private ProcessObserver {
+public:
+  // Deepest ancestor that is looked at, which bounds each walk and stops it
+  // going round a cycle made by reused PIDs.
+  static constexpr std::size_t MaxAncestors = 16ull;
+
+  /**
+   * Create an index of the processes of `source`, which keeps itself current
+   * if `watch` is true, or otherwise only knows the processes running when it
+   * is created and those that it resolves.
+   */
+  explicit ProcessIndex(std::unique_ptr<ProcessSource> source, bool watch = true);
+
+  ProcessIndex(const ProcessIndex &) = delete;
+  ProcessIndex &operator=(const ProcessIndex &) = delete;
+
+  ~ProcessIndex() override;
+
+  /**
+   * Return the image path of the process with the given PID, allocated from
+   * `resource`, or an empty optional if it cannot be determined.
+   *
+   * This function is thread-safe.
+   */
+  std::optional<std::pmr::string> image_path(
+      std::uint32_t pid,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+  /**
+   * Call `f(path)` with the image path of each ancestor of the process with
+   * the given PID that is in the index, nearest first, until `f` returns true
+   * or `MaxAncestors` have been visited.
+   *
+   * This function is thread-safe. `f` is called with the index locked, so it
+   * must not call back into the index.
+   */
+  template<class F>
+  void for_each_ancestor(std::uint32_t pid, F &&f) const {
+    std::shared_lock lock{mMut};
+    auto it{mProcesses.find(pid)};
+    for (std::size_t depth{0}; it != mProcesses.end() && depth < MaxAncestors; ++depth) {
+      const auto parent{it->second.parent};
+      if (parent == 0) return;
+      it = mProcesses.find(parent);
+      if (it == mProcesses.end() || f(std::string_view{it->second.path})) return;
+    }
+  }
+
+  /**
+   * Return the number of processes in the index.
+   *
+   * This function is thread-safe.
+   */
+  [[nodiscard]] std::size_t size() const;
+
+  /**
+   * Return the number of lookups answered by the index, and the number that
+   * had to resolve the process directly.
+   */
+  [[nodiscard]] std::uint64_t hits() const {
+    return mHits.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::uint64_t misses() const {
+    return mMisses.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Process {
+    std::string path;
+    // Zero if not known.
+    std::uint32_t parent{};
+  };
+
+  void process_started(std::uint32_t pid, std::uint32_t parentPid, std::string_view imagePath) override;
+
+  void process_stopped(std::uint32_t pid) override;
+
+  mutable std::shared_mutex mMut;
+  std::unordered_map<std::uint32_t, Process> mProcesses;
+  std::atomic<std::uint64_t> mHits{0};
+  std::atomic<std::uint64_t> mMisses{0};
+  // Declared last so that the source stops calling back before the index is
+  // destroyed.
+  std::unique_ptr<ProcessSource> mSource;
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_PROCESS_INDEX_H
@@ -3,8 +3,12 @@
 
 #include "declvol/exception.h"
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <map>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -22,39 +26,208 @@ public:
                         std::string_view context);
 };
 
+/**
+ * Shape of a volume ramp over its duration.
+ */
+enum class RampCurve {
+  Linear,
+  EaseIn,
+  EaseOut,
+  Smooth,
+};
+
+/**
+ * How a control should move a volume to its target.
+ *
+ * A zero duration, the default, changes the volume instantly.
+ */
+struct Fade {
+  std::chrono::milliseconds duration{0};
+  RampCurve curve{RampCurve::Linear};
+};
+
+/**
+ * What a control matches against.
+ */
+enum class MatchKind : std::uint8_t {
+  // The end of the image path of the session's process, or a special suffix.
+  Suffix,
+  // The whole display name that the application gave the session.
+  DisplayName,
+  // The whole icon path that the application gave the session.
+  IconPath,
+  // The whole session identifier, which is the same for every session that an
+  // application opens on the same device.
+  SessionId,
+  // The end of the image path of any process that the session's process was
+  // started by, directly or not, such as a launcher.
+  Ancestor,
+};
+
+/**
+ * Return the config key naming a kind of control.
+ */
+constexpr std::string_view match_kind_name(MatchKind kind) {
+  switch (kind) {
+  case MatchKind::Suffix: return "suffix";
+  case MatchKind::DisplayName: return "display_name";
+  case MatchKind::IconPath: return "icon_path";
+  case MatchKind::SessionId: return "session_id";
+  case MatchKind::Ancestor: return "ancestor";
+  }
+  return "suffix";
+}
+
 class VolumeControl {
 public:
-  explicit VolumeControl(std::string suffix, float relativeVolume);
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
+  explicit VolumeControl(std::string_view suffix, float relativeVolume,
+                         const allocator_type &alloc = {})
+      : VolumeControl(suffix, relativeVolume, Fade{}, alloc) {}
+
+  explicit VolumeControl(std::string_view suffix, float relativeVolume,
+                         Fade fade, const allocator_type &alloc = {})
+      : VolumeControl(MatchKind::Suffix, suffix, relativeVolume, fade, alloc) {}
+
+  explicit VolumeControl(MatchKind kind, std::string_view key, float relativeVolume,
+                         Fade fade, const allocator_type &alloc = {});
+
+  VolumeControl(const VolumeControl &other, const allocator_type &alloc)
+      : mSuffix{other.mSuffix, alloc}, mRelativeVolume{other.mRelativeVolume},
+        mFade{other.mFade}, mKind{other.mKind} {}
+  VolumeControl(VolumeControl &&other, const allocator_type &alloc)
+      : mSuffix{std::move(other.mSuffix), alloc}, mRelativeVolume{other.mRelativeVolume},
+        mFade{other.mFade}, mKind{other.mKind} {}
 
   VolumeControl(const VolumeControl &) = default;
   VolumeControl &operator=(const VolumeControl &) = default;
   VolumeControl(VolumeControl &&) noexcept = default;
   VolumeControl &operator=(VolumeControl &&) noexcept = default;
 
-  [[nodiscard]] const std::string &suffix() const noexcept {
+  /**
+   * Return the text that the control matches, which is a suffix of the image
+   * path for suffix controls, or the exact value of the field otherwise.
+   */
+  [[nodiscard]] const std::pmr::string &suffix() const noexcept {
     return mSuffix;
   }
 
+  [[nodiscard]] MatchKind kind() const noexcept {
+    return mKind;
+  }
+
   [[nodiscard]] float relative_volume() const noexcept {
     return mRelativeVolume;
   }
 
+  [[nodiscard]] const Fade &fade() const noexcept {
+    return mFade;
+  }
+
 private:
-  std::string mSuffix;
+  std::pmr::string mSuffix;
   float mRelativeVolume;
+  Fade mFade;
+  MatchKind mKind{MatchKind::Suffix};
 };
 
 struct VolumeProfile {
-  std::vector<VolumeControl> controls;
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
+  VolumeProfile() = default;
+  explicit VolumeProfile(const allocator_type &alloc) : controls{alloc} {}
+  VolumeProfile(const VolumeProfile &other, const allocator_type &alloc)
+      : controls{other.controls, alloc} {}
+  VolumeProfile(VolumeProfile &&other, const allocator_type &alloc)
+      : controls{std::move(other.controls), alloc} {}
+
+  VolumeProfile(const VolumeProfile &) = default;
+  VolumeProfile &operator=(const VolumeProfile &) = default;
+  VolumeProfile(VolumeProfile &&) noexcept = default;
+  VolumeProfile &operator=(VolumeProfile &&) noexcept = default;
+
+  std::pmr::vector<VolumeControl> controls;
 };
 
+/**
+ * Return the control in the profile that decides the volume of something with
+ * the given name, or null if no control matches.
+ *
+ * The name is typically the image path of a process, or one of the special
+ * suffixes such as `:device`. As documented in the config file, the last
+ * control whose suffix matches the name is the one that wins. Only suffix
+ * controls are considered, see `ControlIndex` for the others.
+ */
+const VolumeControl *match_control(const VolumeProfile &profile, std::string_view name);
+
+/**
+ * Return the last suffix control in the profile whose suffix is exactly
+ * `suffix`, or null if there is none.
+ *
+ * This is how the controls for the special suffixes such as `:device` are
+ * found, so that they are not matched by controls with shorter suffixes.
+ */
+const VolumeControl *find_control(const VolumeProfile &profile, std::string_view suffix);
+
+/**
+ * Return the profile made by laying `layer` over `base`, allocated from
+ * `resource`.
+ *
+ * The controls of `layer` come after those of `base`, so they take priority,
+ * and any control of `base` that `layer` replaces or shadows is removed, as
+ * `parse_profiles_toml` does. This is the same
+ * as a profile extending `base` with the controls of `layer`.
+ */
+VolumeProfile overlay_profile(const VolumeProfile &base, const VolumeProfile &layer,
+                              std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+/**
+ * A control that was removed from a profile because it can never win.
+ */
+struct DeadControl {
+  // Name of the profile in which the control became dead. A control inherited
+  // by other profiles is only reported for the profile that defines it.
+  std::string profile;
+  MatchKind kind{};
+  std::string key;
+  float volume{};
+  // Text of the later control that wins wherever this one would match. This
+  // is the same as `key` if the control was a duplicate, and otherwise a
+  // suffix of it.
+  std::string winner;
+};
+
+/**
+ * Collection of volume profiles keyed by name.
+ *
+ * The comparator is transparent so that profiles can be looked up with a
+ * `std::string_view` without first allocating a key.
+ */
+using ProfileMap = std::pmr::map<std::pmr::string, VolumeProfile, std::less<>>;
+
 /**
  * Return the volume profiles defined by a TOML configuration file.
  *
+ * Profiles that extend other profiles are flattened, so each profile in the
+ * returned map holds every control that applies to it, with any control that
+ * can never win removed. That is a control matching the same field against the
+ * same text as a later control, or a suffix control whose suffix ends with the
+ * suffix of a later one, since that matches everything this one does. Special
+ * suffixes such as `:device` are looked up exactly rather than matched, so
+ * they are only removed if they are duplicated. If `dead` is given then each
+ * removed control is appended to it.
+ *
+ * The map and all the controls in it are allocated from `resource`. Since the
+ * profiles are never modified after being read, a monotonic resource is a good
+ * fit.
+ *
  * \throws ProfileError if the profile cannot be read.
  */
-std::map<std::string, em::VolumeProfile>
-parse_profiles_toml(const std::filesystem::path &profilePath);
+ProfileMap parse_profiles_toml(
+    const std::filesystem::path &profilePath,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+    std::vector<DeadControl> *dead = nullptr);
 
 }// namespace em
 
@@ -0,0 +1,127 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_QUEUE_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace em {
+
+/**
+ * Fixed-capacity lock-free queue with any number of producers and consumers.
+ *
+ * This is Dmitry Vyukov's bounded MPMC queue. Each cell carries a sequence
+ * number saying whether it is ready to be written or read on the current lap
+ * around the buffer, so producers and consumers only contend on their own
+ * position counter. Nothing is allocated after construction, and pushing never
+ * blocks, which makes the queue suitable for handing work off from threads
+ * that must not wait, such as COM callbacks.
+ *
+ * `Capacity` must be a power of two.
+ */
+template<class T, std::size_t Capacity>
+class BoundedQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  BoundedQueue() {
+    for (std::size_t i{0}; i < Capacity; ++i) {
+      mCells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  /**
+   * Add `value` to the back of the queue, or return false if the queue is full.
+   *
+   * This function is thread-safe and lock-free. If the queue is full then
+   * `value` is left untouched.
+   */
+  template<class U = T>
+  bool try_push(U &&value) {
+    auto pos{mEnqueuePos.load(std::memory_order_relaxed)};
+    for (;;) {
+      auto &cell{mCells[pos & Mask]};
+      const auto seq{cell.sequence.load(std::memory_order_acquire)};
+      const auto diff{static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos)};
+      if (diff == 0) {
+        if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value.emplace(std::forward<U>(value));
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = mEnqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Remove and return the value at the front of the queue, or return an empty
+   * optional if the queue is empty.
+   *
+   * This function is thread-safe and lock-free.
+   */
+  std::optional<T> try_pop() {
+    auto pos{mDequeuePos.load(std::memory_order_relaxed)};
+    for (;;) {
+      auto &cell{mCells[pos & Mask]};
+      const auto seq{cell.sequence.load(std::memory_order_acquire)};
+      const auto diff{static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1)};
+      if (diff == 0) {
+        if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          std::optional<T> value{std::move(cell.value)};
+          cell.value.reset();
+          cell.sequence.store(pos + Capacity, std::memory_order_release);
+          return value;
+        }
+      } else if (diff < 0) {
+        return std::nullopt;
+      } else {
+        pos = mDequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Return the number of values in the queue.
+   *
+   * The result is only a snapshot and may be out of date by the time it is
+   * used.
+   */
+  [[nodiscard]] std::size_t size() const {
+    const auto enqueued{mEnqueuePos.load(std::memory_order_relaxed)};
+    const auto dequeued{mDequeuePos.load(std::memory_order_relaxed)};
+    return enqueued >= dequeued ? enqueued - dequeued : 0;
+  }
+
+  [[nodiscard]] static constexpr std::size_t capacity() {
+    return Capacity;
+  }
+
+private:
+  static constexpr std::size_t Mask = Capacity - 1;
+  // Keep the producer and consumer positions on separate cache lines so that
+  // they do not contend with each other.
+  static constexpr std::size_t CacheLineSize = 64ull;
+
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    std::optional<T> value;
+  };
+
+  std::array<Cell, Capacity> mCells;
+  alignas(CacheLineSize) std::atomic<std::size_t> mEnqueuePos{0};
+  alignas(CacheLineSize) std::atomic<std::size_t> mDequeuePos{0};
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_QUEUE_H
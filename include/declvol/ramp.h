@@ -0,0 +1,207 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_RAMP_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_RAMP_H
+
+#include "declvol/profile.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace em {
+
+/**
+ * Return how far through a ramp with the given curve the volume should be
+ * when a fraction `t` of the ramp's duration has elapsed.
+ */
+constexpr float apply_ramp_curve(RampCurve curve, float t) noexcept {
+  t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+  switch (curve) {
+  case RampCurve::Linear: return t;
+  case RampCurve::EaseIn: return t * t;
+  case RampCurve::EaseOut: return t * (2.0f - t);
+  case RampCurve::Smooth: return t * t * (3.0f - 2.0f * t);
+  }
+  return t;
+}
+
+/**
+ * Something whose volume can be ramped, such as an audio session.
+ */
+class RampTarget {
+public:
+  virtual ~RampTarget() = default;
+
+  /**
+   * Return the current volume of the target.
+   */
+  [[nodiscard]] virtual float volume() = 0;
+
+  virtual void set_volume(float volume) = 0;
+};
+
+/**
+ * Drives every in-flight volume ramp from a single thread.
+ *
+ * Rather than having a thread or timer per ramp, the scheduler ticks at a fixed
+ * rate and advances every ramp that is due in the same tick. Each in-flight
+ * ramp has one entry in a timer wheel, in the slot of the tick on which it next
+ * moves, so a tick only looks at the ramps in its own slot. A ramp moving the
+ * volume slowly is written less often than every tick, at most once per
+ * `MinStep` of volume. The thread is only started once the first ramp is, and
+ * sleeps while no ramps are in flight.
+ *
+ * The volumes of a tick are worked out with the scheduler locked, and written
+ * once it is unlocked again, so that starting a ramp never waits for the
+ * volumes of other ramps to be written.
+ *
+ * Ramps are identified by a key, typically the session instance identifier.
+ * Starting a ramp with the key of one that is still in flight retargets it from
+ * whatever level it has currently reached.
+ *
+ * Ramp targets are called from the scheduler thread. On Windows that thread
+ * does not initialize COM itself and instead relies on the process-wide
+ * multithreaded apartment.
+ */
+class RampScheduler {
+public:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * Interval between successive ticks of the scheduler.
+   */
+  static constexpr auto TickInterval{std::chrono::milliseconds{10}};
+
+  /**
+   * Number of slots in the timer wheel.
+   *
+   * Ramps longer than `WheelSize * TickInterval` wrap around the wheel and are
+   * skipped over until the tick on which they actually finish.
+   */
+  static constexpr std::size_t WheelSize{256};
+
+  /**
+   * Smallest change in volume, on average over the ramp, that is worth writing.
+   *
+   * A ramp whose every tick would move the volume by less than this is only
+   * written every few ticks instead.
+   */
+  static constexpr float MinStep{1.0f / 256.0f};
+
+  RampScheduler() = default;
+
+  RampScheduler(const RampScheduler &) = delete;
+  RampScheduler &operator=(const RampScheduler &) = delete;
+
+  /**
+   * Ramp the volume of `target` to `volume` as described by `fade`.
+   *
+   * If a ramp with the same key is in flight then it is retargeted, starting
+   * from its current level. A zero-length fade sets the volume immediately,
+   * unless it retargets a ramp, in which case it is set on the next tick so
+   * that it lands after the ramp's last step.
+   */
+  void start(std::string_view key, std::shared_ptr<RampTarget> target,
+             float volume, const Fade &fade);
+
+  /**
+   * Stop the ramp with the given key, if any, leaving the volume wherever it
+   * currently is.
+   *
+   * A step of the ramp that is already being written may still land after the
+   * ramp is stopped.
+   */
+  void cancel(std::string_view key);
+
+  /**
+   * Return whether any ramps are in flight.
+   *
+   * Callers can use this to avoid computing a key for a change that does not
+   * need to ramp and could not be retargeting an existing ramp.
+   */
+  [[nodiscard]] bool has_ramps() const;
+
+  /**
+   * Block until every in-flight ramp has finished.
+   */
+  void wait_idle();
+
+private:
+  struct Ramp {
+    std::string key;
+    std::shared_ptr<RampTarget> target;
+    float from;
+    float to;
+    float current;
+    RampCurve curve;
+    std::uint64_t startTick;
+    std::uint64_t endTick;
+    // Ticks between writes of the volume, and the tick of the next one.
+    std::uint64_t stepTicks;
+    std::uint64_t nextTick;
+    std::uint32_t generation;
+    bool active;
+  };
+
+  struct WheelEntry {
+    std::size_t index;
+    std::uint32_t generation;
+  };
+
+  /**
+   * A volume worked out by a tick, to be written once the scheduler is
+   * unlocked.
+   */
+  struct Step {
+    std::size_t index;
+    std::uint32_t generation;
+    // Held so that retargeting the ramp while the volume is being written
+    // cannot destroy the target.
+    std::shared_ptr<RampTarget> target;
+    float volume;
+    // Whether the volume needs writing, which the last step may not.
+    bool write;
+    bool last;
+    bool failed;
+  };
+
+  struct KeyHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view key) const noexcept {
+      return std::hash<std::string_view>{}(key);
+    }
+  };
+
+  void run(std::stop_token stop);
+  void tick(std::unique_lock<std::mutex> &lock);
+  void schedule(std::size_t index);
+  void retire(std::size_t index);
+
+  mutable std::mutex mMut;
+  std::condition_variable_any mWake;
+  std::condition_variable_any mIdle;
+  std::vector<Ramp> mRamps;
+  std::vector<std::size_t> mFreeRamps;
+  std::unordered_map<std::string, std::size_t, KeyHash, std::equal_to<>> mIndex;
+  std::array<std::vector<WheelEntry>, WheelSize> mWheel;
+  // Only used by the thread, kept between ticks to reuse its storage.
+  std::vector<Step> mSteps;
+  std::uint64_t mTick{};
+  clock::time_point mNextTick{};
+  // Declared last so that the thread is joined before anything it uses is
+  // destroyed.
+  std::jthread mThread;
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_RAMP_H
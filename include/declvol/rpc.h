@@ -0,0 +1,58 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_RPC_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_RPC_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace em {
+
+/**
+ * Name of the interprocess queue used to notify the waiter process, if any,
+ * that the active profile has changed.
+ *
+ * On Windows at least, Boost.Interprocess creates a shared memory mapped file
+ * with this name, so it needs to be unique among all other programs that use
+ * that directory. Hopefully this one is, but if anybody finds a collision then
+ * it can be changed.
+ *
+ * For consistency reasons, it's important that at most one waiter process is
+ * running at a time across all versions of the software. This includes forks!
+ * This is guaranteed provided that all versions use the same `RpcQueueName`.
+ *
+ * If a breaking change to the queue or message format would cause buggy
+ * behaviour when a waiter and setter from different versions across that
+ * breaking change interact, then it may be better to increase the version
+ * number on the queue. This allows those versions to exist independently,
+ * preventing any bugs from mismatched queue formats, but violating consistency
+ * unless users are careful to not run those two versions simultaneously.
+ * The messages follow the Protobuf wire format, which allows a number of
+ * changes without breaking compatibility, so this is unlikely to be necessary.
+ *
+ * It was necessary for command batches, which is why the queue is at version
+ * 2. A waiter from before batches reads one as a request to switch to a profile
+ * with no name, which throws on its receiving thread and stops it receiving
+ * anything else, so those waiters must never see one.
+ */
+constexpr inline std::string_view RpcQueueName = "em_volume_setter_ipc_queue_v2";
+
+/**
+ * Maximum size of a serialized message in the interprocess queue.
+ *
+ * This sets a limit on the maximum size of the serialized messages used to
+ * communicate between waiters and setters. Increasing it does not
+ * constitute a breaking change.
+ */
+constexpr inline std::size_t MaxMessageSize = 512ull;
+
+/**
+ * Number of messages that the interprocess queue holds.
+ *
+ * A waiter takes requests off the queue as soon as they arrive, so one is
+ * enough, and a setter that finds the queue full reports it rather than
+ * waiting. `ipc_stress` measures how often that happens.
+ */
+constexpr inline std::size_t RpcQueueCapacity = 1ull;
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_RPC_H
@@ -0,0 +1,55 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_SESSION_MATCH_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_SESSION_MATCH_H
+
+#include "declvol/control_index.h"
+#include "declvol/match_memo.h"
+#include "declvol/process_index.h"
+#include "declvol/profile.h"
+#include "declvol/stats.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace em {
+
+/**
+ * Return the control that wins for the process `pid` out of `winner` and the
+ * ancestor controls of `index`.
+ *
+ * Ancestors are only looked up in `processes`, so without it no ancestor
+ * control matches.
+ */
+inline const VolumeControl *match_ancestors(const ControlIndex &index, const VolumeControl *winner,
+                                            std::uint32_t pid, const ProcessIndex *processes) {
+  if (!processes || pid == 0 || !index.uses(MatchKind::Ancestor)) return winner;
+  return index.match_ancestors(winner, [&](const auto &visit) { processes->for_each_ancestor(pid, visit); });
+}
+
+/**
+ * Return the control of the profile of `memo` that wins for a session of the
+ * process `pid`, whose image path is `name`, or null if none matches.
+ *
+ * The image path is looked up in the memo, and the other fields of the session
+ * are fetched with `fetch` as for `ControlIndex::match`. Fields and ancestors
+ * can differ between sessions of the same executable, so they are matched for
+ * every session rather than memoised. If `stats` is given then whether the
+ * memo answered is counted in it.
+ *
+ * This is everything that handling a new session does besides talking to the
+ * audio session itself, so once the memo has seen `name` it should not touch
+ * the heap as long as `fetch` does not.
+ */
+template<class F>
+const VolumeControl *match_session(MatchMemo &memo, std::string_view name, std::uint32_t pid, F &&fetch,
+                                   const ProcessIndex *processes, StatsPage *stats) {
+  bool hit{};
+  const auto *control{memo.match(name, &hit)};
+  if (stats) (hit ? stats->memoHits : stats->memoMisses).fetch_add(1, std::memory_order_relaxed);
+  control = memo.index().match(control, fetch);
+  return em::match_ancestors(memo.index(), control, pid, processes);
+}
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_SESSION_MATCH_H
@@ -0,0 +1,113 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_SNAPSHOT_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_SNAPSHOT_H
+
+#include "declvol/exception.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Snapshots of what the volume mixer shows, so that it can be put back later.
+ *
+ * A snapshot file starts with `Magic` and a varint version, followed by the
+ * device volume as a little-endian float and a mute byte, the varint number of
+ * sessions, and then each session: its name as a varint length followed by the
+ * bytes, its 16-byte grouping parameter, its volume and its mute byte.
+ */
+namespace em {
+
+/**
+ * Thrown when a snapshot cannot be written or read.
+ */
+class SnapshotError : public VolumeException {
+public:
+  explicit SnapshotError(const std::string &msg) : VolumeException(msg) {}
+};
+
+/**
+ * The bytes of the grouping parameter of a session, as laid out in its GUID.
+ */
+using GroupingKey = std::array<std::uint8_t, 16>;
+
+/**
+ * The state of one audio session in a snapshot.
+ */
+struct SessionSnapshot {
+  // Image path of the session's process, or `:system`.
+  std::string name;
+  GroupingKey grouping{};
+  float volume{};
+  bool muted{};
+};
+
+/**
+ * The state of the device and every audio session on it.
+ */
+struct VolumeSnapshot {
+  static constexpr std::string_view Magic = "DVSN";
+  static constexpr std::uint32_t Version = 1u;
+
+  float deviceVolume{};
+  bool deviceMuted{};
+  std::vector<SessionSnapshot> sessions;
+};
+
+/**
+ * Write `snapshot` to the file at `path`, replacing it if it exists.
+ *
+ * \throws SnapshotError if the file cannot be written.
+ */
+void write_snapshot(const std::filesystem::path &path, const VolumeSnapshot &snapshot);
+
+/**
+ * Read the snapshot in the file at `path`.
+ *
+ * \throws SnapshotError if the file cannot be read, or is not a snapshot of a
+ *         version this can read.
+ */
+VolumeSnapshot read_snapshot(const std::filesystem::path &path);
+
+/**
+ * Index of the sessions of a snapshot by name and grouping parameter.
+ *
+ * Finding the entry for a session is one hash lookup on its name followed by a
+ * look at the few groupings captured for that name, so restoring a snapshot is
+ * linear in the number of sessions rather than quadratic. The index refers to
+ * the sessions of the snapshot, which must outlive it.
+ */
+class SnapshotIndex {
+public:
+  explicit SnapshotIndex(const VolumeSnapshot &snapshot);
+
+  /**
+   * Return the entry captured for a session with the given name and grouping
+   * parameter, or null if there is none.
+   *
+   * Applications may choose a new grouping parameter each time they start, so
+   * if none of the entries for `name` has the same grouping then the last one
+   * captured for `name` is returned instead.
+   */
+  [[nodiscard]] const SessionSnapshot *find(std::string_view name, const GroupingKey &grouping) const;
+
+private:
+  struct KeyHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view key) const noexcept {
+      return std::hash<std::string_view>{}(key);
+    }
+  };
+
+  // Entries for each name, in the order they were captured.
+  std::unordered_map<std::string_view, std::vector<const SessionSnapshot *>, KeyHash, std::equal_to<>> mByName;
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_SNAPSHOT_H
@@ -0,0 +1,216 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_STATS_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_STATS_H
+
+#include "declvol/profile.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace em {
+
+/**
+ * Histogram of latencies with power-of-two bucket bounds.
+ *
+ * Bucket `i` counts latencies of at most `2^i` microseconds, except for the
+ * last bucket which counts everything larger. Unlike in OpenMetrics the buckets
+ * are not cumulative, so that recording only touches one of them.
+ */
+class LatencyHistogram {
+public:
+  static constexpr std::size_t NumBuckets = 24ull;
+
+  /**
+   * Return the upper bound of bucket `i` in microseconds.
+   */
+  static constexpr std::uint64_t bucket_bound(std::size_t i) {
+    return std::uint64_t{1} << i;
+  }
+
+  /**
+   * Record a single latency.
+   *
+   * This function is thread-safe and lock-free.
+   */
+  void record(std::chrono::nanoseconds latency) {
+    const auto ns{static_cast<std::uint64_t>(latency.count() < 0 ? 0 : latency.count())};
+    const auto us{(ns + 999u) / 1000u};
+    std::size_t i{0};
+    while (i + 1 < NumBuckets && us > bucket_bound(i)) ++i;
+    mBuckets[i].fetch_add(1, std::memory_order_relaxed);
+    mSumNs.fetch_add(ns, std::memory_order_relaxed);
+  }
+
+  /**
+   * Return the number of latencies recorded in bucket `i`.
+   */
+  [[nodiscard]] std::uint64_t bucket(std::size_t i) const {
+    return mBuckets[i].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Return the number of latencies recorded.
+   */
+  [[nodiscard]] std::uint64_t count() const {
+    std::uint64_t count{0};
+    for (const auto &bucket : mBuckets) count += bucket.load(std::memory_order_relaxed);
+    return count;
+  }
+
+  /**
+   * Return the sum of all recorded latencies.
+   */
+  [[nodiscard]] std::chrono::nanoseconds sum() const {
+    return std::chrono::nanoseconds{mSumNs.load(std::memory_order_relaxed)};
+  }
+
+private:
+  std::array<std::atomic<std::uint64_t>, NumBuckets> mBuckets{};
+  std::atomic<std::uint64_t> mSumNs{0};
+};
+
+/**
+ * Number of times each control has been matched, keyed by what it matches
+ * against and its suffix or other key, so that controls of different kinds with
+ * the same key are counted apart.
+ *
+ * Slots are claimed the first time a control is matched and never released, so
+ * counts survive profile switches and the table holds at most `MaxControls`
+ * distinct controls. Matches of any further controls are counted together.
+ * Keys are truncated to `MaxSuffixSize - 1` bytes.
+ */
+class ControlMatchTable {
+public:
+  static constexpr std::size_t MaxControls = 64ull;
+  static constexpr std::size_t MaxSuffixSize = 128ull;
+
+  /**
+   * Record a match of the control of the given kind and suffix or other key.
+   *
+   * This function is thread-safe. It is lock-free except for the first match of
+   * a control, which briefly waits for any concurrent claim of the same slot.
+   */
+  void record(MatchKind kind, std::string_view suffix);
+
+  /**
+   * Invoke `f` with the kind, suffix and match count of each claimed slot.
+   */
+  template<class F>
+  void for_each(F &&f) const {
+    for (const auto &slot : mSlots) {
+      if (slot.state.load(std::memory_order_acquire) != SlotState::Ready) continue;
+      f(slot.kind, std::string_view{slot.suffix.data(), slot.size},
+        slot.matches.load(std::memory_order_relaxed));
+    }
+  }
+
+  /**
+   * Return the number of matches of controls that did not fit in the table.
+   */
+  [[nodiscard]] std::uint64_t overflow() const {
+    return mOverflow.load(std::memory_order_relaxed);
+  }
+
+private:
+  enum class SlotState : std::uint32_t {
+    Empty,
+    Claiming,
+    Ready,
+  };
+
+  struct Slot {
+    std::atomic<SlotState> state{SlotState::Empty};
+    std::uint32_t size{0};
+    MatchKind kind{MatchKind::Suffix};
+    std::array<char, MaxSuffixSize> suffix{};
+    std::atomic<std::uint64_t> matches{0};
+  };
+
+  std::array<Slot, MaxControls> mSlots{};
+  std::atomic<std::uint64_t> mOverflow{0};
+};
+
+/**
+ * Counters describing what a waiter has done since it started.
+ *
+ * The page is designed to live in shared memory, written by the waiter and read
+ * by any other process without any interprocess communication, so it contains
+ * only lock-free atomics and fixed-size arrays. Readers must check `valid`
+ * before trusting any other field.
+ */
+class StatsPage {
+public:
+  /**
+   * Identifies an initialised page of this layout. Change the version whenever
+   * the layout changes.
+   */
+  static constexpr std::uint32_t Magic = 0x56445645u;
+  static constexpr std::uint32_t Version = 6u;
+
+  StatsPage() {
+    mMagic.store(Magic, std::memory_order_release);
+  }
+
+  StatsPage(const StatsPage &) = delete;
+  StatsPage &operator=(const StatsPage &) = delete;
+
+  /**
+   * Return whether the page has been initialised by a waiter of the same
+   * version.
+   */
+  [[nodiscard]] bool valid() const {
+    return mMagic.load(std::memory_order_acquire) == Magic && mVersion == Version;
+  }
+
+private:
+  // These come first so that readers of any version find them at the same
+  // offset.
+  std::atomic<std::uint32_t> mMagic{0};
+  std::uint32_t mVersion{Version};
+
+public:
+  // Audio sessions whose volume was set or checked.
+  std::atomic<std::uint64_t> sessionsHandled{0};
+  // Sessions whose process could not be opened.
+  std::atomic<std::uint64_t> openProcessFailures{0};
+  // Sessions that shared the resolved process and match of another session in
+  // the same process or group, instead of being resolved and matched again.
+  std::atomic<std::uint64_t> sessionsGrouped{0};
+  // Profile switches received from setters, counting each switch in a batch
+  // of commands, but not overrides.
+  std::atomic<std::uint64_t> switchesReceived{0};
+  // New sessions waiting to be handled.
+  std::atomic<std::uint64_t> queueDepth{0};
+  // New sessions that were deferred to the overflow list because the queue was
+  // full.
+  std::atomic<std::uint64_t> queueOverflows{0};
+  // New sessions whose control was found in the memo, or had to be matched.
+  std::atomic<std::uint64_t> memoHits{0};
+  std::atomic<std::uint64_t> memoMisses{0};
+  // Session volume changes made by something else that were put back when
+  // enforcing, or left alone because the session had been put back too often.
+  std::atomic<std::uint64_t> volumesEnforced{0};
+  std::atomic<std::uint64_t> enforcementsLimited{0};
+  // Time from a new session being announced to it being taken off the queue.
+  LatencyHistogram queueLatency;
+  // Time from a new session being announced to its volume being set.
+  LatencyHistogram applyLatency;
+  // Matches of each control.
+  ControlMatchTable controlMatches;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Stats are shared between processes so must be lock-free");
+
+/**
+ * Return the stats in the OpenMetrics text format.
+ */
+std::string format_openmetrics(const StatsPage &stats);
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_STATS_H
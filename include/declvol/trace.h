@@ -0,0 +1,173 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_TRACE_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_TRACE_H
+
+#include "declvol/exception.h"
+#include "declvol/wire.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * Recording of what a waiter reacts to, so that it can be replayed elsewhere.
+ *
+ * A trace is a file starting with `Magic` and a varint version, followed by
+ * one record after another. Each record is a kind byte, the varint number of
+ * microseconds since the previous record, and then the fields of that kind of
+ * record: varints for numbers, and a varint length followed by the bytes for
+ * strings. Traces are read back in order, and the reader stops at the first
+ * record that is cut short, such as by the waiter being terminated.
+ */
+namespace em {
+
+/**
+ * Thrown when a trace cannot be written or read.
+ */
+class TraceError : public VolumeException {
+public:
+  explicit TraceError(const std::string &msg) : VolumeException(msg) {}
+};
+
+/**
+ * Kinds of record in a trace.
+ */
+enum class TraceKind : std::uint8_t {
+  // An audio session was seen, whether it was announced or found when the
+  // profile was first applied.
+  SessionCreated = 1,
+  // A session expired or was disconnected.
+  SessionEnded = 2,
+  // A `SwitchProfileRequest` was received, or the waiter started with a
+  // profile.
+  Request = 3,
+  // A `SetOverride` command was received.
+  Override = 4,
+  // A `ClearOverrides` command was received.
+  ClearOverrides = 5,
+};
+
+/**
+ * One record of a trace.
+ *
+ * Only the fields used by its kind are meaningful.
+ */
+struct TraceRecord {
+  TraceKind kind{};
+  // Time since the trace was started.
+  std::chrono::microseconds time{};
+  // Number identifying the session among the sessions of the trace.
+  std::uint64_t session{};
+  std::uint32_t pid{};
+  // Image path of the session's process, or `:system`.
+  std::string name;
+  wire::Operation operation{};
+  std::string configPath;
+  std::string profile;
+  // Suffix and volume of an override.
+  std::string suffix;
+  float volume{};
+};
+
+/**
+ * Writes a trace to a file.
+ *
+ * Every function is thread-safe, and records are timestamped when they are
+ * written, so they are always in time order.
+ */
+class TraceWriter {
+public:
+  static constexpr std::string_view Magic = "DVTR";
+  static constexpr std::uint32_t Version = 2u;
+
+  /**
+   * Start a new trace in the file at `path`, replacing it if it exists.
+   *
+   * \throws TraceError if the file cannot be opened.
+   */
+  explicit TraceWriter(const std::filesystem::path &path);
+
+  TraceWriter(const TraceWriter &) = delete;
+  TraceWriter &operator=(const TraceWriter &) = delete;
+
+  /**
+   * Record a session being seen, and return the number identifying it in the
+   * trace.
+   */
+  std::uint64_t session_created(std::uint32_t pid, std::string_view name);
+
+  /**
+   * Record the session numbered `session` ending.
+   */
+  void session_ended(std::uint64_t session);
+
+  /**
+   * Record a request to change the active profile.
+   */
+  void request(wire::Operation operation, std::string_view configPath, std::string_view profile);
+
+  /**
+   * Record a command to override the volume of whatever matches `suffix`.
+   */
+  void set_override(std::string_view suffix, float volume);
+
+  /**
+   * Record a command to remove every override.
+   */
+  void clear_overrides();
+
+  /**
+   * Write out everything recorded so far.
+   */
+  void flush();
+
+private:
+  /**
+   * Begin a record of the given kind, with the lock held.
+   */
+  void begin(TraceKind kind);
+  void put_varint(std::uint64_t value);
+  void put_string(std::string_view value);
+
+  std::mutex mMut;
+  std::ofstream mFile;
+  // Time up to which the trace has been written.
+  std::chrono::steady_clock::time_point mLast;
+  std::uint64_t mNextSession{1};
+};
+
+/**
+ * Reads a trace written by `TraceWriter`.
+ */
+class TraceReader {
+public:
+  /**
+   * Open the trace in the file at `path`.
+   *
+   * \throws TraceError if the file cannot be opened or is not a trace of a
+   *         version this can read.
+   */
+  explicit TraceReader(const std::filesystem::path &path);
+
+  /**
+   * Return the next record of the trace, or an empty optional at its end.
+   *
+   * \throws TraceError if the record is not of a known kind.
+   */
+  std::optional<TraceRecord> next();
+
+private:
+  std::optional<std::uint64_t> get_varint();
+  std::optional<std::string> get_string();
+
+  std::ifstream mFile;
+  std::chrono::microseconds mTime{};
+};
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_TRACE_H
@@ -2,19 +2,32 @@
 #define VOLUME_SETTER_INCLUDE_DECLVOL_VOLUME_H
 
 #include "declvol/profile.h"
+#include "declvol/ramp.h"
 #include "declvol/windows.h"
 
 #include <audiopolicy.h>
+#include <endpointvolume.h>
 #include <mmdeviceapi.h>
 
 #include <concepts>
 #include <functional>
+#include <memory_resource>
 #include <optional>
 #include <ranges>
+#include <string>
 #include <string_view>
 
 namespace em {
 
+/**
+ * Event context passed with every volume change that this program makes.
+ *
+ * Volume change notifications carry the event context of the change, so this
+ * tells the changes made by this program apart from those made by anything
+ * else, such as the application itself.
+ */
+extern const GUID VolumeSetterEventContext;
+
 /**
  * Return the default output multimedia audio device.
  */
@@ -29,6 +42,11 @@ winrt::com_ptr<IMMDevice> get_default_audio_device();
 winrt::com_ptr<IAudioSessionManager2>
 get_audio_session_manager(const winrt::com_ptr<IMMDevice> &device);
 
+/**
+ * Return the volume control of an audio device.
+ */
+winrt::com_ptr<IAudioEndpointVolume> get_endpoint_volume(const winrt::com_ptr<IMMDevice> &device);
+
 /**
  * Return a view over the session controls enumerated by a session enumerator.
  */
@@ -59,16 +77,76 @@ auto get_audio_sessions(const winrt::com_ptr<IAudioSessionManager2> &sessionMgr)
  */
 DWORD get_process_id(const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl2);
 
+/**
+ * Return the display name that the application gave the audio session, which
+ * may be an indirect string such as `@%SystemRoot%\System32\foo.dll,-100`.
+ */
+std::string get_display_name(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl);
+
+/**
+ * Return the icon path that the application gave the audio session.
+ */
+std::string get_icon_path(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl);
+
+/**
+ * Return the identifier of the audio session.
+ *
+ * Unlike the instance identifier, this is shared by every session that the
+ * same application opens on the same device, so it stays the same across runs.
+ */
+std::string get_session_identifier(const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl2);
+
+/**
+ * Return the field of the audio session that controls of the given kind match
+ * on, for `ControlIndex::match`, allocated from `resource`.
+ *
+ * Suffix and ancestor controls match on image paths of processes, which are
+ * not fields of the session, so `kind` must not be `MatchKind::Suffix` or
+ * `MatchKind::Ancestor`.
+ */
+std::pmr::string get_session_field(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl, MatchKind kind,
+                                   std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+/**
+ * Return the grouping parameter of the audio session.
+ *
+ * Applications give related sessions the same grouping parameter so that they
+ * are shown as one in the volume mixer. Sessions without one have a null GUID.
+ */
+GUID get_grouping_param(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl);
+
+/**
+ * Return the identifier of a particular instance of an audio session.
+ *
+ * Unlike the PID, this uniquely identifies the session among all the sessions
+ * of the same process.
+ */
+std::string get_session_instance_id(const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl2);
+
 /**
  * Set the volume of the device to that specified in the profile.
  *
  * The device volume is given by controls with suffix `:device`. Like actual
  * suffixes, if there are multiple controls with this suffix then whichever
  * comes last takes precedence.
+ *
+ * If `ramps` is given then controls with a fade are ramped to their volume by
+ * the scheduler instead of being set immediately. The returned volume is the
+ * one being ramped to.
  */
 std::optional<float> set_device_volume(
     const VolumeProfile &profile,
-    const winrt::com_ptr<IMMDevice> &device);
+    const winrt::com_ptr<IMMDevice> &device,
+    RampScheduler *ramps = nullptr);
+
+/**
+ * Set the volume of the device to that of a single control.
+ *
+ * Fades are handled as in `set_device_volume`.
+ */
+void set_device_master_volume(const VolumeControl &control,
+                              const winrt::com_ptr<IMMDevice> &device,
+                              RampScheduler *ramps = nullptr);
 
 /**
  * Set the system sound volume to that specified in the profile.
@@ -76,23 +154,29 @@ std::optional<float> set_device_volume(
  * The system sound volume is given by controls with suffix `:system`. Like
  * actual suffixes, if there are multiple controls with this suffix then
  * whichever comes last takes precedence. `sessionCtrl` must be the system
- * sounds sessions.
+ * sounds sessions. Fades are handled as in `set_device_volume`.
  */
 std::optional<float> set_system_sound_volume(
     const VolumeProfile &profile,
-    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl);
+    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+    RampScheduler *ramps = nullptr);
 
 /**
- * Set the volume of a session with the given process image path.
+ * Set the volume of a session to that of a single control.
  *
- * The last volume control whose suffix matches the `procName` is used to set
- * the volume of the given session, which must be managed by a process with the
- * given name.
+ * The control is not checked against the session, so this is useful when the
+ * matching control is already known. Fades are handled as in
+ * `set_device_volume`.
  */
-std::optional<float> set_named_session_volume(
-    const VolumeProfile &profile,
-    std::string_view procName,
-    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl);
+void set_session_master_volume(const VolumeControl &control,
+                               const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+                               RampScheduler *ramps = nullptr);
+
+/**
+ * Return whether an audio session has expired, meaning that it will never
+ * produce audio again and can be forgotten about.
+ */
+bool is_session_expired(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl);
 
 /**
  * Callable to be invoked when an audio session is created.
@@ -141,6 +225,35 @@ void unregister_session_notification(
     const winrt::com_ptr<IAudioSessionManager2> &mgr,
     const winrt::com_ptr<IAudioSessionNotification> &handle);
 
+/**
+ * Handlers for the events of an audio session. Either may be empty.
+ */
+struct SessionEventHandlers {
+  // Called with the new master volume and the event context of the change.
+  std::move_only_function<void(float, const GUID *)> volumeChanged;
+  // Called when the session expires or is disconnected, after which it
+  // produces no more audio.
+  std::move_only_function<void()> ended;
+};
+
+/**
+ * Register handlers to be called when events happen to an audio session.
+ *
+ * The handlers are called on a thread owned by the audio service and should
+ * not block for long. They must not unregister themselves. The handlers should
+ * be deregistered by a call to `unregister_session_events` when they are no
+ * longer required, which waits for any call in progress to return.
+ */
+winrt::com_ptr<IAudioSessionEvents> register_session_events(
+    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl, SessionEventHandlers handlers);
+
+/**
+ * Unregister a previously registered session events handler.
+ */
+void unregister_session_events(
+    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+    const winrt::com_ptr<IAudioSessionEvents> &handle);
+
 }// namespace em
 
 #endif// VOLUME_SETTER_INCLUDE_DECLVOL_VOLUME_H
@@ -0,0 +1,51 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_WATCHER_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_WATCHER_H
+
+#include "declvol/event_loop.h"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+
+namespace em {
+
+/**
+ * Watches a single file for changes.
+ *
+ * Implementations watch the directory containing the file rather than the
+ * file itself, because many editors save by writing a new file and renaming it
+ * over the old one.
+ */
+class FileWatcher {
+public:
+  virtual ~FileWatcher() = default;
+
+  /**
+   * Block until the watched file changes or `timeout` elapses, whichever comes
+   * first.
+   *
+   * Returns whether the file changed. Spurious changes are possible, such as
+   * when the watcher misses events and cannot tell which files changed.
+   */
+  virtual bool wait_for_change(std::chrono::milliseconds timeout) = 0;
+
+  /**
+   * Return a handle that is ready whenever `wait_for_change` would not block,
+   * so that the watcher can be added to an event loop.
+   *
+   * The handle stays ready until `wait_for_change` is called.
+   */
+  [[nodiscard]] virtual NativeHandle native_handle() const = 0;
+};
+
+/**
+ * Return a watcher for the file at `path` using the best mechanism available
+ * on the current platform.
+ *
+ * On Windows this uses `ReadDirectoryChangesW`, elsewhere it uses inotify.
+ */
+std::unique_ptr<FileWatcher> make_file_watcher(const std::filesystem::path &path);
+
+}// namespace em
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_WATCHER_H
@@ -0,0 +1,208 @@
+#ifndef VOLUME_SETTER_INCLUDE_DECLVOL_WIRE_H
+#define VOLUME_SETTER_INCLUDE_DECLVOL_WIRE_H
+
+#include "declvol/exception.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+/**
+ * A small codec for the messages passed between setters and waiters.
+ *
+ * The messages are defined in `declvol.proto`, and this codec writes exactly
+ * the bytes that Protobuf would, plus a version field that Protobuf skips as an
+ * unknown field. A setter using this codec can therefore talk to a waiter using
+ * Protobuf and vice versa, without the executable having to load and
+ * initialise the Protobuf runtime just to copy two strings.
+ *
+ * Only the subset of the Protobuf wire format needed by the messages is
+ * written, but any valid Protobuf encoding of a message can be read.
+ */
+namespace em::wire {
+
+/**
+ * Thrown when a message cannot be encoded.
+ */
+class WireError : public VolumeException {
+public:
+  explicit WireError(const std::string &msg) : VolumeException(msg) {}
+};
+
+/**
+ * Protobuf wire types.
+ */
+enum class WireType : std::uint8_t {
+  Varint = 0,
+  I64 = 1,
+  Len = 2,
+  SGroup = 3,
+  EGroup = 4,
+  I32 = 5,
+};
+
+/**
+ * Return the tag introducing the field with the given number and type.
+ */
+constexpr std::uint32_t make_tag(std::uint32_t field, WireType type) {
+  return (field << 3u) | static_cast<std::uint32_t>(type);
+}
+
+/**
+ * Version of the messages written by this codec.
+ *
+ * Readers accept messages of any version, including messages without a version
+ * field, which are treated as version 0. New fields must therefore be optional,
+ * exactly as in Protobuf; the version only lets a reader tell what the writer
+ * knew about.
+ */
+constexpr inline std::uint32_t Version = 3u;
+
+/**
+ * Field number of the version in every message.
+ *
+ * This is reserved in `declvol.proto` and chosen so that its tag fits in one
+ * byte.
+ */
+constexpr inline std::uint32_t VersionField = 15u;
+
+/**
+ * Layout of `declvol.v1.SwitchProfileRequest`.
+ */
+struct SwitchProfileLayout {
+  static constexpr std::uint32_t Profile = 1u;
+  static constexpr std::uint32_t ConfigPath = 2u;
+  static constexpr std::uint32_t Operation = 3u;
+};
+
+/**
+ * How a `SwitchProfileRequest` changes the stack of layers active in the
+ * waiter, matching `declvol.v1.SwitchProfileRequest.Operation`.
+ */
+enum class Operation : std::uint32_t {
+  Replace = 0,
+  Push = 1,
+  Pop = 2,
+};
+
+/**
+ * Request for a waiter to change its active profile.
+ *
+ * When decoded, the fields refer into the buffer that the message was decoded
+ * from.
+ */
+struct SwitchProfileRequest {
+  std::uint32_t version{Version};
+  std::string_view profile;
+  std::string_view configPath;
+  Operation operation{Operation::Replace};
+};
+
+/**
+ * Layout of `declvol.v1.CommandBatch`.
+ *
+ * Batches share the queue with `SwitchProfileRequest`s, so their fields are
+ * numbered after those of a request, and a message with any commands is a
+ * batch.
+ */
+struct CommandBatchLayout {
+  static constexpr std::uint32_t Commands = 4u;
+};
+
+/**
+ * Layout of `declvol.v1.Command`, each field being one of its `oneof`.
+ */
+struct CommandLayout {
+  static constexpr std::uint32_t SwitchProfile = 1u;
+  static constexpr std::uint32_t SetOverride = 2u;
+  static constexpr std::uint32_t ClearOverrides = 3u;
+};
+
+/**
+ * Layout of `declvol.v1.SetOverride`.
+ */
+struct SetOverrideLayout {
+  static constexpr std::uint32_t Suffix = 1u;
+  static constexpr std::uint32_t Volume = 2u;
+};
+
+/**
+ * Command for a waiter to set the volume of whatever matches a suffix, over
+ * every layer of its active profile, until overrides are cleared.
+ */
+struct SetOverride {
+  std::string_view suffix;
+  float volume{};
+};
+
+/**
+ * Command for a waiter to remove every override that has been set.
+ */
+struct ClearOverrides {};
+
+/**
+ * One command of a `CommandBatch`.
+ */
+using Command = std::variant<SwitchProfileRequest, SetOverride, ClearOverrides>;
+
+/**
+ * Commands for a waiter to run in order, after which it applies their combined
+ * change to existing sessions at once.
+ *
+ * When decoded, the strings of the commands refer into the buffer that the
+ * message was decoded from.
+ */
+struct CommandBatch {
+  std::uint32_t version{Version};
+  std::vector<Command> commands;
+};
+
+/**
+ * Return the number of bytes needed to encode `request`.
+ */
+std::size_t encoded_size(const SwitchProfileRequest &request);
+
+/**
+ * Return the number of bytes needed to encode `batch`.
+ */
+std::size_t encoded_size(const CommandBatch &batch);
+
+/**
+ * Encode `request` into the start of `buf`, returning the number of bytes
+ * written.
+ *
+ * \throws WireError if `buf` is too small to hold the message.
+ */
+std::size_t encode(const SwitchProfileRequest &request, std::span<std::byte> buf);
+
+/**
+ * Encode `batch` into the start of `buf`, returning the number of bytes
+ * written.
+ *
+ * \throws WireError if `buf` is too small to hold the message.
+ */
+std::size_t encode(const CommandBatch &batch, std::span<std::byte> buf);
+
+/**
+ * Decode a `SwitchProfileRequest` from `buf`, or return an empty optional if
+ * `buf` does not hold a valid message.
+ */
+std::optional<SwitchProfileRequest> decode_switch_profile(std::span<const std::byte> buf);
+
+/**
+ * Decode any message that a setter sends to a waiter from `buf`, or return an
+ * empty optional if `buf` does not hold a valid message.
+ *
+ * A `SwitchProfileRequest` is returned as a batch of that one command, so that
+ * waiters only have to handle batches.
+ */
+std::optional<CommandBatch> decode_request(std::span<const std::byte> buf);
+
+}// namespace em::wire
+
+#endif// VOLUME_SETTER_INCLUDE_DECLVOL_WIRE_H
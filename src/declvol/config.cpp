@@ -27,4 +27,8 @@ std::filesystem::path get_default_config_path() {
   return em::local_app_data() / "volume-setter" / "config.toml";
 }
 
+std::filesystem::path get_default_snapshot_path() {
+  return em::local_app_data() / "volume-setter" / "snapshot.bin";
+}
+
 }// namespace em
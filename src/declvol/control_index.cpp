@@ -0,0 +1,27 @@
+#include "declvol/control_index.h"
+
+#include <algorithm>
+
+namespace em {
+
+ControlIndex::ControlIndex(const VolumeProfile &profile) : mProfile{&profile} {
+  const auto &controls{profile.controls};
+  for (std::size_t i{0}; i < controls.size(); ++i) {
+    const auto &control{controls[i]};
+    const std::string_view text{control.suffix()};
+    // Later controls take priority, so they replace earlier ones with the
+    // same text.
+    if (control.kind() == MatchKind::Ancestor) {
+      mAncestors.insert_or_assign(text, i);
+      if (std::ranges::find(mAncestorLengths, text.size()) == mAncestorLengths.end()) {
+        mAncestorLengths.push_back(text.size());
+      }
+      mLastAncestor = i;
+    } else if (control.kind() != MatchKind::Suffix) {
+      mControls[slot(control.kind())].insert_or_assign(text, i);
+    }
+  }
+  std::ranges::sort(mAncestorLengths);
+}
+
+}// namespace em
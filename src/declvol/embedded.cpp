@@ -0,0 +1,19 @@
+#include "declvol/embedded.h"
+
+#include <chrono>
+
+namespace em {
+
+VolumeProfile to_volume_profile(const EmbeddedProfile &profile,
+                                std::pmr::memory_resource *resource) {
+  VolumeProfile result{resource};
+  result.controls.reserve(profile.controls.size());
+  for (const auto &control : profile.controls) {
+    result.controls.emplace_back(
+        control.kind, control.suffix, control.volume,
+        Fade{std::chrono::milliseconds{control.fadeMs}, control.curve});
+  }
+  return result;
+}
+
+}// namespace em
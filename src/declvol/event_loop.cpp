@@ -0,0 +1,67 @@
+#include "declvol/event_loop.h"
+
+#include <utility>
+
+namespace em {
+
+void EventLoop::post(Handler handler) {
+  {
+    std::lock_guard lock{mMut};
+    mPosted.push_back(std::move(handler));
+  }
+  wake();
+}
+
+void EventLoop::post_after(clock::duration delay, Handler handler) {
+  {
+    std::lock_guard lock{mMut};
+    mTimers.emplace(clock::now() + delay, std::move(handler));
+  }
+  // The loop may be sleeping until a later timer, or with no timeout at all.
+  wake();
+}
+
+void EventLoop::run() {
+  while (!mStopped.load(std::memory_order_acquire)) {
+    const auto timeout{run_ready()};
+    if (mStopped.load(std::memory_order_acquire)) break;
+    // Anything posted since `run_ready` has also called `wake`, so the wait
+    // returns straight away rather than sleeping on it.
+    wait(timeout);
+  }
+}
+
+void EventLoop::stop() {
+  mStopped.store(true, std::memory_order_release);
+  wake();
+}
+
+std::optional<EventLoop::clock::duration> EventLoop::run_ready() {
+  std::vector<Handler> ready;
+  {
+    std::lock_guard lock{mMut};
+    ready.swap(mPosted);
+  }
+  for (auto &handler : ready) {
+    if (mStopped.load(std::memory_order_acquire)) return std::nullopt;
+    handler();
+  }
+
+  // Timers are taken one at a time, so that a handler can post another timer
+  // that is already due.
+  for (;;) {
+    Handler handler;
+    {
+      std::lock_guard lock{mMut};
+      if (mTimers.empty()) return std::nullopt;
+      const auto it{mTimers.begin()};
+      if (const auto now{clock::now()}; it->first > now) return it->first - now;
+      handler = std::move(it->second);
+      mTimers.erase(it);
+    }
+    if (mStopped.load(std::memory_order_acquire)) return std::nullopt;
+    handler();
+  }
+}
+
+}// namespace em
@@ -0,0 +1,118 @@
+#include "declvol/event_loop.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+namespace em {
+namespace {
+
+/**
+ * Event loop waiting on every source with one `epoll_wait`, and woken by an
+ * eventfd.
+ */
+class EpollEventLoop final : public EventLoop {
+public:
+  static constexpr int MaxEvents{16};
+
+  EpollEventLoop()
+      : mEpoll{::epoll_create1(EPOLL_CLOEXEC)},
+        mWake{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)} {
+    if (mEpoll < 0 || mWake < 0) {
+      const int err{errno};
+      close_fds();
+      throw std::system_error(err, std::generic_category(), "epoll_create1");
+    }
+
+    try {
+      control(EPOLL_CTL_ADD, mWake);
+    } catch (...) {
+      close_fds();
+      throw;
+    }
+  }
+
+  ~EpollEventLoop() override { close_fds(); }
+
+  void add_source(NativeHandle handle, Handler handler) override {
+    control(EPOLL_CTL_ADD, handle);
+    mHandlers.insert_or_assign(handle, std::move(handler));
+  }
+
+  void remove_source(NativeHandle handle) override {
+    if (mHandlers.erase(handle) == 0) return;
+    // The descriptor may already have been closed, which removes it anyway.
+    ::epoll_ctl(mEpoll, EPOLL_CTL_DEL, handle, nullptr);
+  }
+
+protected:
+  void wait(std::optional<clock::duration> timeout) override {
+    int timeoutMs{-1};
+    if (timeout) {
+      // Round up, so that a timer is never woken for just before it is due.
+      timeoutMs = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(*timeout).count());
+    }
+
+    std::array<::epoll_event, MaxEvents> events;
+    const int count{::epoll_wait(mEpoll, events.data(), MaxEvents, timeoutMs)};
+    if (count < 0) {
+      if (errno == EINTR) return;
+      throw std::system_error(errno, std::generic_category(), "epoll_wait");
+    }
+
+    for (int i{0}; i < count; ++i) {
+      const int fd{events[i].data.fd};
+      if (fd == mWake) {
+        std::uint64_t value{};
+        [[maybe_unused]] const auto ignored{::read(mWake, &value, sizeof(value))};
+        continue;
+      }
+
+      // An earlier handler may have removed this source, and the handler is
+      // copied because it may remove its own.
+      const auto it{mHandlers.find(fd)};
+      if (it == mHandlers.end()) continue;
+      const auto handler{it->second};
+      handler();
+    }
+  }
+
+  void wake() override {
+    const std::uint64_t one{1};
+    [[maybe_unused]] const auto ignored{::write(mWake, &one, sizeof(one))};
+  }
+
+private:
+  void control(int op, int fd) {
+    ::epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (::epoll_ctl(mEpoll, op, fd, &event) < 0) {
+      throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+    }
+  }
+
+  void close_fds() {
+    if (mWake >= 0) ::close(mWake);
+    if (mEpoll >= 0) ::close(mEpoll);
+  }
+
+  int mEpoll;
+  int mWake;
+  std::unordered_map<int, Handler> mHandlers;
+};
+
+}// namespace
+
+std::unique_ptr<EventLoop> make_event_loop() {
+  return std::make_unique<EpollEventLoop>();
+}
+
+}// namespace em
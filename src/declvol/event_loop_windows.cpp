@@ -0,0 +1,98 @@
+#include "declvol/event_loop.h"
+#include "declvol/windows.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace em {
+namespace {
+
+/**
+ * Event loop waiting on every source with one `WaitForMultipleObjects`.
+ *
+ * The first handle waited on is an auto-reset event that `wake` signals, so
+ * at most `MAXIMUM_WAIT_OBJECTS - 1` sources can be added. The wait only
+ * reports the first of several ready handles, and the wake event comes before
+ * every source, so once it returns every source is polled and each that is
+ * ready is handled. A busy source, or a steady stream of posted tasks, then
+ * cannot starve the sources after it.
+ */
+class WaitEventLoop final : public EventLoop {
+public:
+  WaitEventLoop()
+      : mWake{::CreateEventW(nullptr, /*bManualReset=*/false, /*bInitialState=*/false, nullptr)} {
+    if (!mWake) winrt::throw_last_error();
+    mHandles.push_back(mWake.get());
+  }
+
+  void add_source(NativeHandle handle, Handler handler) override {
+    if (mHandles.size() == MAXIMUM_WAIT_OBJECTS) {
+      throw std::length_error("Too many event loop sources");
+    }
+    mHandles.push_back(handle);
+    mHandlers.push_back(std::move(handler));
+  }
+
+  void remove_source(NativeHandle handle) override {
+    const auto it{std::ranges::find(mHandles.begin() + 1, mHandles.end(), handle)};
+    if (it == mHandles.end()) return;
+    mHandlers.erase(mHandlers.begin() + (it - mHandles.begin() - 1));
+    mHandles.erase(it);
+  }
+
+protected:
+  void wait(std::optional<clock::duration> timeout) override {
+    DWORD timeoutMs{INFINITE};
+    if (timeout) {
+      // Round up, so that a timer is never woken for just before it is due.
+      timeoutMs = static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(*timeout).count());
+    }
+
+    const auto result{::WaitForMultipleObjects(static_cast<DWORD>(mHandles.size()), mHandles.data(),
+                                               /*bWaitAll=*/false, timeoutMs)};
+    if (result == WAIT_FAILED) winrt::throw_last_error();
+    if (result < WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + mHandles.size()) return;
+
+    // Copied, because handlers may add and remove sources. The source that
+    // ended the wait has already been consumed by it, so is not polled.
+    const auto signalled{static_cast<std::size_t>(result - WAIT_OBJECT_0)};
+    mPolled.assign(mHandles.begin() + 1, mHandles.end());
+    for (std::size_t i{0}; i < mPolled.size(); ++i) {
+      if (i + 1 != signalled && ::WaitForSingleObject(mPolled[i], 0) != WAIT_OBJECT_0) continue;
+      dispatch(mPolled[i]);
+    }
+  }
+
+  void wake() override {
+    winrt::check_bool(::SetEvent(mWake.get()));
+  }
+
+private:
+  /**
+   * Call the handler of a ready source, unless an earlier handler removed it.
+   */
+  void dispatch(HANDLE handle) {
+    const auto it{std::ranges::find(mHandles.begin() + 1, mHandles.end(), handle)};
+    if (it == mHandles.end()) return;
+    // Copied, because the handler may remove its own source.
+    const auto handler{mHandlers[static_cast<std::size_t>(it - mHandles.begin() - 1)]};
+    handler();
+  }
+
+  winrt::handle mWake;
+  std::vector<HANDLE> mHandles;
+  // The handler of `mHandles[i + 1]` is `mHandlers[i]`.
+  std::vector<Handler> mHandlers;
+  // The sources being polled after a wait, kept to avoid allocating each time.
+  std::vector<HANDLE> mPolled;
+};
+
+}// namespace
+
+std::unique_ptr<EventLoop> make_event_loop() {
+  return std::make_unique<WaitEventLoop>();
+}
+
+}// namespace em
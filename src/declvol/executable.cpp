@@ -1,20 +1,68 @@
+#include "declvol/arena.h"
 #include "declvol/config.h"
+#include "declvol/control_index.h"
+#include "declvol/embedded.h"
+#include "declvol/event_loop.h"
+#include "declvol/log.h"
+#include "declvol/match_memo.h"
 #include "declvol/process.h"
+#include "declvol/process_index.h"
 #include "declvol/profile.h"
-#include "declvol/v1/declvol.pb.h"
+#include "declvol/queue.h"
+#include "declvol/rpc.h"
+#include "declvol/session_match.h"
+#include "declvol/snapshot.h"
+#include "declvol/stats.h"
+#include "declvol/trace.h"
 #include "declvol/volume.h"
+#include "declvol/watcher.h"
 #include "declvol/windows.h"
+#include "declvol/wire.h"
+
+#ifdef EM_USE_PROTOBUF
+#include "declvol/v1/declvol.pb.h"
+#endif
+
+#ifdef EM_EMBEDDED_PROFILES
+#include "declvol/embedded_profiles.h"
+#endif
 
 #include <argparse/argparse.hpp>
 #include <boost/interprocess/ipc/message_queue.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/windows_shared_memory.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <format>
+#include <functional>
 #include <future>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <numeric>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace ipc = boost::interprocess;
 
@@ -25,265 +73,2788 @@ constexpr inline std::string_view ExecutableName = EM_EXECUTABLE_NAME;
 constexpr inline std::string_view ExecutableVersion = EM_EXECUTABLE_VERSION;
 
 /**
- * Name of the interprocess queue used to notify the waiter process, if any,
- * that the active profile has changed.
+ * Name of the shared memory holding the stats of the running waiter.
+ *
+ * Like `RpcQueueName` this must be unique among all programs. Readers check
+ * `StatsPage::Version`, so the name does not need to change with the layout.
+ */
+constexpr inline std::string_view StatsPageName = "em_volume_setter_stats_v1";
+
+#ifndef EM_EMBEDDED_PROFILES
+/**
+ * Return the path to the config file in which the profiles are defined.
+ *
+ * If `--config` is passed as a command line argument then its value is used as
+ * the path to the config file. Otherwise, `./volume-setter/config.toml` will be
+ * used relative to the directory returned by `local_app_data()`.
+ */
+std::filesystem::path get_config_path(const argparse::ArgumentParser &app) {
+  if (auto configPath{app.present<std::string>("--config")}) {
+    return *configPath;
+  }
+
+  return em::get_default_config_path();
+}
+#endif
+
+/**
+ * Return the profile with the given name from a config file.
+ *
+ * If profiles have been compiled into the executable then those are used
+ * instead, and the config file is ignored.
+ *
+ * \throws ProfileError if the profile does not exist.
+ */
+std::shared_ptr<const VolumeProfile> read_profile(const std::filesystem::path &configPath,
+                                                  const std::string &profileName) {
+#ifdef EM_EMBEDDED_PROFILES
+  const auto *profile{em::find_embedded_profile(em::embedded::Profiles, profileName)};
+  if (!profile) {
+    throw em::ProfileError(std::format("[error] Profile {} does not exist", profileName));
+  }
+  return std::make_shared<const em::VolumeProfile>(
+      em::to_volume_profile(*profile, std::pmr::get_default_resource()));
+#else
+  std::pmr::monotonic_buffer_resource arena;
+  const auto profiles{em::parse_profiles_toml(configPath, &arena)};
+  const auto activeProfileIt{profiles.find(std::string_view{profileName})};
+  if (activeProfileIt == profiles.end()) {
+    throw em::ProfileError(configPath,
+                           std::format("Profile {} does not exist", profileName));
+  }
+
+  // Copy out of the arena before it is destroyed.
+  return std::make_shared<const em::VolumeProfile>(activeProfileIt->second);
+#endif
+}
+
+/**
+ * Record of the audio sessions seen by a waiter, along with the name that each
+ * is matched by.
+ *
+ * Keeping the names means that a change to the active profile can be applied to
+ * just the sessions that it affects, without enumerating every session and
+ * resolving its name again. Expired sessions are forgotten the next time the
+ * registry is visited.
+ *
+ * Entries are allocated from a pool so that, once warmed up, recording a new
+ * session does not touch the heap.
+ */
+class SessionRegistry {
+public:
+  /**
+   * Record a session and the name that it is matched by.
+   *
+   * This function is thread-safe.
+   */
+  void add(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl, std::string_view name) {
+    std::lock_guard lock{mMut};
+    mEntries.push_back(Entry{sessionCtrl, std::pmr::string{name, &mPool}});
+  }
+
+  /**
+   * Invoke `f` with each live session and its name, forgetting any sessions
+   * that have expired.
+   *
+   * This function is thread-safe, but `f` is called with the registry locked
+   * so must not call back into it.
+   */
+  template<class F>
+  void for_each(F &&f) {
+    std::lock_guard lock{mMut};
+    std::erase_if(mEntries, [](const Entry &entry) {
+      try {
+        return em::is_session_expired(entry.sessionCtrl);
+      } catch (const winrt::hresult_error &) {
+        return true;
+      }
+    });
+    for (const auto &entry : mEntries) {
+      std::invoke(f, entry.sessionCtrl, std::string_view{entry.name});
+    }
+  }
+
+private:
+  struct Entry {
+    winrt::com_ptr<IAudioSessionControl> sessionCtrl;
+    std::pmr::string name;
+  };
+
+  std::mutex mMut;
+  std::pmr::unsynchronized_pool_resource mPool;
+  std::pmr::vector<Entry> mEntries{&mPool};
+};
+
+class DeclvolService;
+
+/**
+ * Puts back the volume of audio sessions that something else changes, such as
+ * games and browsers that reset their own volume after they start.
+ *
+ * Each watched session reports changes to its volume as events, so nothing is
+ * polled. Changes made by this program carry `VolumeSetterEventContext` and are
+ * ignored, and any other change is posted to the event loop to be put back to
+ * the volume of the control that matches the session in the active profile.
+ * Each session is put back at most `MaxReverts` times per `RevertWindow`, so
+ * that an application that insists on its own volume cannot drive the two into
+ * a loop. Changes beyond that are left alone until the window ends.
+ */
+class VolumeEnforcer {
+public:
+  static constexpr std::uint32_t MaxReverts{3};
+  static constexpr std::chrono::seconds RevertWindow{10};
+
+  explicit VolumeEnforcer(DeclvolService &service, EventLoop &loop, RampScheduler &ramps,
+                          const ProcessIndex *processes, Logger &log)
+      : mService{service},
+        mLoop{loop},
+        mRamps{ramps},
+        mProcesses{processes},
+        mLog{log} {}
+
+  VolumeEnforcer(const VolumeEnforcer &) = delete;
+  VolumeEnforcer &operator=(const VolumeEnforcer &) = delete;
+
+  ~VolumeEnforcer() {
+    std::vector<std::unique_ptr<Watched>> watched;
+    {
+      std::lock_guard lock{mMut};
+      for (auto &[key, entry] : mWatched) watched.push_back(std::move(entry));
+      mWatched.clear();
+    }
+    unregister(watched);
+  }
+
+  /**
+   * Start enforcing the volume of a session, where `name` is the image path of
+   * the session's process or `:system` for the system sounds session. Sessions
+   * that are already watched are left as they are.
+   *
+   * This function is thread-safe.
+   */
+  void watch(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl, std::string_view name) {
+    std::vector<std::unique_ptr<Watched>> expired;
+    try {
+      auto key{em::get_session_instance_id(sessionCtrl.as<IAudioSessionControl2>())};
+
+      std::lock_guard lock{mMut};
+      // New sessions are the only thing that grows the map, so this is when
+      // the expired ones are forgotten.
+      std::erase_if(mWatched, [&expired](auto &entry) {
+        bool gone;
+        try {
+          gone = em::is_session_expired(entry.second->sessionCtrl);
+        } catch (const winrt::hresult_error &) {
+          gone = true;
+        }
+        if (gone) expired.push_back(std::move(entry.second));
+        return gone;
+      });
+      if (!mWatched.contains(key)) {
+        auto watched{std::make_unique<Watched>(sessionCtrl, std::string{name})};
+        // Events are handled on the loop, by which time the session may have
+        // been forgotten, so they find it again by its key.
+        watched->events = em::register_session_events(
+            sessionCtrl, {.volumeChanged = [this, key](float volume, const GUID *eventContext) {
+              if (eventContext && *eventContext == em::VolumeSetterEventContext) return;
+              mLoop.post([this, key, volume] { volume_changed(key, volume); });
+            }});
+        mWatched.emplace(std::move(key), std::move(watched));
+      }
+    } catch (const winrt::hresult_error &e) {
+      mLog.warn("Could not watch volume of {}: {}", name, winrt::to_string(e.message()));
+    }
+    // Unregistering waits for any event being handled, so is kept out of the
+    // lock.
+    unregister(expired);
+  }
+
+private:
+  struct Watched {
+    Watched(winrt::com_ptr<IAudioSessionControl> sessionCtrl, std::string name)
+        : sessionCtrl{std::move(sessionCtrl)},
+          name{std::move(name)} {}
+
+    winrt::com_ptr<IAudioSessionControl> sessionCtrl;
+    std::string name;
+    winrt::com_ptr<IAudioSessionEvents> events;
+    std::chrono::steady_clock::time_point windowStart;
+    std::uint32_t reverts{};
+  };
+
+  /**
+   * Handle a change to the volume of the watched session with the given key,
+   * made by something else.
+   */
+  void volume_changed(const std::string &key, float volume);
+
+  static void unregister(const std::vector<std::unique_ptr<Watched>> &watched) {
+    for (const auto &entry : watched) {
+      try {
+        em::unregister_session_events(entry->sessionCtrl, entry->events);
+      } catch (const winrt::hresult_error &) {
+        // The session has gone, and its events with it.
+      }
+    }
+  }
+
+  DeclvolService &mService;
+  EventLoop &mLoop;
+  RampScheduler &mRamps;
+  const ProcessIndex *mProcesses;
+  Logger &mLog;
+  // New sessions are usually watched from the loop, but not always, so the
+  // map is still locked.
+  std::mutex mMut;
+  std::unordered_map<std::string, std::unique_ptr<Watched>> mWatched;
+};
+
+/**
+ * Records the sessions that a waiter sees in a trace, along with when each of
+ * them ends, so that what the waiter reacted to can be replayed.
+ *
+ * Sessions are recorded the first time they are seen, and are then watched
+ * for expiring or being disconnected in the same way as `VolumeEnforcer`
+ * watches them for volume changes.
+ */
+class SessionTracer {
+public:
+  explicit SessionTracer(TraceWriter &trace, Logger &log)
+      : mTrace{trace},
+        mLog{log} {}
+
+  SessionTracer(const SessionTracer &) = delete;
+  SessionTracer &operator=(const SessionTracer &) = delete;
+
+  ~SessionTracer() {
+    std::vector<Watched> watched;
+    {
+      std::lock_guard lock{mMut};
+      for (auto &[key, entry] : mWatched) watched.push_back(std::move(entry));
+      mWatched.clear();
+    }
+    unregister(watched);
+  }
+
+  /**
+   * Record a session, where `name` is the image path of the session's process
+   * or `:system` for the system sounds session. Sessions that have already
+   * been recorded are not recorded again.
+   *
+   * This function is thread-safe.
+   */
+  void record(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl, std::string_view name) {
+    std::vector<Watched> ended;
+    try {
+      const auto sessionCtrl2{sessionCtrl.as<IAudioSessionControl2>()};
+      auto key{em::get_session_instance_id(sessionCtrl2)};
+      const auto pid{name == ":system" ? DWORD{0} : em::get_process_id(sessionCtrl2)};
+
+      std::lock_guard lock{mMut};
+      // Sessions that have ended are only forgotten here, for the same reason
+      // as in `VolumeEnforcer::watch`.
+      std::erase_if(mWatched, [&ended](auto &entry) {
+        if (!entry.second.ended->test()) return false;
+        ended.push_back(std::move(entry.second));
+        return true;
+      });
+      if (!mWatched.contains(key)) {
+        const auto session{mTrace.session_created(pid, name)};
+        Watched watched{sessionCtrl, {}, std::make_shared<std::atomic_flag>()};
+        // A session can both expire and be disconnected, but only ends once.
+        watched.events = em::register_session_events(
+            sessionCtrl, {.ended = [this, session, flag = watched.ended] {
+              if (!flag->test_and_set()) mTrace.session_ended(session);
+            }});
+        mWatched.emplace(std::move(key), std::move(watched));
+      }
+    } catch (const winrt::hresult_error &e) {
+      mLog.warn("Could not trace session of {}: {}", name, winrt::to_string(e.message()));
+    }
+    unregister(ended);
+  }
+
+private:
+  struct Watched {
+    winrt::com_ptr<IAudioSessionControl> sessionCtrl;
+    winrt::com_ptr<IAudioSessionEvents> events;
+    // Set once the end of the session has been recorded. Shared with the
+    // event handler, which can outlive the entry until it is unregistered.
+    std::shared_ptr<std::atomic_flag> ended;
+  };
+
+  static void unregister(const std::vector<Watched> &watched) {
+    for (const auto &entry : watched) {
+      try {
+        em::unregister_session_events(entry.sessionCtrl, entry.events);
+      } catch (const winrt::hresult_error &) {
+        // The session has gone, and its events with it.
+      }
+    }
+  }
+
+  TraceWriter &mTrace;
+  Logger &mLog;
+  std::mutex mMut;
+  std::unordered_map<std::string, Watched> mWatched;
+};
+
+/**
+ * State shared by everything that sets the volume of sessions.
+ */
+struct ApplyContext {
+  // Runs any fades.
+  RampScheduler &ramps;
+  // Reports what was done.
+  Logger &log;
+  // If given, sessions are recorded here along with their name.
+  SessionRegistry *registry{};
+  // If given, what happens to each session is counted here.
+  StatsPage *stats{};
+  // If given, process names are looked up here instead of querying the
+  // process.
+  ProcessIndex *processes{};
+  // If given, sessions are watched for something else changing their volume.
+  VolumeEnforcer *enforcer{};
+  // If given, sessions are recorded in a trace.
+  SessionTracer *tracer{};
+};
+
+/**
+ * Return a function fetching the fields of an audio session for
+ * `ControlIndex::match`, which treats fields that cannot be read as missing.
+ *
+ * The fields are allocated from `resource`.
+ */
+auto field_fetcher(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+                   std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+  return [&sessionCtrl, resource](MatchKind kind) -> std::optional<std::pmr::string> {
+    try {
+      return em::get_session_field(sessionCtrl, kind, resource);
+    } catch (const winrt::hresult_error &) {
+      return std::nullopt;
+    }
+  };
+}
+
+/**
+ * Return the control that wins for an audio session out of `winner` and the
+ * ancestor controls of `index`, only finding the session's process if some
+ * ancestor control could win.
+ */
+const VolumeControl *match_session_ancestors(const ControlIndex &index, const VolumeControl *winner,
+                                             const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+                                             const ProcessIndex *processes) {
+  if (!processes || !index.uses(MatchKind::Ancestor)) return winner;
+  try {
+    const auto sessionCtrl2{sessionCtrl.as<IAudioSessionControl2>()};
+    if (sessionCtrl2->IsSystemSoundsSession() == S_OK) return winner;
+    return em::match_ancestors(index, winner, em::get_process_id(sessionCtrl2), processes);
+  } catch (const winrt::hresult_error &) {
+    return winner;
+  }
+}
+
+/**
+ * Set the volume of an audio session to that of the control matching it, if
+ * any, where `name` is the image path of the session's process or `:system`
+ * for the system sounds session.
+ */
+void set_session_control(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+                         std::string_view name,
+                         const VolumeControl *control,
+                         const ApplyContext &ctx) {
+  if (ctx.registry) ctx.registry->add(sessionCtrl, name);
+  if (ctx.enforcer) ctx.enforcer->watch(sessionCtrl, name);
+  if (ctx.tracer) ctx.tracer->record(sessionCtrl, name);
+  if (!control) return;
+
+  em::set_session_master_volume(*control, sessionCtrl, &ctx.ramps);
+  if (ctx.stats) ctx.stats->controlMatches.record(control->kind(), control->suffix());
+  if (name == ":system") {
+    ctx.log.info("Set volume of system sounds to {}", control->relative_volume());
+  } else {
+    ctx.log.info("Set volume of {} to {}", name, control->relative_volume());
+  }
+}
+
+/**
+ * Set the volume of an audio session according to the profile of `memo`.
+ *
+ * This finds the name of the session's process itself and will also work with
+ * the system audio session. The control is looked up in the memo so that
+ * sessions of an executable that has been seen before skip matching. Any
+ * temporary memory needed to handle the session is allocated from `scratch`.
+ */
+void set_session_volume(MatchMemo &memo,
+                        const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+                        std::pmr::memory_resource *scratch,
+                        const ApplyContext &ctx) {
+  const auto sessionCtrl2{sessionCtrl.as<IAudioSessionControl2>()};
+  if (ctx.stats) ctx.stats->sessionsHandled.fetch_add(1, std::memory_order_relaxed);
+
+  // To get reliable name information about the session we need the PID of
+  // the process managing it. There is `IAudioSessionControl::GetDisplayName`,
+  // but it's up to the application to set that and many do not. `sndvol` has
+  // to create a fallback in that case, we opt to instead match the executable
+  // path.
+
+  // For the system process we can't get executable path from the PID, but
+  // we can still get the PID, which is zero. We actually can use
+  // `GetDisplayName` in this case, because the system process sets it,
+  // but rather than trying to match on that or relying on the PID we can
+  // instead use `IAudioSessionControl2::IsSystemSoundsSession`, which sounds
+  // much more reliable.
+  if (sessionCtrl2->IsSystemSoundsSession() == S_OK) {
+    em::set_session_control(sessionCtrl, ":system", em::find_control(memo.profile(), ":system"), ctx);
+    return;
+  }
+
+  const auto pid{em::get_process_id(sessionCtrl2)};
+  // PID should be nonzero since we've already handled the system sounds.
+  std::pmr::string procName{scratch};
+  if (ctx.processes) {
+    auto path{ctx.processes->image_path(pid, scratch)};
+    if (!path) {
+      if (ctx.stats) ctx.stats->openProcessFailures.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    procName = std::move(*path);
+  } else {
+    winrt::handle procHnd;
+    try {
+      procHnd = em::open_process(pid);
+    } catch (const winrt::hresult_error &) {
+      if (ctx.stats) ctx.stats->openProcessFailures.fetch_add(1, std::memory_order_relaxed);
+      throw;
+    }
+    procName = em::get_process_image_name(procHnd, scratch);
+  }
+
+  const auto *control{em::match_session(memo, procName, pid, em::field_fetcher(sessionCtrl, scratch),
+                                        ctx.processes, ctx.stats)};
+  em::set_session_control(sessionCtrl, procName, control, ctx);
+}
+
+/**
+ * A change that applying a profile makes to the device or to one session.
+ */
+struct PlannedChange {
+  // Session to change, or null for the device.
+  winrt::com_ptr<IAudioSessionControl> sessionCtrl;
+  DWORD pid{};
+  // Image path of the session's process, or `:system` or `:device`. Empty if
+  // the process could not be found.
+  std::string name;
+  // Control deciding the volume, or null if none matches.
+  const VolumeControl *control{};
+};
+
+/**
+ * Time spent in each stage of applying a profile.
+ *
+ * Resolving, planning, and applying overlap, so together they can take longer
+ * than the total.
+ */
+struct StageTimings {
+  std::chrono::nanoseconds collect{};
+  std::chrono::nanoseconds resolve{};
+  std::chrono::nanoseconds plan{};
+  std::chrono::nanoseconds apply{};
+  std::chrono::nanoseconds total{};
+};
+
+/**
+ * What a pass applying a profile did.
+ */
+struct PassReport {
+  StageTimings timings;
+  // Sessions found, apart from any that expired while being listed, the
+  // processes they belong to, and the groups those formed. Each process is
+  // resolved once and each group is matched against image paths once, so the
+  // differences are the work that grouping saved.
+  std::size_t numSessions{};
+  std::size_t numProcesses{};
+  std::size_t numGroups{};
+};
+
+/**
+ * Audio sessions that share a process, and so are resolved and matched
+ * together.
+ */
+struct SessionGroup {
+  std::uint32_t pid{};
+  // Grouping parameter of the first session of the process, which is null if
+  // the application gave it none.
+  GUID grouping{};
+  std::vector<winrt::com_ptr<IAudioSessionControl>> sessions;
+};
+
+/**
+ * Orders GUIDs by their bytes, for use as map keys.
+ */
+struct GuidLess {
+  bool operator()(const GUID &lhs, const GUID &rhs) const noexcept {
+    return std::memcmp(&lhs, &rhs, sizeof(GUID)) < 0;
+  }
+};
+
+/**
+ * Make a planned change.
+ */
+void apply_change(const PlannedChange &change,
+                  const winrt::com_ptr<IMMDevice> &device,
+                  const ApplyContext &ctx) {
+  if (!change.sessionCtrl) {
+    em::set_device_master_volume(*change.control, device, &ctx.ramps);
+    ctx.log.info("Set volume of device to {}", change.control->relative_volume());
+    return;
+  }
+
+  if (ctx.stats) ctx.stats->sessionsHandled.fetch_add(1, std::memory_order_relaxed);
+  if (change.name.empty()) {
+    if (ctx.stats) ctx.stats->openProcessFailures.fetch_add(1, std::memory_order_relaxed);
+    ctx.log.warn("Could not find the executable of process {}", change.pid);
+    return;
+  }
+  em::set_session_control(change.sessionCtrl, change.name, change.control, ctx);
+}
+
+/**
+ * Report that a planned change could not be made.
+ */
+void report_change_error(Logger &log, const PlannedChange &change, const winrt::hresult_error &e) {
+  if (change.sessionCtrl) {
+    log.warn("Could not set volume of session of process {}: {}", change.pid, winrt::to_string(e.message()));
+  } else {
+    log.warn("Could not set volume of device: {}", winrt::to_string(e.message()));
+  }
+}
+
+/**
+ * Makes planned changes on a thread of its own, so that the volume of one
+ * session is written while the process of the next is still being resolved.
+ *
+ * Changes are made in the order they are pushed. A change that fails, such as
+ * one to a session whose process has just exited, is reported and skipped
+ * rather than stopping the rest.
+ */
+class PlanApplier {
+public:
+  explicit PlanApplier(const winrt::com_ptr<IMMDevice> &device, const ApplyContext &ctx)
+      : mDevice{device},
+        mCtx{ctx},
+        mThread{[this] { run(); }} {}
+
+  PlanApplier(const PlanApplier &) = delete;
+  PlanApplier &operator=(const PlanApplier &) = delete;
+
+  ~PlanApplier() {
+    finish();
+  }
+
+  /**
+   * Queue a change to be made.
+   */
+  void push(PlannedChange change) {
+    {
+      std::lock_guard lock{mMut};
+      mPending.push_back(std::move(change));
+    }
+    mCv.notify_one();
+  }
+
+  /**
+   * Wait for every queued change to be made, and return the time spent making
+   * them. No more changes can be pushed afterwards.
+   */
+  std::chrono::nanoseconds finish() {
+    {
+      std::lock_guard lock{mMut};
+      mFinished = true;
+    }
+    mCv.notify_one();
+    if (mThread.joinable()) mThread.join();
+    return mApplyTime;
+  }
+
+private:
+  void run() {
+    winrt::init_apartment();
+
+    std::vector<PlannedChange> batch;
+    for (;;) {
+      {
+        std::unique_lock lock{mMut};
+        mCv.wait(lock, [this] { return mFinished || !mPending.empty(); });
+        if (mPending.empty()) return;
+        batch.swap(mPending);
+      }
+
+      for (const auto &change : batch) {
+        const auto start{std::chrono::steady_clock::now()};
+        try {
+          em::apply_change(change, mDevice, mCtx);
+        } catch (const winrt::hresult_error &e) {
+          em::report_change_error(mCtx.log, change, e);
+        }
+        mApplyTime += std::chrono::steady_clock::now() - start;
+      }
+      batch.clear();
+    }
+  }
+
+  winrt::com_ptr<IMMDevice> mDevice;
+  ApplyContext mCtx;
+  std::mutex mMut;
+  std::condition_variable mCv;
+  std::vector<PlannedChange> mPending;
+  bool mFinished{false};
+  // Only touched by the thread until it is joined.
+  std::chrono::nanoseconds mApplyTime{};
+  // Declared last so that the thread starts after everything it uses.
+  std::thread mThread;
+};
+
+/**
+ * Apply a profile to the device and to every current audio session.
+ *
+ * This happens in stages: collect the sessions, resolve the image path of the
+ * process owning each, plan which control decides its volume, and apply. Each
+ * path is planned and handed to a `PlanApplier` as soon as it is resolved, so
+ * that writing the volume of one session overlaps with resolving the next.
+ * Without a process index the processes are resolved together from one
+ * snapshot of the system, rather than by opening each one in turn.
+ *
+ * Browsers and chat applications open many sessions, so sessions are first
+ * grouped by process, and only one per process is resolved and matched. The
+ * result is then planned for every member. Processes that the application put
+ * in the same group by grouping parameter, and that run the same executable,
+ * also share the match against their image path. Ancestors and the other
+ * fields of a session are still matched for each process and session.
+ *
+ * If `plan` is given then every planned change is appended to it, and if
+ * `dryRun` is true then nothing is applied at all.
+ */
+PassReport apply_profile(const VolumeProfile &profile,
+                           const winrt::com_ptr<IMMDevice> &device,
+                           const winrt::com_ptr<IAudioSessionManager2> &sessionMgr,
+                           const ApplyContext &ctx,
+                           std::vector<PlannedChange> *plan = nullptr,
+                           bool dryRun = false) {
+  using Clock = std::chrono::steady_clock;
+  PassReport report;
+  auto &timings{report.timings};
+  const auto start{Clock::now()};
+  const ControlIndex index{profile};
+  // Ancestors are only looked up in a process index. Setters do not keep one,
+  // so if the profile needs one it is seeded from a single snapshot for the
+  // pass.
+  std::optional<ProcessIndex> ownProcesses;
+  const ProcessIndex *processes{ctx.processes};
+  if (!processes && index.uses(MatchKind::Ancestor)) {
+    processes = &ownProcesses.emplace(em::make_process_source(), false);
+  }
+
+  std::vector<SessionGroup> groups;
+  std::vector<std::uint32_t> pids;
+  std::unordered_map<std::uint32_t, std::size_t> groupOfPid;
+  for (const auto &sessionCtrl : em::get_audio_sessions(sessionMgr)) {
+    std::size_t group{groups.size()};
+    try {
+      const auto sessionCtrl2{sessionCtrl.as<IAudioSessionControl2>()};
+      // The system sounds session is the only one with a PID of zero, which
+      // marks it as needing no resolving.
+      const std::uint32_t pid{sessionCtrl2->IsSystemSoundsSession() == S_OK ? 0 : em::get_process_id(sessionCtrl2)};
+      if (const auto it{groupOfPid.find(pid)}; it != groupOfPid.end()) {
+        group = it->second;
+      } else {
+        const auto grouping{pid == 0 ? GUID{} : em::get_grouping_param(sessionCtrl)};
+        groupOfPid.emplace(pid, group);
+        groups.push_back(SessionGroup{pid, grouping, {}});
+        pids.push_back(pid);
+      }
+    } catch (const winrt::hresult_error &) {
+      // The session expired since it was listed, so there is nothing to set.
+      continue;
+    }
+    ++report.numSessions;
+    groups[group].sessions.push_back(sessionCtrl);
+  }
+  report.numProcesses = groups.size();
+  timings.collect = Clock::now() - start;
+
+  std::optional<PlanApplier> applier;
+  if (!dryRun) applier.emplace(device, ctx);
+  const auto submit{[&](PlannedChange change) {
+    if (plan) plan->push_back(change);
+    if (applier) applier->push(std::move(change));
+  }};
+
+  if (const auto *control{em::find_control(profile, ":device")}) {
+    submit(PlannedChange{{}, 0, ":device", control});
+  }
+
+  // The image path and match of the first process resolved in each group
+  // given by grouping parameter.
+  std::map<GUID, std::pair<std::string, const VolumeControl *>, GuidLess> matchOfGrouping;
+  auto stageEnd{Clock::now()};
+  const auto onResolved{[&](std::size_t i, std::optional<std::string_view> procName) {
+    const auto resolved{Clock::now()};
+    timings.resolve += resolved - stageEnd;
+
+    const auto &group{groups[i]};
+    std::string_view name;
+    const VolumeControl *control{};
+    bool reused{false};
+    if (group.pid == 0) {
+      name = ":system";
+      control = em::find_control(profile, ":system");
+    } else if (procName) {
+      name = *procName;
+      const auto shared{group.grouping == GUID{} ? matchOfGrouping.end() : matchOfGrouping.find(group.grouping)};
+      reused = shared != matchOfGrouping.end() && shared->second.first == *procName;
+      if (reused) {
+        control = shared->second.second;
+      } else {
+        control = em::match_control(profile, *procName);
+        if (group.grouping != GUID{} && shared == matchOfGrouping.end()) {
+          matchOfGrouping.emplace(group.grouping, std::pair{std::string{*procName}, control});
+        }
+      }
+      // Ancestors belong to the process, so are not shared by the group.
+      control = em::match_ancestors(index, control, group.pid, processes);
+    }
+    if (!reused) ++report.numGroups;
+    for (const auto &sessionCtrl : group.sessions) {
+      // Only the image path is shared by the sessions of a process, other
+      // fields belong to each session.
+      const auto *sessionControl{procName && group.pid != 0
+                                     ? index.match(control, em::field_fetcher(sessionCtrl))
+                                     : control};
+      submit(PlannedChange{sessionCtrl, group.pid, std::string{name}, sessionControl});
+    }
+
+    stageEnd = Clock::now();
+    timings.plan += stageEnd - resolved;
+  }};
+
+  if (ctx.processes) {
+    em::ScratchArena<em::SessionArenaSize> scratch;
+    for (std::size_t i{0}; i < pids.size(); ++i) {
+      std::optional<std::pmr::string> path;
+      if (pids[i] != 0) path = ctx.processes->image_path(pids[i], scratch.resource());
+      onResolved(i, path ? std::optional<std::string_view>{*path} : std::nullopt);
+      scratch.reset();
+    }
+  } else {
+    em::make_process_source()->resolve(pids, onResolved);
+  }
+
+  if (applier) timings.apply = applier->finish();
+  timings.total = Clock::now() - start;
+  if (ctx.stats) {
+    ctx.stats->sessionsGrouped.fetch_add(report.numSessions - report.numGroups, std::memory_order_relaxed);
+  }
+  return report;
+}
+
+/**
+ * Append `str` to `out` as a quoted JSON string.
+ */
+void append_json_string(std::string &out, std::string_view str) {
+  out.push_back('"');
+  for (const char c : str) {
+    switch (c) {
+    case '"': out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    case '\r': out += "\\r"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        std::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned int>(c));
+      } else {
+        out.push_back(c);
+      }
+    }
+  }
+  out.push_back('"');
+}
+
+/**
+ * Print the changes that applying a profile would make, and how long planning
+ * them took, as a JSON document.
+ */
+void print_plan(std::string_view profileName,
+                const std::vector<PlannedChange> &plan,
+                const PassReport &report) {
+  const auto us{[](std::chrono::nanoseconds d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+  }};
+
+  std::string out{"{\n  \"profile\": "};
+  em::append_json_string(out, profileName);
+  out += ",\n  \"changes\": [";
+  for (std::size_t i{0}; i < plan.size(); ++i) {
+    const auto &change{plan[i]};
+    out += i == 0 ? "\n    {" : ",\n    {";
+    if (change.sessionCtrl) {
+      std::format_to(std::back_inserter(out), "\"target\": \"session\", \"pid\": {}, \"name\": ", change.pid);
+      if (change.name.empty()) {
+        out += "null";
+      } else {
+        em::append_json_string(out, change.name);
+      }
+    } else {
+      out += "\"target\": \"device\"";
+    }
+
+    if (change.control) {
+      out += ", \"control\": ";
+      em::append_json_string(out, change.control->suffix());
+      std::format_to(std::back_inserter(out), ", \"match\": \"{}\", \"volume\": {}, \"fade_ms\": {}}}",
+                     em::match_kind_name(change.control->kind()), change.control->relative_volume(),
+                     change.control->fade().duration.count());
+    } else {
+      out += ", \"control\": null}";
+    }
+  }
+  out += plan.empty() ? "],\n" : "\n  ],\n";
+  std::format_to(std::back_inserter(out), "  \"sessions\": {}, \"processes\": {}, \"groups\": {},\n",
+                 report.numSessions, report.numProcesses, report.numGroups);
+  const auto &timings{report.timings};
+  std::format_to(std::back_inserter(out),
+                 "  \"timings_us\": {{\"collect\": {:.1f}, \"resolve\": {:.1f}, \"plan\": {:.1f}, "
+                 "\"apply\": {:.1f}, \"total\": {:.1f}}}\n}}\n",
+                 us(timings.collect), us(timings.resolve), us(timings.plan),
+                 us(timings.apply), us(timings.total));
+  std::cout << out;
+}
+
+/**
+ * Stats page of a waiter, shared with other processes through named shared
+ * memory.
+ *
+ * Windows removes the shared memory once the last process with it open exits,
+ * so there is nothing to clean up if the waiter is killed. If a reader still
+ * has the page of a previous waiter open then that page is reused and reset.
+ */
+class SharedStats {
+public:
+  SharedStats()
+      : mMemory{ipc::open_or_create, em::StatsPageName.data(), ipc::read_write, sizeof(StatsPage)},
+        mRegion{mMemory, ipc::read_write},
+        mPage{::new (mRegion.get_address()) StatsPage} {}
+
+  SharedStats(const SharedStats &) = delete;
+  SharedStats &operator=(const SharedStats &) = delete;
+
+  ~SharedStats() {
+    std::destroy_at(mPage);
+  }
+
+  [[nodiscard]] StatsPage &page() {
+    return *mPage;
+  }
+
+private:
+  ipc::windows_shared_memory mMemory;
+  ipc::mapped_region mRegion;
+  StatsPage *mPage;
+};
+
+/**
+ * Holder for an interprocess queue that, if it creates a queue, takes ownership
+ * of it and removes it on destruction.
+ */
+class QueueHolder {
+public:
+  template<class Mode, class... Args>
+  explicit QueueHolder(Mode m, const char *name, Args &&...args)
+      : queue{m, name, std::forward<Args>(args)...},
+        mQueueName{name},
+        mHasOwnership{std::is_same_v<Mode, ipc::create_only_t>} {};
+
+  ~QueueHolder() {
+    if (mHasOwnership) ipc::message_queue::remove(mQueueName.c_str());
+  }
+
+  ipc::message_queue queue;
+
+private:
+  std::string mQueueName;
+  bool mHasOwnership;
+};
+
+/**
+ * Implementation of the `declvol` service managing an active volume profile.
+ *
+ * The active profile is a stack of layers. The base layer is the profile that
+ * the waiter was started with, or the last one switched to, and each layer
+ * pushed on top overrides the controls of the layers beneath it. Each layer
+ * keeps the merge of itself with everything beneath it, so that looking up the
+ * active profile never has to merge anything, and pushing or popping a layer
+ * only merges one profile. Overrides set by `volume-setter set` sit above every
+ * layer, and are merged over the topmost one whenever either changes.
+ *
+ * Switching the whole profile does not change the volume of any sessions,
+ * because the setter that asked for the switch sets the existing sessions
+ * itself. Layers and overrides are only known to the waiter, so the change
+ * handler applies those changes. In both cases the volume of any sessions
+ * opened afterwards is set by the session handler.
+ */
+class DeclvolService {
+public:
+  /**
+   * A change of the active profile.
+   */
+  struct ProfileChange {
+    std::shared_ptr<const em::VolumeProfile> previous;
+    std::shared_ptr<const em::VolumeProfile> current;
+    // The controls of the layers or overrides that were changed, if only they
+    // were. A session that none of them match has the same winning control in
+    // both profiles, so does not need to be looked at.
+    std::shared_ptr<const em::VolumeProfile> changed;
+  };
+
+  /**
+   * Called on the event loop with the change made by each request, and whether
+   * it should be applied to existing sessions.
+   *
+   * Setters apply the profiles they switch to themselves, so the change made
+   * by a request that only switched profile is not applied by the waiter.
+   */
+  using ChangeHandler = std::function<void(const ProfileChange &, bool apply)>;
+
+  /**
+   * A command of a request, holding everything needed to run it later.
+   */
+  struct SwitchCommand {
+    em::wire::Operation operation{};
+    std::string configPath;
+    std::string profileName;
+  };
+  struct OverrideCommand {
+    std::string suffix;
+    float volume{};
+  };
+  struct ClearCommand {};
+  using Command = std::variant<SwitchCommand, OverrideCommand, ClearCommand>;
+
+  explicit DeclvolService(ipc::message_queue &channel, EventLoop &loop, Logger &log,
+                          const VolumeProfile &profile, std::filesystem::path configPath,
+                          std::string profileName)
+      : mChannel{channel},
+        mLoop{loop},
+        mLog{log},
+        mOverrides{std::make_shared<const em::VolumeProfile>()} {
+    mLayers.push_back(make_layer(std::move(configPath), std::move(profileName),
+                                 std::make_shared<const em::VolumeProfile>(profile), nullptr));
+    mActive = mLayers.back().merged;
+  }
+
+  /**
+   * Change the active profile used by the service to the one described by a
+   * `SwitchProfileRequest`.
+   */
+  ProfileChange switch_profile(std::string_view configPath, std::string_view profileName) {
+    auto change{load_profile(std::filesystem::path{configPath}, std::string{profileName})};
+    mLog.info("Switched profile to {}", profileName);
+    return change;
+  }
+
+  /**
+   * Set the function that is told of the change made by each request, such as
+   * to apply the changes made by pushing and popping layers.
+   *
+   * This must be called before the event loop runs.
+   */
+  void set_change_handler(ChangeHandler handler) {
+    mChangeHandler = std::move(handler);
+  }
+
+  /**
+   * Set the trace that each request is recorded in as it is received, or null
+   * to record nothing.
+   *
+   * This must be called before `wait`.
+   */
+  void set_trace(TraceWriter *trace) {
+    mTrace = trace;
+  }
+
+  /**
+   * Pull requests from the interprocess queue and post them to the event loop
+   * to be run, until `shutdown` has been called.
+   *
+   * Requests are run on the loop rather than here, so that they are ordered
+   * with new sessions and everything else the waiter reacts to. A thread only
+   * has to be spent on this because the loop cannot wait on the queue itself.
+   *
+   * Once `shutdown` is called there may be a delay of up to a second until
+   * this function returns. This is because, unlike some concurrent queues,
+   * Boost.Interprocess's message queue does not have any way of closing it and
+   * waking receivers. Pulling until the queue is closed therefore involves
+   * either sending an in-band shutdown message to the queue, or receiving with
+   * a timeout and polling an out-of-band signal in between.
+   *
+   * Since an in-band approach requires checking the type of the serialized
+   * message, and implementing a new message for essentially an implementation
+   * detail, this function polls.
+   */
+  void wait() {
+    constexpr auto pollInterval = std::chrono::seconds{1};
+    std::array<std::byte, em::MaxMessageSize> buf{};
+
+    do {
+      std::size_t size{};
+      unsigned int priority{};
+      const auto deadline{std::chrono::steady_clock::now() + pollInterval};
+      if (!mChannel.timed_receive(buf.data(), buf.size(), size, priority, deadline)) {
+        continue;
+      }
+
+      auto commands{decode_commands(std::span{buf.data(), size})};
+      if (!commands) {
+        mLog.warn("Received invalid request");
+        continue;
+      }
+      for (const auto &command : *commands) {
+        if (const auto *switchCommand{std::get_if<SwitchCommand>(&command)}) {
+          mStats.page().switchesReceived.fetch_add(1, std::memory_order_relaxed);
+          if (mTrace) {
+            mTrace->request(switchCommand->operation, switchCommand->configPath, switchCommand->profileName);
+          }
+        } else if (const auto *overrideCommand{std::get_if<OverrideCommand>(&command)}) {
+          if (mTrace) mTrace->set_override(overrideCommand->suffix, overrideCommand->volume);
+        } else if (mTrace) {
+          mTrace->clear_overrides();
+        }
+      }
+      mLoop.post([this, commands = std::move(*commands)] {
+        try {
+          run_batch(commands);
+        } catch (const winrt::hresult_error &e) {
+          mLog.error("Could not apply request: {}", winrt::to_string(e.message()));
+        }
+      });
+    } while (!mCloseFlag.test());
+  }
+
+  /**
+   * Close the queue so that any call to `wait` on the queue returns.
+   *
+   * Once the queue has been closed it cannot be reopened.
+   */
+  void shutdown() {
+    mCloseFlag.test_and_set();
+    mCloseFlag.notify_all();
+  }
+
+  /**
+   * Return the match memo of the currently active profile, which also holds
+   * the profile itself.
+   *
+   * This function is thread-safe.
+   *
+   * Profiles are immutable once loaded and switching replaces the pointer, so
+   * callers can keep using the returned profile while it is being changed.
+   * Sharing the profile instead of copying it keeps the session handler from
+   * allocating. Each profile gets a fresh memo, so switching invalidates the
+   * memo of the previous profile in the same step.
+   */
+  std::shared_ptr<em::MatchMemo> get_active_memo() const {
+    std::lock_guard lock{mMut};
+    return mActive;
+  }
+
+  /**
+   * Load a volume profile from a config file and make it the only layer of
+   * the active profile.
+   *
+   * This function is thread-safe.
+   *
+   * This function does not change the volume of any sessions. Any session
+   * opened after this call will have its volume set correctly by the session
+   * handler, and any existing sessions should be set by the client.
+   */
+  ProfileChange load_profile(const std::filesystem::path &configPath,
+                             const std::string &profileName) {
+    std::lock_guard update{mUpdateMut};
+    auto layer{make_layer(configPath, profileName, em::read_profile(configPath, profileName), nullptr)};
+    // The setter switching profile does not know of any overrides, so they
+    // are cleared rather than left applying to some sessions but not others.
+    auto active{layer.merged};
+    ProfileChange change{active_profile(), profile_of(active), {}};
+    {
+      std::lock_guard lock{mMut};
+      mLayers.clear();
+      mLayers.push_back(std::move(layer));
+      mOverrides = std::make_shared<const em::VolumeProfile>();
+      mActive = std::move(active);
+    }
+    return change;
+  }
+
+  /**
+   * Load a volume profile from a config file and push it as a new layer on
+   * top of the active profile.
+   *
+   * This function is thread-safe.
+   *
+   * \throws ProfileError if the profile cannot be read, in which case the
+   *         active profile is left as it was.
+   */
+  ProfileChange push_layer(const std::filesystem::path &configPath,
+                           const std::string &profileName) {
+    std::lock_guard update{mUpdateMut};
+    auto own{em::read_profile(configPath, profileName)};
+    // Layers are only changed with `mUpdateMut` held, so the top cannot change
+    // between here and the push.
+    const auto top{top_layer().merged};
+    auto layer{make_layer(configPath, profileName, own, &top->profile())};
+    auto active{make_active(layer.merged, *mOverrides)};
+    ProfileChange change{active_profile(), profile_of(active), std::move(own)};
+    {
+      std::lock_guard lock{mMut};
+      mLayers.push_back(std::move(layer));
+      mActive = std::move(active);
+    }
+    return change;
+  }
+
+  /**
+   * Pop the topmost layer off the active profile.
+   *
+   * This function is thread-safe.
+   *
+   * \throws ProfileError if only the base layer is left, which cannot be
+   *         popped.
+   */
+  ProfileChange pop_layer() {
+    std::lock_guard update{mUpdateMut};
+    if (mLayers.size() < 2) {
+      throw em::ProfileError("[error] There is no layer to pop");
+    }
+    auto active{make_active(mLayers[mLayers.size() - 2].merged, *mOverrides)};
+    ProfileChange change{active_profile(), profile_of(active), top_layer().own};
+    {
+      std::lock_guard lock{mMut};
+      mLayers.pop_back();
+      mActive = std::move(active);
+    }
+    return change;
+  }
+
+  /**
+   * Set the volume of whatever matches `suffix` over every layer of the active
+   * profile, replacing any override of the same suffix.
+   *
+   * This function is thread-safe.
+   *
+   * \throws ProfileError if the volume is out of range.
+   */
+  ProfileChange set_override(std::string_view suffix, float volume) {
+    std::lock_guard update{mUpdateMut};
+    auto overridden{std::make_shared<em::VolumeProfile>()};
+    try {
+      overridden->controls.emplace_back(suffix, volume);
+    } catch (const std::invalid_argument &e) {
+      throw em::ProfileError(std::format("[error] Could not override {}: {}", suffix, e.what()));
+    }
+    auto overrides{std::make_shared<const em::VolumeProfile>(em::overlay_profile(*mOverrides, *overridden))};
+    auto active{make_active(top_layer().merged, *overrides)};
+    ProfileChange change{active_profile(), profile_of(active), std::move(overridden)};
+    {
+      std::lock_guard lock{mMut};
+      mOverrides = std::move(overrides);
+      mActive = std::move(active);
+    }
+    return change;
+  }
+
+  /**
+   * Remove every override, leaving the layers of the active profile to decide
+   * the volume of what they matched.
+   *
+   * This function is thread-safe.
+   */
+  ProfileChange clear_overrides() {
+    std::lock_guard update{mUpdateMut};
+    ProfileChange change{active_profile(), top_layer().merged_profile(), mOverrides};
+    {
+      std::lock_guard lock{mMut};
+      mOverrides = std::make_shared<const em::VolumeProfile>();
+      mActive = top_layer().merged;
+    }
+    return change;
+  }
+
+  /**
+   * Load every layer of the active profile again from the config file that it
+   * was loaded from, such as after a file has been edited.
+   *
+   * This function is thread-safe.
+   *
+   * \throws ProfileError if any layer can no longer be read, in which case
+   *         the active profile is left as it was.
+   */
+  ProfileChange reload_profile() {
+    std::lock_guard update{mUpdateMut};
+    std::vector<Layer> layers;
+    {
+      std::lock_guard lock{mMut};
+      layers = mLayers;
+    }
+
+    std::vector<Layer> reloaded;
+    reloaded.reserve(layers.size());
+    for (auto &layer : layers) {
+      auto own{em::read_profile(layer.configPath, layer.profileName)};
+      const auto *below{reloaded.empty() ? nullptr : &reloaded.back().merged->profile()};
+      reloaded.push_back(make_layer(std::move(layer.configPath), std::move(layer.profileName),
+                                    std::move(own), below));
+    }
+
+    auto active{make_active(reloaded.back().merged, *mOverrides)};
+    ProfileChange change{active_profile(), profile_of(active), {}};
+    {
+      std::lock_guard lock{mMut};
+      mLayers = std::move(reloaded);
+      mActive = std::move(active);
+    }
+    return change;
+  }
+
+  /**
+   * Return the paths of the config files that the layers of the active profile
+   * came from, each only once, starting with that of the base layer.
+   *
+   * This function is thread-safe.
+   */
+  std::vector<std::filesystem::path> config_paths() const {
+    std::lock_guard lock{mMut};
+    std::vector<std::filesystem::path> paths;
+    for (const auto &layer : mLayers) {
+      if (std::ranges::find(paths, layer.configPath) == paths.end()) paths.push_back(layer.configPath);
+    }
+    return paths;
+  }
+
+  /**
+   * Return the stats page shared with other processes.
+   *
+   * The page is only updated through atomics, so this function is thread-safe.
+   */
+  StatsPage &stats() {
+    return mStats.page();
+  }
+
+private:
+  /**
+   * One layer of the active profile.
+   */
+  struct Layer {
+    std::filesystem::path configPath;
+    std::string profileName;
+    // The controls of this layer alone.
+    std::shared_ptr<const em::VolumeProfile> own;
+    // This layer merged over every layer beneath it, along with its memo.
+    std::shared_ptr<em::MatchMemo> merged;
+
+    [[nodiscard]] std::shared_ptr<const em::VolumeProfile> merged_profile() const {
+      return {merged, &merged->profile()};
+    }
+  };
+
+  /**
+   * Return the profile held by a memo, sharing its ownership.
+   */
+  static std::shared_ptr<const em::VolumeProfile> profile_of(const std::shared_ptr<em::MatchMemo> &memo) {
+    return {memo, &memo->profile()};
+  }
+
+  /**
+   * Return the memo of the active profile made of the layer `top` with
+   * `overrides` over it.
+   */
+  static std::shared_ptr<em::MatchMemo> make_active(std::shared_ptr<em::MatchMemo> top,
+                                                    const em::VolumeProfile &overrides) {
+    if (overrides.controls.empty()) return top;
+    return std::make_shared<em::MatchMemo>(
+        std::make_shared<const em::VolumeProfile>(em::overlay_profile(top->profile(), overrides)));
+  }
+
+  /**
+   * Return the active profile, which may only be called with `mUpdateMut`
+   * held.
+   */
+  std::shared_ptr<const em::VolumeProfile> active_profile() const {
+    std::lock_guard lock{mMut};
+    return profile_of(mActive);
+  }
+
+  /**
+   * Return the topmost layer, which may only be called with `mUpdateMut` held
+   * since the layers are only changed with it held.
+   */
+  const Layer &top_layer() const {
+    return mLayers.back();
+  }
+
+  /**
+   * Return a layer holding `own`, merged over the profile `below` if there is
+   * one.
+   */
+  static Layer make_layer(std::filesystem::path configPath, std::string profileName,
+                          std::shared_ptr<const em::VolumeProfile> own, const em::VolumeProfile *below) {
+    auto merged{below ? std::make_shared<em::MatchMemo>(
+                            std::make_shared<const em::VolumeProfile>(em::overlay_profile(*below, *own)))
+                      : std::make_shared<em::MatchMemo>(own)};
+    return {std::move(configPath), std::move(profileName), std::move(own), std::move(merged)};
+  }
+
+  /**
+   * Decode a message pulled from the queue into the commands that it holds, or
+   * return an empty optional if it is not valid.
+   */
+  static std::optional<std::vector<Command>> decode_commands(std::span<const std::byte> buf) {
+    std::vector<Command> commands;
+#ifdef EM_USE_PROTOBUF
+    ::declvol::v1::CommandBatch batch;
+    if (!batch.ParseFromArray(buf.data(), static_cast<int>(buf.size()))) return std::nullopt;
+    const auto add_switch{[&commands](const ::declvol::v1::SwitchProfileRequest &request) {
+      commands.push_back(SwitchCommand{static_cast<em::wire::Operation>(request.operation()),
+                                       request.config_path(), request.profile()});
+    }};
+    if (batch.commands_size() == 0) {
+      // A request on its own, as setters send to switch, push or pop.
+      ::declvol::v1::SwitchProfileRequest request;
+      if (!request.ParseFromArray(buf.data(), static_cast<int>(buf.size()))) return std::nullopt;
+      add_switch(request);
+    }
+    for (const auto &command : batch.commands()) {
+      switch (command.command_case()) {
+        case ::declvol::v1::Command::kSwitchProfile:
+          add_switch(command.switch_profile());
+          break;
+        case ::declvol::v1::Command::kSetOverride:
+          commands.push_back(OverrideCommand{command.set_override().suffix(), command.set_override().volume()});
+          break;
+        case ::declvol::v1::Command::kClearOverrides:
+          commands.push_back(ClearCommand{});
+          break;
+        default:
+          return std::nullopt;
+      }
+    }
+#else
+    const auto batch{em::wire::decode_request(buf)};
+    if (!batch) return std::nullopt;
+    for (const auto &command : batch->commands) {
+      if (const auto *request{std::get_if<em::wire::SwitchProfileRequest>(&command)}) {
+        commands.push_back(SwitchCommand{request->operation, std::string{request->configPath},
+                                         std::string{request->profile}});
+      } else if (const auto *setOverride{std::get_if<em::wire::SetOverride>(&command)}) {
+        commands.push_back(OverrideCommand{std::string{setOverride->suffix}, setOverride->volume});
+      } else {
+        commands.push_back(ClearCommand{});
+      }
+    }
+#endif
+    return commands;
+  }
+
+  /**
+   * Run one command of a request.
+   */
+  ProfileChange run_command(const Command &command) {
+    if (const auto *switchCommand{std::get_if<SwitchCommand>(&command)}) {
+      switch (switchCommand->operation) {
+        case em::wire::Operation::Replace:
+          return switch_profile(switchCommand->configPath, switchCommand->profileName);
+        case em::wire::Operation::Push: {
+          auto change{push_layer(std::filesystem::path{switchCommand->configPath}, switchCommand->profileName)};
+          mLog.info("Pushed layer {}", switchCommand->profileName);
+          return change;
+        }
+        case em::wire::Operation::Pop: {
+          auto change{pop_layer()};
+          mLog.info("Popped layer");
+          return change;
+        }
+      }
+      throw em::ProfileError(std::format("[error] Unknown operation {}",
+                                         static_cast<std::uint32_t>(switchCommand->operation)));
+    }
+    if (const auto *overrideCommand{std::get_if<OverrideCommand>(&command)}) {
+      auto change{set_override(overrideCommand->suffix, overrideCommand->volume)};
+      mLog.info("Overrode volume of {} to {}", overrideCommand->suffix, overrideCommand->volume);
+      return change;
+    }
+    auto change{clear_overrides()};
+    mLog.info("Cleared overrides");
+    return change;
+  }
+
+  /**
+   * Run the commands of one request pulled from the queue in order, and pass
+   * their combined change to the change handler.
+   *
+   * A command that fails is reported and skipped, and the rest still run. The
+   * controls changed by each command are collected, so that the handler only
+   * has to look at the sessions that any of them match, once.
+   */
+  void run_batch(const std::vector<Command> &commands) {
+    std::shared_ptr<const em::VolumeProfile> previous;
+    em::VolumeProfile changed;
+    bool changedAll{false};
+    bool ran{false};
+    for (const auto &command : commands) {
+      ProfileChange change;
+      try {
+        change = run_command(command);
+      } catch (const em::ProfileError &e) {
+        // A bad request from one setter should not stop the waiter.
+        mLog.error("{}", e.what());
+        continue;
+      }
+      ran = true;
+      if (!previous) previous = change.previous;
+
+      if (const auto *switchCommand{std::get_if<SwitchCommand>(&command)};
+          switchCommand && switchCommand->operation == em::wire::Operation::Replace) {
+        // The setter applies the profile it switches to, so only what later
+        // commands change is left for the waiter.
+        previous = change.current;
+        changed.controls.clear();
+        changedAll = false;
+      } else if (change.changed) {
+        changed.controls.insert(changed.controls.end(), change.changed->controls.begin(),
+                                change.changed->controls.end());
+      } else {
+        changedAll = true;
+      }
+    }
+    if (!ran || !mChangeHandler) return;
+
+    ProfileChange change{std::move(previous), active_profile(), {}};
+    if (!changedAll) change.changed = std::make_shared<const em::VolumeProfile>(std::move(changed));
+    const bool apply{changedAll || !change.changed->controls.empty()};
+    mChangeHandler(change, apply);
+  }
+
+  ipc::message_queue &mChannel;
+  EventLoop &mLoop;
+  Logger &mLog;
+  // Held while the layers are being replaced, so that pushes, pops and reloads
+  // do not race each other. Unlike `mMut` it is held while reading profiles,
+  // which does not hold up the session handler.
+  std::mutex mUpdateMut;
+  mutable std::mutex mMut;
+  std::vector<Layer> mLayers;
+  // Controls set by `set_override`, over every layer.
+  std::shared_ptr<const em::VolumeProfile> mOverrides;
+  // The topmost layer with the overrides over it.
+  std::shared_ptr<em::MatchMemo> mActive;
+  ChangeHandler mChangeHandler;
+  TraceWriter *mTrace{};
+  std::atomic_flag mCloseFlag;
+  SharedStats mStats;
+};
+
+void VolumeEnforcer::volume_changed(const std::string &key, float volume) {
+  std::lock_guard lock{mMut};
+  const auto it{mWatched.find(key)};
+  if (it == mWatched.end()) return;
+  auto &watched{*it->second};
+
+  const auto memo{mService.get_active_memo()};
+  const auto *control{watched.name == ":system"
+                          ? em::find_control(memo->profile(), ":system")
+                          : em::match_session_ancestors(
+                                memo->index(),
+                                memo->index().match(memo->match(watched.name), em::field_fetcher(watched.sessionCtrl)),
+                                watched.sessionCtrl, mProcesses)};
+  if (!control || control->relative_volume() == volume) return;
+
+  auto &stats{mService.stats()};
+  const auto now{std::chrono::steady_clock::now()};
+  if (now - watched.windowStart >= RevertWindow) {
+    watched.windowStart = now;
+    watched.reverts = 0;
+  }
+  if (watched.reverts++ >= MaxReverts) {
+    if (watched.reverts == MaxReverts + 1) {
+      mLog.warn("{} keeps changing its own volume, leaving it at {} for now", watched.name, volume);
+    }
+    stats.enforcementsLimited.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  try {
+    em::set_session_master_volume(*control, watched.sessionCtrl, &mRamps);
+  } catch (const winrt::hresult_error &) {
+    // The session has probably gone away since the change was posted.
+    return;
+  }
+  stats.volumesEnforced.fetch_add(1, std::memory_order_relaxed);
+  mLog.info("Put volume of {} back to {}", watched.name, control->relative_volume());
+}
+
+/**
+ * Sets the volume of new audio sessions away from the thread announcing them.
+ *
+ * Session notifications arrive on a thread of the audio service, which must not
+ * be blocked. Handling a session opens its process, queries its image name, and
+ * writes to the console, so the notification handler only pushes the session
+ * onto a bounded queue and the event loop takes it from there, in order with
+ * profile switches. If the queue is ever full then the session is put on an
+ * unbounded overflow list instead of being dropped, which the event loop
+ * drains after the queue, so that its volume is still set without blocking
+ * the announcing thread on anything but a short lock.
+ *
+ * The depth of the queue and the time sessions spend in it are recorded in the
+ * service's stats.
+ */
+class SessionWorker {
+public:
+  static constexpr std::size_t QueueCapacity = 256ull;
+
+  /**
+   * Create a worker draining its queue on `loop`, which must not run again
+   * once the worker has been destroyed.
+   */
+  explicit SessionWorker(DeclvolService &service, const ApplyContext &ctx, EventLoop &loop)
+      : mService{service},
+        mCtx{ctx},
+        mLoop{loop} {}
+
+  SessionWorker(const SessionWorker &) = delete;
+  SessionWorker &operator=(const SessionWorker &) = delete;
+
+  /**
+   * Queue a newly announced session to have its volume set.
+   *
+   * This function is thread-safe. It is lock-free unless the queue is full,
+   * when it briefly takes the lock of the overflow list.
+   */
+  void post(const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl) {
+    const auto announced{std::chrono::steady_clock::now()};
+    auto &stats{mService.stats()};
+
+    // Count the session before the worker can take it, so that the depth can
+    // never drop below zero.
+    stats.queueDepth.fetch_add(1, std::memory_order_relaxed);
+    if (!mQueue.try_push(Job{sessionCtrl, announced})) {
+      stats.queueOverflows.fetch_add(1, std::memory_order_relaxed);
+      std::lock_guard lock{mOverflowMut};
+      mOverflow.push_back(Job{sessionCtrl, announced});
+    }
+
+    // One drain takes every queued session, so there is no need to post
+    // another until it has started.
+    if (!mDrainPosted.test_and_set()) mLoop.post([this] { drain(); });
+  }
+
+private:
+  struct Job {
+    winrt::com_ptr<IAudioSessionControl2> sessionCtrl;
+    std::chrono::steady_clock::time_point announced;
+  };
+
+  void drain() {
+    // Cleared before popping, so that a session pushed after the last pop
+    // posts a drain of its own.
+    mDrainPosted.clear();
+    while (auto job{mQueue.try_pop()}) take(*job);
+
+    // Sessions that overflowed were announced before some of those in the
+    // queue, but each is handled against the profile active now, so the order
+    // between the two does not matter.
+    std::vector<Job> overflow;
+    {
+      std::lock_guard lock{mOverflowMut};
+      overflow.swap(mOverflow);
+    }
+    for (const auto &job : overflow) take(job);
+  }
+
+  void take(const Job &job) {
+    auto &stats{mService.stats()};
+    stats.queueDepth.fetch_sub(1, std::memory_order_relaxed);
+    stats.queueLatency.record(std::chrono::steady_clock::now() - job.announced);
+    handle(job.sessionCtrl, job.announced);
+  }
+
+  void handle(const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl,
+              std::chrono::steady_clock::time_point announced) {
+    try {
+      em::ScratchArena<em::SessionArenaSize> scratch;
+      em::set_session_volume(*mService.get_active_memo(), sessionCtrl, scratch.resource(), mCtx);
+      mService.stats().applyLatency.record(std::chrono::steady_clock::now() - announced);
+    } catch (const winrt::hresult_error &e) {
+      // A session that cannot be handled, such as one belonging to a protected
+      // process, should not stop the worker.
+      mCtx.log.warn("Could not set volume of new session: {}", winrt::to_string(e.message()));
+    }
+  }
+
+  DeclvolService &mService;
+  ApplyContext mCtx;
+  EventLoop &mLoop;
+  BoundedQueue<Job, QueueCapacity> mQueue;
+  std::mutex mOverflowMut;
+  // Sessions that did not fit in the queue, in the order they were announced.
+  std::vector<Job> mOverflow;
+  std::atomic_flag mDrainPosted;
+};
+
+/**
+ * Return whether switching from the control `previous` to `current` changes
+ * the volume of whatever they match.
+ */
+bool volume_changed(const VolumeControl *previous, const VolumeControl *current) {
+  // If nothing matches any more then the volume is left as it is.
+  if (!current) return false;
+  return !previous || previous->relative_volume() != current->relative_volume();
+}
+
+/**
+ * Apply a change of the active profile to the device and to the sessions in
+ * the registry.
+ *
+ * Only the device or sessions whose winning control now has a different volume
+ * are touched. When the change says which controls changed, sessions that none
+ * of them match are skipped without matching them against either profile.
+ * Ancestor controls are matched through `processes`, if it is given.
+ * Returns the number of sessions whose volume was changed.
+ */
+std::size_t apply_profile_change(const DeclvolService::ProfileChange &change,
+                                 SessionRegistry &registry,
+                                 const winrt::com_ptr<IMMDevice> &device,
+                                 RampScheduler &ramps,
+                                 const ProcessIndex *processes) {
+  const auto &previous{*change.previous};
+  const auto &current{*change.current};
+
+  if (em::volume_changed(em::find_control(previous, ":device"),
+                         em::find_control(current, ":device"))) {
+    em::set_device_volume(current, device, &ramps);
+  }
+
+  const ControlIndex previousIndex{previous};
+  const ControlIndex currentIndex{current};
+  std::optional<ControlIndex> changedIndex;
+  if (change.changed) changedIndex.emplace(*change.changed);
+
+  std::size_t numChanged{0};
+  registry.for_each([&](const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+                        std::string_view name) {
+    const auto match{[&](const VolumeProfile &profile, const ControlIndex &index) {
+      const auto *control{index.match(em::match_control(profile, name), em::field_fetcher(sessionCtrl))};
+      return em::match_session_ancestors(index, control, sessionCtrl, processes);
+    }};
+    if (changedIndex && !match(*change.changed, *changedIndex)) return;
+    const auto *control{match(current, currentIndex)};
+    if (!em::volume_changed(match(previous, previousIndex), control)) return;
+
+    try {
+      em::set_session_master_volume(*control, sessionCtrl, &ramps);
+      ++numChanged;
+    } catch (const winrt::hresult_error &) {
+      // The session has probably gone away since the registry was pruned.
+    }
+  });
+
+  return numChanged;
+}
+
+#ifndef EM_EMBEDDED_PROFILES
+// Embedded profiles cannot change, so there is nothing to watch.
+
+/**
+ * Watches the config files of every layer of the active profile from the event
+ * loop and applies any changes to them.
+ *
+ * Nothing that goes wrong while watching or reloading stops the waiter. A file
+ * that cannot be read, such as one that is only partly written, leaves the
+ * active profile as it was until the file is fixed, and a file that cannot be
+ * watched is reported and left unwatched.
+ */
+class ConfigWatcher {
+public:
+  // Editors often save a file in several steps, so wait for the writes to
+  // settle before reading it.
+  static constexpr auto SettleInterval = std::chrono::milliseconds{100};
+
+  explicit ConfigWatcher(EventLoop &loop, DeclvolService &service, SessionRegistry &registry,
+                         const winrt::com_ptr<IMMDevice> &device, RampScheduler &ramps,
+                         const ProcessIndex *processes, Logger &log)
+      : mLoop{loop},
+        mService{service},
+        mRegistry{registry},
+        mDevice{device},
+        mRamps{ramps},
+        mProcesses{processes},
+        mLog{log} {
+    follow(mService.config_paths());
+  }
+
+  ConfigWatcher(const ConfigWatcher &) = delete;
+  ConfigWatcher &operator=(const ConfigWatcher &) = delete;
+
+  ~ConfigWatcher() {
+    for (const auto &[path, watcher] : mWatchers) mLoop.remove_source(watcher->native_handle());
+  }
+
+  /**
+   * Watch exactly the files in `configPaths`, such as after a setter pushed a
+   * layer from a different file or switched to a profile in one.
+   */
+  void follow(const std::vector<std::filesystem::path> &configPaths) {
+    std::erase_if(mWatchers, [&](const auto &entry) {
+      if (std::ranges::find(configPaths, entry.first) != configPaths.end()) return false;
+      mLoop.remove_source(entry.second->native_handle());
+      return true;
+    });
+
+    for (const auto &configPath : configPaths) {
+      if (mWatchers.contains(configPath)) continue;
+      try {
+        auto watcher{em::make_file_watcher(configPath)};
+        const auto handle{watcher->native_handle()};
+        auto &watched{*mWatchers.emplace(configPath, std::move(watcher)).first};
+        mLoop.add_source(handle, [this, &watched] { changed(watched.first, *watched.second); });
+      } catch (const winrt::hresult_error &e) {
+        mLog.error("Could not watch {}: {}", configPath.string(), winrt::to_string(e.message()));
+      } catch (const std::exception &e) {
+        mLog.error("Could not watch {}: {}", configPath.string(), e.what());
+      }
+    }
+  }
+
+private:
+  void changed(const std::filesystem::path &configPath, FileWatcher &watcher) {
+    try {
+      if (!watcher.wait_for_change(std::chrono::milliseconds{0})) return;
+    } catch (const winrt::hresult_error &e) {
+      // The change is still worth reloading, in case it was to this file.
+      mLog.warn("Could not read changes to {}: {}", configPath.string(), winrt::to_string(e.message()));
+    } catch (const std::exception &e) {
+      mLog.warn("Could not read changes to {}: {}", configPath.string(), e.what());
+    }
+
+    // Each change pushes the reload back, so only the last one of a burst
+    // reloads the files, however many of them changed.
+    const auto generation{++mGeneration};
+    mLoop.post_after(SettleInterval, [this, generation] {
+      if (generation == mGeneration) reload();
+    });
+  }
+
+  void reload() {
+    try {
+      const auto numChanged{em::apply_profile_change(mService.reload_profile(), mRegistry, mDevice, mRamps, mProcesses)};
+      mLog.info("Reloaded config, changed volume of {} sessions", numChanged);
+    } catch (const em::ProfileError &e) {
+      // Probably a half-finished edit, keep the current profile until the
+      // file is fixed.
+      mLog.error("{}", e.what());
+    } catch (const winrt::hresult_error &e) {
+      mLog.error("Could not apply reloaded config: {}", winrt::to_string(e.message()));
+    } catch (const std::exception &e) {
+      mLog.error("Could not reload config: {}", e.what());
+    }
+  }
+
+  EventLoop &mLoop;
+  DeclvolService &mService;
+  SessionRegistry &mRegistry;
+  const winrt::com_ptr<IMMDevice> &mDevice;
+  RampScheduler &mRamps;
+  const ProcessIndex *mProcesses;
+  Logger &mLog;
+  // Nodes of a map are never moved, so the event loop handlers can refer to
+  // them.
+  std::map<std::filesystem::path, std::unique_ptr<FileWatcher>> mWatchers;
+  std::uint64_t mGeneration{0};
+};
+#endif
+
+/**
+ * Stops the event loop when enter is pressed, stdin ends, or the console is
+ * closed.
+ *
+ * When stdin is a console the loop waits on its input handle. Otherwise it may
+ * be a pipe or a file, which cannot be waited on, so a thread reads it instead.
+ * Closing the console, logging off, and shutting down all terminate the
+ * process soon after the control handler returns, so the handler waits until
+ * the watcher is destroyed, which should be once the waiter has cleaned up.
+ */
+class ExitWatcher {
+public:
+  explicit ExitWatcher(EventLoop &loop)
+      : mLoop{loop},
+        mInput{::GetStdHandle(STD_INPUT_HANDLE)} {
+    // Stored before anything can stop the loop through it, such as stdin
+    // ending as soon as the thread reading it starts.
+    sLoop.store(&mLoop);
+
+    DWORD mode{};
+    mConsole = mInput && mInput != INVALID_HANDLE_VALUE && ::GetConsoleMode(mInput, &mode);
+    if (mConsole) {
+      mLoop.add_source(mInput, [this] { read_console(); });
+    } else {
+      // The thread cannot be interrupted, so it is left to be ended with the
+      // process.
+      std::thread{[] {
+        std::cin.get();
+        if (auto *loop{sLoop.load()}) loop->stop();
+      }}.detach();
+    }
+
+    winrt::check_bool(::SetConsoleCtrlHandler(&ExitWatcher::on_console_control, TRUE));
+  }
+
+  ExitWatcher(const ExitWatcher &) = delete;
+  ExitWatcher &operator=(const ExitWatcher &) = delete;
+
+  ~ExitWatcher() {
+    ::SetConsoleCtrlHandler(&ExitWatcher::on_console_control, FALSE);
+    if (mConsole) mLoop.remove_source(mInput);
+    sLoop.store(nullptr);
+    sExited.test_and_set();
+    sExited.notify_all();
+  }
+
+private:
+  void read_console() {
+    std::array<INPUT_RECORD, 16> records;
+    DWORD count{};
+    if (!::ReadConsoleInputW(mInput, records.data(), static_cast<DWORD>(records.size()), &count)) {
+      mLoop.stop();
+      return;
+    }
+
+    for (const auto &record : std::span{records.data(), count}) {
+      if (record.EventType == KEY_EVENT && record.Event.KeyEvent.bKeyDown
+          && record.Event.KeyEvent.wVirtualKeyCode == VK_RETURN) {
+        mLoop.stop();
+        return;
+      }
+    }
+  }
+
+  static BOOL WINAPI on_console_control(DWORD type) {
+    auto *loop{sLoop.load()};
+    if (!loop) return FALSE;
+
+    loop->stop();
+    if (type != CTRL_C_EVENT && type != CTRL_BREAK_EVENT) sExited.wait(false);
+    return TRUE;
+  }
+
+  inline static std::atomic<EventLoop *> sLoop{nullptr};
+  inline static std::atomic_flag sExited;
+
+  EventLoop &mLoop;
+  HANDLE mInput;
+  bool mConsole{};
+};
+
+/**
+ * Client class to interact with the `declvol` service.
+ */
+class DeclvolClient final {
+public:
+  explicit DeclvolClient(ipc::message_queue &channel) : mChannel{channel} {}
+
+  /**
+   * Notify the connected waiter process that the active profile has changed
+   * so that it can correctly set the volume of future audio sessions.
+   *
+   * The waiter service does not set the volume of any existing sessions, so
+   * the intention is that client's will change the volume of all existing
+   * processes and also issue this notification to the service.
+   */
+  void switch_profile(const std::filesystem::path &configPath,
+                      const std::string &profileName) {
+    send(em::wire::Operation::Replace, configPath, profileName);
+  }
+
+  /**
+   * Ask the connected waiter process to push a profile as a new layer over
+   * its active profile.
+   *
+   * Unlike switching, the waiter applies the layer to existing sessions
+   * itself, because only it knows what the layers beneath it are.
+   */
+  void push_layer(const std::filesystem::path &configPath,
+                  const std::string &profileName) {
+    send(em::wire::Operation::Push, configPath, profileName);
+  }
+
+  /**
+   * Ask the connected waiter process to pop the topmost layer off its active
+   * profile, which it applies to existing sessions itself.
+   */
+  void pop_layer() {
+    send(em::wire::Operation::Pop, {}, {});
+  }
+
+  /**
+   * Ask the connected waiter process to override the volume of whatever each
+   * suffix matches, first clearing any earlier overrides if `clear` is set.
+   *
+   * Everything is sent as one request, so the waiter applies it to existing
+   * sessions in a single pass.
+   *
+   * \throws WireError if the overrides do not fit in one request.
+   */
+  void set_overrides(bool clear, const std::vector<std::pair<std::string, float>> &overrides) {
+#ifdef EM_USE_PROTOBUF
+    declvol::v1::CommandBatch batch;
+    if (clear) batch.add_commands()->mutable_clear_overrides();
+    for (const auto &[suffix, volume] : overrides) {
+      auto *setOverride{batch.add_commands()->mutable_set_override()};
+      setOverride->set_suffix(suffix);
+      setOverride->set_volume(volume);
+    }
+
+    const auto buf{batch.SerializeAsString()};
+    const auto size{buf.size()};
+    if (size > em::MaxMessageSize) {
+      throw em::wire::WireError(std::format("Message of {} bytes does not fit in a request", size));
+    }
+#else
+    em::wire::CommandBatch batch;
+    if (clear) batch.commands.emplace_back(em::wire::ClearOverrides{});
+    for (const auto &[suffix, volume] : overrides) {
+      batch.commands.emplace_back(em::wire::SetOverride{suffix, volume});
+    }
+
+    std::array<std::byte, em::MaxMessageSize> buf{};
+    const auto size{em::wire::encode(batch, buf)};
+#endif
+    if (!mChannel.try_send(buf.data(), size, 0)) {
+      throw std::runtime_error("Cannot send overrides to waiter, too many requests in queue.");
+    }
+  }
+
+private:
+  void send(em::wire::Operation operation, const std::filesystem::path &configPath,
+            const std::string &profileName) {
+#ifdef EM_USE_PROTOBUF
+    declvol::v1::SwitchProfileRequest req;
+    req.set_profile(profileName);
+    req.set_config_path(configPath.string());
+    req.set_operation(static_cast<declvol::v1::SwitchProfileRequest_Operation>(operation));
+
+    const auto buf{req.SerializeAsString()};
+    const auto size{buf.size()};
+#else
+    const auto configPathStr{configPath.string()};
+    em::wire::SwitchProfileRequest req;
+    req.profile = profileName;
+    req.configPath = configPathStr;
+    req.operation = operation;
+
+    std::array<std::byte, em::MaxMessageSize> buf{};
+    const auto size{em::wire::encode(req, buf)};
+#endif
+    if (!mChannel.try_send(buf.data(), size, 0)) {
+      throw std::runtime_error("Cannot notify waiter that active profile is changed, too many requests in queue.");
+    }
+  }
+
+private:
+  ipc::message_queue &mChannel;
+};
+
+/**
+ * Print the stats of a waiter in a human-readable form.
+ */
+void print_stats(const StatsPage &stats) {
+  std::cout << "Sessions handled: " << stats.sessionsHandled.load() << '\n'
+            << "Processes that could not be opened: " << stats.openProcessFailures.load() << '\n'
+            << "Profile switches received: " << stats.switchesReceived.load() << '\n';
+
+  if (const auto count{stats.applyLatency.count()}) {
+    const auto mean{std::chrono::duration<double, std::micro>(stats.applyLatency.sum()) / count};
+    std::cout << std::format("New sessions set: {}, taking {:.1f}us on average\n",
+                             count, mean.count());
+  }
+  if (const auto count{stats.queueLatency.count()}) {
+    const auto mean{std::chrono::duration<double, std::micro>(stats.queueLatency.sum()) / count};
+    std::cout << std::format("New sessions queued for {:.1f}us on average\n", mean.count());
+  }
+  std::cout << "Sessions that shared the match of another in the same group: "
+            << stats.sessionsGrouped.load() << '\n';
+  if (const auto hits{stats.memoHits.load()}, misses{stats.memoMisses.load()}; hits + misses) {
+    std::cout << std::format("New sessions matched from the memo: {} of {} ({:.1f}%)\n", hits,
+                             hits + misses, 100.0 * static_cast<double>(hits) / static_cast<double>(hits + misses));
+  }
+  if (const auto limited{stats.enforcementsLimited.load()}, enforced{stats.volumesEnforced.load()};
+      enforced + limited) {
+    std::cout << std::format("Volume changes by other programs put back: {}, left alone: {}\n",
+                             enforced, limited);
+  }
+  std::cout << "New sessions waiting: " << stats.queueDepth.load() << '\n'
+            << "New sessions deferred because the queue was full: "
+            << stats.queueOverflows.load() << '\n';
+
+  std::cout << "Matches per control:\n";
+  stats.controlMatches.for_each([](em::MatchKind kind, std::string_view suffix, std::uint64_t matches) {
+    std::cout << std::format("  {} = \"{}\": {}\n", em::match_kind_name(kind), suffix, matches);
+  });
+  if (const auto overflow{stats.controlMatches.overflow()}) {
+    std::cout << std::format("  (other controls): {}\n", overflow);
+  }
+}
+
+/**
+ * Run the `stats` subcommand, which prints the stats of the running waiter.
+ *
+ * The stats are read straight from shared memory, so the waiter is not
+ * involved and does not need to be responsive.
+ */
+int run_stats(int argc, char *argv[]) {
+  argparse::ArgumentParser app(std::format("{} stats", em::ExecutableName),
+                               std::string{em::ExecutableVersion});
+  app.add_description("Print statistics about the running waiter process.");
+  app.add_argument("--openmetrics")
+      .implicit_value(true)
+      .default_value(false)
+      .help("print in the OpenMetrics text format, for scraping.");
+
+  try {
+    app.parse_args(argc, argv);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << '\n'
+              << app;
+    return 1;
+  }
+
+  std::optional<ipc::windows_shared_memory> memory;
+  try {
+    memory.emplace(ipc::open_only, em::StatsPageName.data(), ipc::read_only);
+  } catch (const ipc::interprocess_exception &) {
+    std::cerr << "No waiter process is running\n";
+    return 1;
+  }
+
+  const ipc::mapped_region region{*memory, ipc::read_only};
+  const auto *stats{static_cast<const StatsPage *>(region.get_address())};
+  if (region.get_size() < sizeof(StatsPage) || !stats->valid()) {
+    std::cerr << "The running waiter process is from an incompatible version\n";
+    return 1;
+  }
+
+  if (app.get<bool>("--openmetrics")) {
+    std::cout << em::format_openmetrics(*stats);
+  } else {
+    em::print_stats(*stats);
+  }
+  return 0;
+}
+
+/**
+ * Run the `push` or `pop` subcommand, which pushes a profile as a layer over
+ * the active profile of the running waiter, or pops the topmost layer off it.
+ *
+ * The waiter applies the change to existing sessions, so these do nothing
+ * without one.
+ */
+int run_layer(int argc, char *argv[]) {
+  const std::string_view command{argv[0]};
+  const bool push{command == "push"};
+
+  argparse::ArgumentParser app(std::format("{} {}", em::ExecutableName, command),
+                               std::string{em::ExecutableVersion});
+  if (push) {
+    app.add_description("Push a profile over the active profile of the running waiter.");
+    app.add_argument("profile")
+        .help("name of the profile to push")
+        .required();
+#ifndef EM_EMBEDDED_PROFILES
+    app.add_argument("--config")
+        .help("path to the configuration file");
+#endif
+  } else {
+    app.add_description("Pop the last profile pushed over the active profile of the running waiter.");
+  }
+
+  try {
+    app.parse_args(argc, argv);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << '\n'
+              << app;
+    return 1;
+  }
+
+  std::optional<em::QueueHolder> queueHolder;
+  try {
+    queueHolder.emplace(ipc::open_only, em::RpcQueueName.data());
+  } catch (const ipc::interprocess_exception &) {
+    std::cerr << "No waiter process is running\n";
+    return 1;
+  }
+
+  em::DeclvolClient client(queueHolder->queue);
+  if (!push) {
+    client.pop_layer();
+    return 0;
+  }
+
+  const auto profileName{app.get<std::string>("profile")};
+#ifdef EM_EMBEDDED_PROFILES
+  const std::filesystem::path configPath{};
+#else
+  const auto configPath{std::filesystem::absolute(em::get_config_path(app))};
+#endif
+  // Check the profile here, so that a typo is reported to the user rather
+  // than only in the log of the waiter.
+  try {
+    em::read_profile(configPath, profileName);
+  } catch (const em::ProfileError &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  client.push_layer(configPath, profileName);
+  return 0;
+}
+
+/**
+ * Run the `set` subcommand, which overrides the volume of whatever each suffix
+ * matches over every layer of the active profile of the running waiter.
+ *
+ * Overrides last until they are cleared or the waiter switches profile, and
+ * like layers are applied to existing sessions by the waiter.
+ */
+int run_set(int argc, char *argv[]) {
+  argparse::ArgumentParser app(std::format("{} set", em::ExecutableName),
+                               std::string{em::ExecutableVersion});
+  app.add_description("Override the volume of programs over the active profile of the running waiter.");
+  app.add_argument("--clear")
+      .implicit_value(true)
+      .default_value(false)
+      .help("clear earlier overrides before setting any new ones");
+  app.add_argument("overrides")
+      .help("pairs of a suffix of the image path and the volume to set, from 0.0 to 1.0")
+      .remaining();
+
+  try {
+    app.parse_args(argc, argv);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << '\n'
+              << app;
+    return 1;
+  }
+
+  const bool clear{app.get<bool>("--clear")};
+  auto args{app.present<std::vector<std::string>>("overrides").value_or(std::vector<std::string>{})};
+  if (args.size() % 2 != 0 || (args.empty() && !clear)) {
+    std::cerr << "Expected pairs of a suffix and a volume\n"
+              << app;
+    return 1;
+  }
+
+  std::vector<std::pair<std::string, float>> overrides;
+  overrides.reserve(args.size() / 2);
+  for (std::size_t i{0}; i < args.size(); i += 2) {
+    const std::string_view value{args[i + 1]};
+    float volume{};
+    const auto [end, ec]{std::from_chars(value.data(), value.data() + value.size(), volume)};
+    if (ec != std::errc{} || end != value.data() + value.size() || volume < 0.0f || volume > 1.0f) {
+      std::cerr << std::format("Volume {} of {} is not between 0.0 and 1.0\n", value, args[i]);
+      return 1;
+    }
+    overrides.emplace_back(std::move(args[i]), volume);
+  }
+
+  std::optional<em::QueueHolder> queueHolder;
+  try {
+    queueHolder.emplace(ipc::open_only, em::RpcQueueName.data());
+  } catch (const ipc::interprocess_exception &) {
+    std::cerr << "No waiter process is running\n";
+    return 1;
+  }
+
+  em::DeclvolClient client(queueHolder->queue);
+  try {
+    client.set_overrides(clear, overrides);
+  } catch (const em::wire::WireError &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Run `f(i)` for every `i` below `count`, spread over a few threads.
+ *
+ * Every call on an audio session is a round trip to the audio service, so
+ * making them from several threads at once hides most of the latency when
+ * there are many sessions. Each thread joins the multithreaded apartment, and
+ * `f` must only touch what belongs to its own `i` and must not throw.
+ */
+template<class F>
+void for_each_parallel(std::size_t count, F f) {
+  // Starting a thread costs about as much as a few round trips.
+  constexpr std::size_t itemsPerThread{8};
+  const auto numThreads{std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                                              (count + itemsPerThread - 1) / itemsPerThread)};
+  std::atomic<std::size_t> next{0};
+  const auto run{[&] {
+    for (auto i{next.fetch_add(1, std::memory_order_relaxed)}; i < count;
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      f(i);
+    }
+  }};
+
+  std::vector<std::jthread> threads;
+  for (std::size_t t{1}; t < numThreads; ++t) {
+    threads.emplace_back([&run] {
+      winrt::init_apartment();
+      run();
+      winrt::uninit_apartment();
+    });
+  }
+  run();
+}
+
+/**
+ * An audio session as it is captured in or restored from a snapshot.
+ */
+struct SnapshotSession {
+  winrt::com_ptr<IAudioSessionControl> sessionCtrl;
+  std::uint32_t pid{};
+  GroupingKey grouping{};
+  // Image path of the session's process, `:system`, or empty if the session
+  // or its process has gone away.
+  std::string name;
+  float volume{};
+  bool muted{};
+};
+
+/**
+ * Return every current audio session with its name and grouping parameter,
+ * and its volume and mute state if `withVolume` is true.
+ *
+ * The sessions are read in parallel, and their processes are then resolved
+ * together from one snapshot of the system.
+ */
+std::vector<SnapshotSession> collect_snapshot_sessions(const winrt::com_ptr<IAudioSessionManager2> &sessionMgr,
+                                                       bool withVolume) {
+  std::vector<SnapshotSession> sessions;
+  for (auto &&sessionCtrl : em::get_audio_sessions(sessionMgr)) {
+    sessions.push_back(SnapshotSession{std::move(sessionCtrl)});
+  }
+
+  // Bytes rather than `std::vector<bool>`, so that threads can write their
+  // own element.
+  std::vector<std::uint8_t> valid(sessions.size(), false);
+  em::for_each_parallel(sessions.size(), [&](std::size_t i) {
+    auto &session{sessions[i]};
+    try {
+      const auto sessionCtrl2{session.sessionCtrl.as<IAudioSessionControl2>()};
+      if (sessionCtrl2->IsSystemSoundsSession() != S_OK) {
+        session.pid = em::get_process_id(sessionCtrl2);
+        const auto grouping{em::get_grouping_param(session.sessionCtrl)};
+        std::memcpy(session.grouping.data(), &grouping, sizeof(grouping));
+      }
+      if (withVolume) {
+        const auto volume{session.sessionCtrl.as<ISimpleAudioVolume>()};
+        BOOL muted{};
+        winrt::check_hresult(volume->GetMasterVolume(&session.volume));
+        winrt::check_hresult(volume->GetMute(&muted));
+        session.muted = muted != FALSE;
+      }
+      valid[i] = true;
+    } catch (const winrt::hresult_error &) {
+      // The session has probably gone away since it was enumerated.
+    }
+  });
+
+  std::vector<std::uint32_t> pids;
+  pids.reserve(sessions.size());
+  for (const auto &session : sessions) pids.push_back(session.pid);
+  em::make_process_source()->resolve(pids, [&](std::size_t i, std::optional<std::string_view> procName) {
+    if (!valid[i]) return;
+    if (sessions[i].pid == 0) {
+      sessions[i].name = ":system";
+    } else if (procName) {
+      sessions[i].name = *procName;
+    }
+  });
+  return sessions;
+}
+
+/**
+ * Return the volume and mute state of the device and of every current audio
+ * session on it.
+ */
+VolumeSnapshot capture_snapshot(const winrt::com_ptr<IMMDevice> &device,
+                                const winrt::com_ptr<IAudioSessionManager2> &sessionMgr) {
+  VolumeSnapshot snapshot;
+  const auto deviceVolume{em::get_endpoint_volume(device)};
+  BOOL muted{};
+  winrt::check_hresult(deviceVolume->GetMasterVolumeLevelScalar(&snapshot.deviceVolume));
+  winrt::check_hresult(deviceVolume->GetMute(&muted));
+  snapshot.deviceMuted = muted != FALSE;
+
+  for (auto &session : em::collect_snapshot_sessions(sessionMgr, true)) {
+    if (session.name.empty()) continue;
+    snapshot.sessions.push_back(SessionSnapshot{std::move(session.name), session.grouping,
+                                                session.volume, session.muted});
+  }
+  return snapshot;
+}
+
+/**
+ * Put the device and every current audio session found in `snapshot` back to
+ * the volume and mute state captured in it, and return the number of sessions
+ * that were restored.
  *
- * On Windows at least, Boost.Interprocess creates a shared memory mapped file
- * with this name, so it needs to be unique among all other programs that use
- * that directory. Hopefully this one is, but if anybody finds a collision then
- * it can be changed.
- *
- * For consistency reasons, it's important that at most one waiter process is
- * running at a time across all versions of the software. This includes forks!
- * This is guaranteed provided that all versions use the same `RpcQueueName`.
- *
- * If a breaking change to the queue or message format would cause buggy
- * behaviour when a waiter and setter from different versions across that
- * breaking change interact, then it may be better to increase the version
- * number on the queue. This allows those versions to exist independently,
- * preventing any bugs from mismatched queue formats, but violating consistency
- * unless users are careful to not run those two versions simultaneously.
- * Protobuf allows a number of changes without breaking compatibility, so this
- * is unlikely to be necessary.
+ * Sessions are found in the snapshot through a `SnapshotIndex`, and set in
+ * parallel.
  */
-constexpr inline std::string_view RpcQueueName = "em_volume_setter_ipc_queue_v1";
+std::size_t restore_snapshot(const VolumeSnapshot &snapshot,
+                             const winrt::com_ptr<IMMDevice> &device,
+                             const winrt::com_ptr<IAudioSessionManager2> &sessionMgr) {
+  const auto deviceVolume{em::get_endpoint_volume(device)};
+  winrt::check_hresult(deviceVolume->SetMasterVolumeLevelScalar(snapshot.deviceVolume, &em::VolumeSetterEventContext));
+  winrt::check_hresult(deviceVolume->SetMute(snapshot.deviceMuted, &em::VolumeSetterEventContext));
+
+  const auto sessions{em::collect_snapshot_sessions(sessionMgr, false)};
+  const SnapshotIndex index{snapshot};
+  std::atomic<std::size_t> numRestored{0};
+  em::for_each_parallel(sessions.size(), [&](std::size_t i) {
+    const auto &session{sessions[i]};
+    if (session.name.empty()) return;
+    const auto *captured{index.find(session.name, session.grouping)};
+    if (!captured) return;
+
+    try {
+      const auto volume{session.sessionCtrl.as<ISimpleAudioVolume>()};
+      winrt::check_hresult(volume->SetMasterVolume(captured->volume, &em::VolumeSetterEventContext));
+      winrt::check_hresult(volume->SetMute(captured->muted, &em::VolumeSetterEventContext));
+      numRestored.fetch_add(1, std::memory_order_relaxed);
+    } catch (const winrt::hresult_error &) {
+      // As when capturing, the session has probably gone away.
+    }
+  });
+  return numRestored.load();
+}
 
 /**
- * Maximum size of a serialized message in the interprocess queue.
+ * Run the `snapshot` or `restore` subcommand, which saves the volume and mute
+ * state of the device and of every audio session to a file, or puts them back
+ * as they were saved.
  *
- * This sets a limit on the maximum size of the serialized Protobuf messages
- * used to communicate between waiters and setters. Increasing it does not
- * constitute a breaking change.
+ * Sessions are matched back up by the image path of their process and their
+ * grouping parameter, so a snapshot can be restored after the applications in
+ * it have been restarted.
  */
-constexpr inline std::size_t MaxMessageSize = 512ull;
+int run_snapshot(int argc, char *argv[]) {
+  const std::string_view command{argv[0]};
+  const bool restore{command == "restore"};
+
+  argparse::ArgumentParser app(std::format("{} {}", em::ExecutableName, command),
+                               std::string{em::ExecutableVersion});
+  if (restore) {
+    app.add_description("Put the volume of the device and of every program back as it was saved.");
+  } else {
+    app.add_description("Save the volume of the device and of every program, to put back later.");
+  }
+  app.add_argument("--file")
+      .help("path to the snapshot file");
+
+  try {
+    app.parse_args(argc, argv);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << '\n'
+              << app;
+    return 1;
+  }
+
+  std::filesystem::path path;
+  if (auto file{app.present<std::string>("--file")}) {
+    path = std::move(*file);
+  } else {
+    path = em::get_default_snapshot_path();
+    std::filesystem::create_directories(path.parent_path());
+  }
+
+  const auto device{em::get_default_audio_device()};
+  const auto sessionMgr{em::get_audio_session_manager(device)};
+  try {
+    if (restore) {
+      const auto snapshot{em::read_snapshot(path)};
+      const auto numRestored{em::restore_snapshot(snapshot, device, sessionMgr)};
+      std::cout << std::format("Restored the volume of {} sessions from {}\n", numRestored, path.string());
+    } else {
+      const auto snapshot{em::capture_snapshot(device, sessionMgr)};
+      em::write_snapshot(path, snapshot);
+      std::cout << std::format("Saved the volume of {} sessions to {}\n", snapshot.sessions.size(), path.string());
+    }
+  } catch (const em::SnapshotError &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
 
+#ifndef EM_EMBEDDED_PROFILES
 /**
- * Return the path to the config file in which the profiles are defined.
- *
- * If `--config` is passed as a command line argument then its value is used as
- * the path to the config file. Otherwise, `./volume-setter/config.toml` will be
- * used relative to the directory returned by `local_app_data()`.
+ * Run the `check` subcommand, which reports the controls of a config file that
+ * can never take effect and are removed when the profiles are read.
  */
-std::filesystem::path get_config_path(const argparse::ArgumentParser &app) {
-  if (auto configPath{app.present<std::string>("--config")}) {
-    return *configPath;
+int run_check(int argc, char *argv[]) {
+  argparse::ArgumentParser app(std::format("{} check", em::ExecutableName),
+                               std::string{em::ExecutableVersion});
+  app.add_description("Report the entries of the config file that can never take effect.");
+  app.add_argument("--config")
+      .help("path to the configuration file");
+
+  try {
+    app.parse_args(argc, argv);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << '\n'
+              << app;
+    return 1;
   }
 
-  return em::get_default_config_path();
+  const auto configPath{em::get_config_path(app)};
+  std::vector<em::DeadControl> dead;
+  try {
+    em::parse_profiles_toml(configPath, std::pmr::get_default_resource(), &dead);
+  } catch (const em::ProfileError &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+
+  if (dead.empty()) {
+    std::cout << "Every entry of " << configPath.string() << " can take effect\n";
+    return 0;
+  }
+  for (const auto &control : dead) {
+    const auto key{em::match_kind_name(control.kind)};
+    if (control.key == control.winner) {
+      std::cout << std::format("[{}] {} = \"{}\" is repeated later in the profile, which wins\n",
+                               control.profile, key, control.key);
+    } else {
+      std::cout << std::format("[{}] {} = \"{}\" is covered by {} = \"{}\" later in the profile, which wins\n",
+                               control.profile, key, control.key, key, control.winner);
+    }
+  }
+  std::cout << std::format("{} entries of {} can never take effect\n", dead.size(), configPath.string());
+  return 0;
 }
+#endif
 
 /**
- * Set the volume of an audio session.
- *
- * Unlike `set_named_session_volume` this does not need a process name and will
- * also work with the system audio session.
+ * Phases of switching profile timed by `bench-switch`.
  */
-void set_session_volume(const VolumeProfile &profile,
-                        const winrt::com_ptr<IAudioSessionControl> &sessionCtrl) {
-  const auto sessionCtrl2{sessionCtrl.as<IAudioSessionControl2>()};
+enum class SwitchPhase : std::size_t {
+  Parse,
+  Device,
+  Enumerate,
+  Resolve,
+  Match,
+  Write,
+  Total,
+};
 
-  // To get reliable name information about the session we need the PID of
-  // the process managing it. There is `IAudioSessionControl::GetDisplayName`,
-  // but it's up to the application to set that and many do not. `sndvol` has
-  // to create a fallback in that case, we opt to instead match the executable
-  // path.
+constexpr std::array<std::string_view, 7> SwitchPhaseNames{
+    "parse", "device", "enumerate", "resolve", "match", "write", "total"};
 
-  // For the system process we can't get executable path from the PID, but
-  // we can still get the PID, which is zero. We actually can use
-  // `GetDisplayName` in this case, because the system process sets it,
-  // but rather than trying to match on that or relying on the PID we can
-  // instead use `IAudioSessionControl2::IsSystemSoundsSession`, which sounds
-  // much more reliable.
-  if (sessionCtrl2->IsSystemSoundsSession() == S_OK) {
-    if (const auto v{em::set_system_sound_volume(profile, sessionCtrl)}) {
-      std::cout << "Set volume of system sounds to " << *v << '\n';
-    }
-    return;
+/**
+ * Times taken by each phase of every switch made by `bench-switch`.
+ */
+class SwitchTimings {
+public:
+  void record(SwitchPhase phase, std::chrono::nanoseconds duration) {
+    mSamples[static_cast<std::size_t>(phase)].push_back(duration);
   }
 
-  const auto pid{em::get_process_id(sessionCtrl2)};
-  // PID should be nonzero since we've already handled the system sounds.
-  const auto procHnd{em::open_process(pid)};
-  const auto procName{em::get_process_image_name(procHnd)};
-  if (const auto v{em::set_named_session_volume(profile, procName, sessionCtrl)}) {
-    std::cout << "Set volume of " << procName << " to " << *v << '\n';
+  /**
+   * Print the 50th, 95th and 99th percentiles of each phase that was timed.
+   */
+  void print() {
+    std::cout << std::format("{:<10} {:>10} {:>10} {:>10}\n", "phase", "p50 (us)", "p95 (us)", "p99 (us)");
+    for (std::size_t i{0}; i < mSamples.size(); ++i) {
+      auto &samples{mSamples[i]};
+      if (samples.empty()) continue;
+      std::ranges::sort(samples);
+      const auto at{[&samples](double p) {
+        const auto rank{static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1) + 0.5)};
+        return std::chrono::duration<double, std::micro>{samples[rank]}.count();
+      }};
+      std::cout << std::format("{:<10} {:>10.1f} {:>10.1f} {:>10.1f}\n", SwitchPhaseNames[i],
+                               at(0.50), at(0.95), at(0.99));
+    }
   }
-}
+
+private:
+  std::array<std::vector<std::chrono::nanoseconds>, SwitchPhaseNames.size()> mSamples;
+};
 
 /**
- * Holder for an interprocess queue that, if it creates a queue, takes ownership
- * of it and removes it on destruction.
+ * Processes of a simulated audio stack, each of which has the image path at
+ * its position in a list, with the PID one more than that position.
+ *
+ * The processes never start or stop, so there is nothing to watch.
  */
-class QueueHolder {
+class SimulatedProcessSource final : public ProcessSource {
 public:
-  template<class Mode, class... Args>
-  explicit QueueHolder(Mode m, const char *name, Args &&...args)
-      : queue{m, name, std::forward<Args>(args)...},
-        mQueueName{name},
-        mHasOwnership{std::is_same_v<Mode, ipc::create_only_t>} {};
+  explicit SimulatedProcessSource(const std::vector<std::string> &names) : mNames{names} {}
 
-  ~QueueHolder() {
-    if (mHasOwnership) ipc::message_queue::remove(mQueueName.c_str());
+  void snapshot(ProcessObserver &observer) override {
+    for (std::size_t i{0}; i < mNames.size(); ++i) {
+      observer.process_started(static_cast<std::uint32_t>(i + 1), 0, mNames[i]);
+    }
   }
 
-  ipc::message_queue queue;
+  std::optional<std::string> image_path(std::uint32_t pid) override {
+    if (pid == 0 || pid > mNames.size()) return std::nullopt;
+    return mNames[pid - 1];
+  }
+
+  std::optional<std::uint32_t> parent_pid(std::uint32_t) override { return std::nullopt; }
+
+  void watch(ProcessObserver &) override {}
 
 private:
-  std::string mQueueName;
-  bool mHasOwnership;
+  const std::vector<std::string> &mNames;
 };
 
 /**
- * Implementation of the `declvol` service managing an active volume profile.
+ * Sessions of a simulated audio stack, standing in for the real one so that
+ * switching can be benchmarked the same way on any machine.
  *
- * This service only manages which profile is currently active, it does not
- * change the volume of any sessions itself. The volume of any sessions opened
- * after the service has started should be set by the session handler, and the
- * volume of any sessions that are already open should be set by the client
- * notifying the service of the profile change.
+ * The sessions belong to executables that the controls of the benchmarked
+ * profiles match, with every `UnmatchedEvery`th matching nothing. Each session
+ * has a process of its own, which is resolved through a `ProcessIndex` of a
+ * `SimulatedProcessSource`, as a waiter resolves the real ones.
  */
-class DeclvolService {
+class SimulatedSessions {
 public:
-  explicit DeclvolService(ipc::message_queue &channel, VolumeProfile profile)
-      : mChannel{channel}, mActiveProfile{std::move(profile)} {}
+  static constexpr std::size_t UnmatchedEvery{4};
 
-  /**
-   * Change the active profile used by the service to the one described by the
-   * Protobuf message.
-   */
-  void switch_profile(const declvol::v1::SwitchProfileRequest *request) {
-    load_profile(request->config_path(), request->profile());
-    std::cout << "Switched profile to " << request->profile() << std::endl;
+  SimulatedSessions(std::size_t numSessions, const VolumeProfile &first, const VolumeProfile &second)
+      : mNames{simulated_names(numSessions, first, second)},
+        mProcesses{std::make_unique<SimulatedProcessSource>(mNames), false} {
+    mVolumes.resize(numSessions);
   }
 
   /**
-   * Pull requests from the interprocess queue and run them until `shutdown`
-   * has been called.
-   *
-   * Once `shutdown` is called there may be a delay of up to a second until
-   * this function returns. This is because, unlike some concurrent queues,
-   * Boost.Interprocess's message queue does not have any way of closing it and
-   * waking receivers. Pulling until the queue is closed therefore involves
-   * either sending an in-band shutdown message to the queue, or receiving with
-   * a timeout and polling an out-of-band signal in between.
-   *
-   * Since an in-band approach requires checking the type of the serialized
-   * message, and implementing a new Protobuf for essentially an implementation
-   * detail, this function polls.
+   * Apply `profile` to the simulated device and sessions, timing each phase as
+   * `apply_profile` times the real ones.
    */
-  void wait() {
-    constexpr auto pollInterval = std::chrono::seconds{1};
-    std::array<std::byte, em::MaxMessageSize> buf{};
+  void apply(const VolumeProfile &profile, SwitchTimings &timings) {
+    using Clock = std::chrono::steady_clock;
+    auto start{Clock::now()};
+    const auto next{[&start] {
+      const auto now{Clock::now()};
+      return now - std::exchange(start, now);
+    }};
 
-    do {
-      std::size_t size{};
-      unsigned int priority{};
-      const auto deadline{std::chrono::steady_clock::now() + pollInterval};
-      if (!mChannel.timed_receive(buf.data(), buf.size(), size, priority, deadline)) {
-        continue;
-      }
+    if (const auto *control{em::find_control(profile, ":device")}) mDeviceVolume = control->relative_volume();
+    timings.record(SwitchPhase::Device, next());
 
-      ::declvol::v1::SwitchProfileRequest request;
-      if (!request.ParseFromArray(buf.data(), static_cast<int>(size))) {
-        std::cerr << "Received invalid SwitchProfileRequest\n";
-        continue;
-      }
-      switch_profile(&request);
-    } while (!mCloseFlag.test());
-  }
+    // Stands in for walking the session enumerator, and like collecting the
+    // sessions in `apply_profile` includes building the index.
+    const ControlIndex index{profile};
+    std::vector<std::uint32_t> pids(mNames.size());
+    std::iota(pids.begin(), pids.end(), std::uint32_t{1});
+    timings.record(SwitchPhase::Enumerate, next());
 
-  /**
-   * Close the queue so that any call to `wait` on the queue returns.
-   *
-   * Once the queue has been closed it cannot be reopened.
-   */
-  void shutdown() {
-    mCloseFlag.test_and_set();
-    mCloseFlag.notify_all();
-  }
+    std::vector<std::optional<std::string>> paths(pids.size());
+    em::ScratchArena<em::SessionArenaSize> scratch;
+    for (std::size_t i{0}; i < pids.size(); ++i) {
+      if (const auto path{mProcesses.image_path(pids[i], scratch.resource())}) paths[i].emplace(*path);
+      scratch.reset();
+    }
+    timings.record(SwitchPhase::Resolve, next());
 
-  /**
-   * Return a copy of the currently active profile.
-   *
-   * This function is thread-safe.
-   *
-   * This function returns a copy to avoid concurrency issues where the profile
-   * could be modified while the profile is being changed. This is not the most
-   * efficient way to do it, but it's simple and sufficient.
-   */
-  em::VolumeProfile get_active_profile() const {
-    std::lock_guard lock{mMut};
-    return mActiveProfile;
+    // Only image paths are simulated, so nothing matches other fields.
+    const auto noFields{[](MatchKind) { return std::optional<std::string>{}; }};
+    std::vector<const VolumeControl *> controls(pids.size());
+    for (std::size_t i{0}; i < pids.size(); ++i) {
+      if (!paths[i]) continue;
+      const auto *control{em::match_control(profile, *paths[i])};
+      control = em::match_ancestors(index, control, pids[i], &mProcesses);
+      controls[i] = index.match(control, noFields);
+    }
+    timings.record(SwitchPhase::Match, next());
+
+    for (std::size_t i{0}; i < controls.size(); ++i) {
+      if (controls[i]) mVolumes[i] = controls[i]->relative_volume();
+    }
+    timings.record(SwitchPhase::Write, next());
   }
 
-  /**
-   * Load a volume profile from a config file and set it to the currently
-   * active profile.
-   *
-   * This function is thread-safe.
-   *
-   * Because the service only manages which profile is currently active, this
-   * function does not change the volume of any sessions. Any session opened
-   * after this call will have its volume set correctly by the session handler,
-   * and any existing sessions should be set by the client.
-   */
-  void load_profile(const std::filesystem::path &configPath,
-                    const std::string &profileName) {
-    const auto profiles{em::parse_profiles_toml(configPath)};
-    const auto activeProfileIt{profiles.find(profileName)};
-    if (activeProfileIt == profiles.end()) {
-      throw em::ProfileError(configPath,
-                             std::format("Profile {} does not exist", profileName));
+private:
+  static std::vector<std::string> simulated_names(std::size_t numSessions, const VolumeProfile &first,
+                                                  const VolumeProfile &second) {
+    std::vector<std::string_view> suffixes;
+    for (const auto *profile : {&first, &second}) {
+      for (const auto &control : profile->controls) {
+        if (control.kind() == MatchKind::Suffix && !control.suffix().starts_with(':')) {
+          suffixes.push_back(control.suffix());
+        }
+      }
     }
 
-    {
-      std::lock_guard lock{mMut};
-      mActiveProfile = activeProfileIt->second;
+    std::vector<std::string> names;
+    names.reserve(numSessions);
+    for (std::size_t i{0}; i < numSessions; ++i) {
+      if (suffixes.empty() || i % UnmatchedEvery == UnmatchedEvery - 1) {
+        names.push_back(std::format("C:\\Program Files\\Simulated\\app{}.exe", i));
+      } else {
+        names.push_back(std::format("C:\\Program Files\\Simulated{}\\{}", i, suffixes[i % suffixes.size()]));
+      }
     }
+    return names;
   }
 
-private:
-  ipc::message_queue &mChannel;
-  mutable std::mutex mMut;
-  em::VolumeProfile mActiveProfile;
-  std::atomic_flag mCloseFlag;
+  std::vector<std::string> mNames;
+  // Declared after the names, which its source reads.
+  ProcessIndex mProcesses;
+  std::vector<float> mVolumes;
+  float mDeviceVolume{};
 };
 
 /**
- * Client class to interact with the `declvol` service.
+ * Run the `bench-switch` subcommand, which switches between two profiles many
+ * times and reports how long each phase of switching took.
+ *
+ * Each switch does everything a setter does: reading the profile, finding the
+ * device, enumerating and resolving the sessions, matching them and setting
+ * their volumes. With `--simulate` the audio stack is replaced by
+ * `SimulatedSessions`, so only reading, resolving through a process index and
+ * matching are real.
  */
-class DeclvolClient final {
-public:
-  explicit DeclvolClient(ipc::message_queue &channel) : mChannel{channel} {}
+int run_bench_switch(int argc, char *argv[]) {
+  argparse::ArgumentParser app(std::format("{} bench-switch", em::ExecutableName),
+                               std::string{em::ExecutableVersion});
+  app.add_description("Switch between two profiles repeatedly and report how long switching takes.");
+  app.add_argument("first")
+      .help("name of the first profile to switch to")
+      .required();
+  app.add_argument("second")
+      .help("name of the second profile to switch to")
+      .required();
+#ifndef EM_EMBEDDED_PROFILES
+  app.add_argument("--config")
+      .help("path to the configuration file");
+#endif
+  app.add_argument("--iterations")
+      .help("number of switches to make")
+      .default_value(100)
+      .scan<'i', int>();
+  app.add_argument("--simulate")
+      .help("switch a simulated audio stack with this many sessions, instead of the real one")
+      .scan<'i', int>();
 
-  /**
-   * Notify the connected waiter process that the active profile has changed
-   * so that it can correctly set the volume of future audio sessions.
-   *
-   * The waiter service does not set the volume of any existing sessions, so
-   * the intention is that client's will change the volume of all existing
-   * processes and also issue this notification to the service.
-   */
-  void switch_profile(const std::filesystem::path &configPath,
-                      const std::string &profileName) {
-    declvol::v1::SwitchProfileRequest req;
-    req.set_profile(profileName);
-    req.set_config_path(configPath.string());
+  try {
+    app.parse_args(argc, argv);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << '\n'
+              << app;
+    return 1;
+  }
 
-    const auto buf{req.SerializeAsString()};
-    if (!mChannel.try_send(buf.data(), buf.size(), 0)) {
-      throw std::runtime_error("Cannot notify waiter that active profile is changed, too many requests in queue.");
+  const auto iterations{app.get<int>("--iterations")};
+  const auto simulate{app.present<int>("--simulate")};
+  if (iterations <= 0 || (simulate && *simulate < 0)) {
+    std::cerr << "--iterations must be positive and --simulate must not be negative\n"
+              << app;
+    return 1;
+  }
+
+  const std::array profileNames{app.get<std::string>("first"), app.get<std::string>("second")};
+#ifdef EM_EMBEDDED_PROFILES
+  const std::filesystem::path configPath{};
+#else
+  const auto configPath{em::get_config_path(app)};
+#endif
+
+  using Clock = std::chrono::steady_clock;
+  SwitchTimings timings;
+  std::optional<SimulatedSessions> simulated;
+  if (simulate) {
+    simulated.emplace(static_cast<std::size_t>(*simulate), *em::read_profile(configPath, profileNames[0]),
+                      *em::read_profile(configPath, profileNames[1]));
+  }
+  // Fades are left to run in the background, as they would be by a waiter.
+  em::RampScheduler ramps;
+  em::Logger logger{em::LogLevel::Warning};
+  const em::ApplyContext ctx{ramps, logger};
+
+  for (int i{0}; i < iterations; ++i) {
+    const auto start{Clock::now()};
+    const auto profile{em::read_profile(configPath, profileNames[static_cast<std::size_t>(i % 2)])};
+    const auto parsed{Clock::now()};
+    timings.record(SwitchPhase::Parse, parsed - start);
+
+    if (simulated) {
+      simulated->apply(*profile, timings);
+    } else {
+      const auto device{em::get_default_audio_device()};
+      const auto sessionMgr{em::get_audio_session_manager(device)};
+      timings.record(SwitchPhase::Device, Clock::now() - parsed);
+
+      const auto report{em::apply_profile(*profile, device, sessionMgr, ctx)};
+      timings.record(SwitchPhase::Enumerate, report.timings.collect);
+      timings.record(SwitchPhase::Resolve, report.timings.resolve);
+      timings.record(SwitchPhase::Match, report.timings.plan);
+      timings.record(SwitchPhase::Write, report.timings.apply);
     }
+    timings.record(SwitchPhase::Total, Clock::now() - start);
   }
 
-private:
-  ipc::message_queue &mChannel;
-};
+  std::cout << std::format("{} switches between {} and {} on {}\n", iterations, profileNames[0], profileNames[1],
+                           simulated ? std::format("{} simulated sessions", *simulate)
+                                     : std::string{"the default audio device"});
+  timings.print();
+  ramps.wait_idle();
+  logger.flush();
+  return 0;
+}
 
 }// namespace
 }// namespace em
 
 int main(int argc, char *argv[]) try {
+  // Subcommands are dispatched by hand because the profile is a positional
+  // argument, which argparse cannot combine with subparsers.
+  if (argc > 1 && std::string_view{argv[1]} == "stats") {
+    return em::run_stats(argc - 1, argv + 1);
+  }
+  if (argc > 1 && (std::string_view{argv[1]} == "push" || std::string_view{argv[1]} == "pop")) {
+    return em::run_layer(argc - 1, argv + 1);
+  }
+  if (argc > 1 && (std::string_view{argv[1]} == "snapshot" || std::string_view{argv[1]} == "restore")) {
+    winrt::init_apartment();
+    return em::run_snapshot(argc - 1, argv + 1);
+  }
+  if (argc > 1 && std::string_view{argv[1]} == "set") {
+    return em::run_set(argc - 1, argv + 1);
+  }
+  if (argc > 1 && std::string_view{argv[1]} == "bench-switch") {
+    winrt::init_apartment();
+    return em::run_bench_switch(argc - 1, argv + 1);
+  }
+#ifndef EM_EMBEDDED_PROFILES
+  if (argc > 1 && std::string_view{argv[1]} == "check") {
+    return em::run_check(argc - 1, argv + 1);
+  }
+#endif
+
   winrt::init_apartment();
 
   argparse::ArgumentParser app(std::string{em::ExecutableName},
@@ -292,12 +2863,30 @@ int main(int argc, char *argv[]) try {
   app.add_argument("profile")
       .help("name of the profile to make active")
       .required();
+#ifndef EM_EMBEDDED_PROFILES
   app.add_argument("--config")
       .help("path to the configuration file");
+#endif
   app.add_argument("--wait")
       .implicit_value(true)
       .default_value(false)
       .help("keep running and modify the volume of programs when they start.");
+  app.add_argument("--enforce")
+      .implicit_value(true)
+      .default_value(false)
+      .help("with --wait, put back the volume of programs that change their own volume.");
+  app.add_argument("--trace")
+      .help("with --wait, record sessions and profile requests to this file for replay_trace.");
+  app.add_argument("--plan")
+      .implicit_value(true)
+      .default_value(false)
+      .help("print the changes that would be made as JSON, without making them.");
+  app.add_argument("--quiet")
+      .implicit_value(true)
+      .default_value(false)
+      .help("only log warnings and errors.");
+  app.add_argument("--log-file")
+      .help("append log lines to this file instead of printing them.");
 
   try {
     app.parse_args(argc, argv);
@@ -307,20 +2896,72 @@ int main(int argc, char *argv[]) try {
     return 1;
   }
 
-  const auto configPath{em::get_config_path(app)};
-  const auto profiles{em::parse_profiles_toml(configPath)};
+  if (app.get<bool>("--enforce") && !app.get<bool>("--wait")) {
+    std::cerr << "--enforce can only be used with --wait\n"
+              << app;
+    return 1;
+  }
+  if (app.present<std::string>("--trace") && !app.get<bool>("--wait")) {
+    std::cerr << "--trace can only be used with --wait\n"
+              << app;
+    return 1;
+  }
+
+  // Log lines are written from a background thread, so that a slow console or
+  // file never holds up setting volumes.
+  const auto minLogLevel{app.get<bool>("--quiet") ? em::LogLevel::Warning : em::LogLevel::Info};
+  std::unique_ptr<em::Logger> logger;
+  try {
+    if (const auto logPath{app.present<std::string>("--log-file")}) {
+      logger = std::make_unique<em::Logger>(std::filesystem::path{*logPath}, minLogLevel);
+    } else {
+      logger = std::make_unique<em::Logger>(minLogLevel);
+    }
+  } catch (const em::LogError &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+
   const auto activeProfileName{app.get<std::string>("profile")};
-  const auto activeProfileIt{profiles.find(activeProfileName)};
+#ifdef EM_EMBEDDED_PROFILES
+  // The profiles are compiled into the executable, so resolving the profile
+  // involves no file I/O or parsing, and converting it into the arena does
+  // not allocate. What matching builds from it afterwards, such as the match
+  // memo and control index, is still allocated as for a parsed profile.
+  const std::filesystem::path configPath{};
+  const auto *embeddedProfile{em::find_embedded_profile(em::embedded::Profiles, activeProfileName)};
+  if (!embeddedProfile) {
+    std::cerr << "[error] Profile " << activeProfileName << " does not exist\n";
+    return 1;
+  }
+  em::ScratchArena<em::EmbeddedProfileArenaSize> profileArena;
+  const auto profile{em::to_volume_profile(*embeddedProfile, profileArena.resource())};
+#else
+  const auto configPath{em::get_config_path(app)};
+  std::pmr::monotonic_buffer_resource profileArena;
+  const auto profiles{em::parse_profiles_toml(configPath, &profileArena)};
+  const auto activeProfileIt{profiles.find(std::string_view{activeProfileName})};
   if (activeProfileIt == profiles.end()) {
     std::cerr << "[error] Profile " << activeProfileName << " in "
               << configPath.string() << " does not exist\n";
     return 1;
   }
   const auto &profile{activeProfileIt->second};
+#endif
 
   const auto device{em::get_default_audio_device()};
   const auto sessionMgr{em::get_audio_session_manager(device)};
 
+  if (app.get<bool>("--plan")) {
+    // Nothing is applied, so there is nothing to fade and no waiter to notify.
+    em::RampScheduler ramps;
+    const em::ApplyContext ctx{ramps, *logger};
+    std::vector<em::PlannedChange> plan;
+    const auto report{em::apply_profile(profile, device, sessionMgr, ctx, &plan, /*dryRun=*/true)};
+    em::print_plan(activeProfileName, plan, report);
+    return 0;
+  }
+
   // A waiter cannot be launched without an active profile, because it would not
   // be able to set volumes. If it didn't also set volumes of existing processes
   // on startup, then the volume state would not match the profile. Therefore,
@@ -333,8 +2974,13 @@ int main(int argc, char *argv[]) try {
   // waiter is already running.
 
   std::unique_ptr<em::QueueHolder> queueHolder;
+  // Everything a waiter reacts to, other than setters' requests arriving on
+  // the queue, is handled on this thread by the loop.
+  std::unique_ptr<em::EventLoop> loop;
   std::unique_ptr<em::DeclvolService> service;
   std::future<void> serviceSignal;
+  // Waiters started with `--trace` record what they react to here.
+  std::unique_ptr<em::TraceWriter> trace;
 
   if (app.get<bool>("--wait")) {
     // Note: for consistency reasons one might want to delete the queue first,
@@ -347,14 +2993,14 @@ int main(int argc, char *argv[]) try {
 
     try {
       queueHolder = std::make_unique<em::QueueHolder>(
-          ipc::create_only, em::RpcQueueName.data(), 1ull, em::MaxMessageSize);
+          ipc::create_only, em::RpcQueueName.data(), em::RpcQueueCapacity, em::MaxMessageSize);
     } catch (const ipc::interprocess_exception &) {
       std::cerr << "A waiter process is already running\n";
       // The QueueHolder will take care of properly removing the queue if this
       // process exits while running destructors. That's most of the time, but
-      // the user could forcefully terminate the process with Ctrl-C or through
-      // Task Manager. In that case the queue will not be removed and no waiter
-      // will be able to start until the computer is restarted. Since generally
+      // the user could forcefully terminate the process through Task Manager.
+      // In that case the queue will not be removed and no waiter will be able
+      // to start until the computer is restarted. Since generally
       // providing an ability to delete the queue makes it seem like that's a
       // good idea, I don't want any kind of 'recovery' command line option.
       // Instead, prompt to delete the queue when it looks like another waiter
@@ -370,7 +3016,24 @@ int main(int argc, char *argv[]) try {
       return 1;
     }
 
-    service = std::make_unique<em::DeclvolService>(queueHolder->queue, profile);
+    if (const auto tracePath{app.present<std::string>("--trace")}) {
+      try {
+        trace = std::make_unique<em::TraceWriter>(std::filesystem::path{*tracePath});
+      } catch (const em::TraceError &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+      }
+      // The trace starts from the profile the waiter was started with, as if
+      // it had been requested.
+      trace->request(em::wire::Operation::Replace, configPath.string(), activeProfileName);
+    }
+
+    loop = em::make_event_loop();
+    service = std::make_unique<em::DeclvolService>(queueHolder->queue, *loop, *logger, profile,
+                                                   configPath, activeProfileName);
+    service->set_trace(trace.get());
+    // Requests are only posted to the loop from here, they are not run until
+    // the loop runs.
     serviceSignal = std::async(std::launch::async, [svc = service.get()] {
       svc->wait();
     });
@@ -387,38 +3050,79 @@ int main(int argc, char *argv[]) try {
   // safe to set volumes. Only a proper setter must try to notify a waiter of
   // the active profile change.
 
-  if (const auto v{em::set_device_volume(profile, device)}) {
-    std::cout << "Set volume of device to " << *v << '\n';
+  // Controls with a fade are ramped to their volume in the background.
+  em::RampScheduler ramps;
+  // Waiters remember the sessions they have seen so that edits to the config
+  // file can be applied to them.
+  em::SessionRegistry registry;
+  // Waiters keep an index of running processes so that handling a new session
+  // does not have to query its process.
+  std::unique_ptr<em::ProcessIndex> processIndex;
+  if (service) processIndex = std::make_unique<em::ProcessIndex>(em::make_process_source());
+  // Enforcing waiters watch every session they set for its volume changing.
+  std::unique_ptr<em::VolumeEnforcer> enforcer;
+  if (service && app.get<bool>("--enforce")) {
+    enforcer = std::make_unique<em::VolumeEnforcer>(*service, *loop, ramps, processIndex.get(), *logger);
   }
+  std::unique_ptr<em::SessionTracer> tracer;
+  if (trace) tracer = std::make_unique<em::SessionTracer>(*trace, *logger);
+  const em::ApplyContext ctx{ramps,
+                            *logger,
+                            service ? &registry : nullptr,
+                            service ? &service->stats() : nullptr,
+                            processIndex.get(),
+                            enforcer.get(),
+                            tracer.get()};
 
-  for (const auto &sessionCtrl : em::get_audio_sessions(sessionMgr)) {
-    em::set_session_volume(profile, sessionCtrl);
-  }
+  em::apply_profile(profile, device, sessionMgr, ctx);
 
   if (service) {
+    em::SessionWorker worker{*service, ctx, *loop};
+#ifndef EM_EMBEDDED_PROFILES
+    em::ConfigWatcher configWatcher{*loop, *service, registry, device, ramps, processIndex.get(), *logger};
+#endif
+    service->set_change_handler([&](const em::DeclvolService::ProfileChange &change, bool apply) {
+      // Setters set existing sessions themselves when switching profile, but
+      // layers and overrides are only known to the waiter.
+      if (apply) {
+        const auto numChanged{em::apply_profile_change(change, registry, device, ramps, processIndex.get())};
+        logger->info("Changed volume of {} sessions", numChanged);
+      }
+#ifndef EM_EMBEDDED_PROFILES
+      configWatcher.follow(service->config_paths());
+#endif
+    });
     const auto eventHandle{em::register_session_notification(
         sessionMgr,
-        [svc = service.get()](const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl) {
-          em::set_session_volume(svc->get_active_profile(), sessionCtrl);
-          std::flush(std::cout);
+        [&worker](const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl) {
+          worker.post(sessionCtrl);
           return S_OK;
         })};
+    const em::ExitWatcher exitWatcher{*loop};
 
-    // Wait on stdin.
-    std::cout << em::ExecutableName << " will now set the volume of launched processes, press enter to stop." << std::endl;
-    std::cin.get();
+    logger->info("{} will now set the volume of launched processes, press enter to stop.", em::ExecutableName);
+    loop->run();
 
     service->shutdown();
+    serviceSignal.wait();
     em::unregister_session_notification(sessionMgr, eventHandle);
+    // The console may be closing, in which case the process is terminated
+    // soon after the exit watcher is destroyed, so the queue is removed and
+    // the log written out first.
+    queueHolder.reset();
+    if (trace) trace->flush();
+    logger->flush();
     return 0;
   }
 
   if (queueHolder) {
     em::DeclvolClient client(queueHolder->queue);
     client.switch_profile(configPath, activeProfileName);
-    return 0;
   }
 
+  // Stay alive until any fades have finished, otherwise they would stop
+  // partway through.
+  ramps.wait_idle();
   return 0;
 } catch (const em::ProfileError &e) {
   std::cerr << e.what() << '\n';
@@ -0,0 +1,103 @@
+#include "declvol/log.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+
+namespace em {
+namespace {
+
+constexpr std::string_view level_name(LogLevel level) {
+  switch (level) {
+  case LogLevel::Info: return "info";
+  case LogLevel::Warning: return "warning";
+  case LogLevel::Error: return "error";
+  }
+  return "unknown";
+}
+
+}// namespace
+
+Logger::Logger(LogLevel minLevel)
+    : mMinLevel{minLevel},
+      mLines{std::make_unique<BoundedQueue<Line, Capacity>>()},
+      mThread{[this](std::stop_token stop) { run(stop); }} {}
+
+Logger::Logger(const std::filesystem::path &path, LogLevel minLevel)
+    : mMinLevel{minLevel},
+      mFile{path, std::ios::app},
+      mLines{std::make_unique<BoundedQueue<Line, Capacity>>()} {
+  if (!mFile) throw LogError(std::format("Cannot open log file {}", path.string()));
+  // Only start writing once the file is known to be usable.
+  mThread = std::jthread{[this](std::stop_token stop) { run(stop); }};
+}
+
+Logger::~Logger() {
+  mThread.request_stop();
+  mPending.release();
+}
+
+void Logger::flush() {
+  const auto pushed{mPushed.load(std::memory_order_acquire)};
+  for (auto written{mWritten.load(std::memory_order_acquire)}; written < pushed;
+       written = mWritten.load(std::memory_order_acquire)) {
+    mWritten.wait(written, std::memory_order_acquire);
+  }
+}
+
+void Logger::push(const Line &line) {
+  if (!mLines->try_push(line)) {
+    mDropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  mPushed.fetch_add(1, std::memory_order_release);
+  mPending.release();
+}
+
+void Logger::run(std::stop_token stop) {
+  std::uint64_t reportedDropped{0};
+  for (;;) {
+    mPending.acquire();
+    while (auto line{mLines->try_pop()}) {
+      write(*line);
+      mWritten.fetch_add(1, std::memory_order_release);
+    }
+
+    if (const auto dropped{mDropped.load(std::memory_order_relaxed)}; dropped != reportedDropped) {
+      Line line{LogLevel::Warning, std::chrono::system_clock::now(), 0, {}};
+      const auto result{std::format_to_n(line.text.data(), static_cast<std::ptrdiff_t>(line.text.size()),
+                                         "{} log lines were dropped because output could not keep up",
+                                         dropped - reportedDropped)};
+      line.size = static_cast<std::uint32_t>(
+          std::min(static_cast<std::size_t>(result.size), line.text.size()));
+      write(line);
+      reportedDropped = dropped;
+    }
+
+    if (mFile.is_open()) {
+      mFile.flush();
+    } else {
+      std::cout.flush();
+      std::cerr.flush();
+    }
+    mWritten.notify_all();
+
+    // The queue was drained after the stop was requested, so nothing is lost.
+    if (stop.stop_requested()) break;
+  }
+}
+
+void Logger::write(const Line &line) {
+  const std::string_view text{line.text.data(), line.size};
+  if (mFile.is_open()) {
+    mFile << std::format("{:%F %T} [{}] {}\n",
+                         std::chrono::floor<std::chrono::milliseconds>(line.time),
+                         em::level_name(line.level), text);
+    return;
+  }
+
+  auto &out{line.level == LogLevel::Info ? std::cout : std::cerr};
+  out << text << '\n';
+}
+
+}// namespace em
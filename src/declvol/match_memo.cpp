@@ -0,0 +1,26 @@
+#include "declvol/match_memo.h"
+
+#include <functional>
+
+namespace em {
+
+const VolumeControl *MatchMemo::match(std::string_view name, bool *hit) {
+  auto &entry{mEntries[std::hash<std::string_view>{}(name) % Capacity]};
+
+  std::lock_guard lock{mMut};
+  if (entry.used && entry.name == name) {
+    if (hit) *hit = true;
+    return entry.control;
+  }
+
+  if (hit) *hit = false;
+  const auto *control{em::match_control(*mProfile, name)};
+  // Assigning reuses the entry's storage, so once the table is warm replacing
+  // an entry rarely allocates.
+  entry.name.assign(name);
+  entry.control = control;
+  entry.used = true;
+  return control;
+}
+
+}// namespace em
@@ -1,12 +1,32 @@
 #include "declvol/process.h"
 
+#include <winternl.h>
+
+#include <array>
+
 namespace em {
+namespace {
+
+/**
+ * Input and output of `NtQuerySystemInformation` for
+ * `SystemProcessIdInformation`, which the SDK leaves out.
+ */
+struct SystemProcessIdInformation {
+  HANDLE processId;
+  UNICODE_STRING imageName;
+};
+
+constexpr auto SystemProcessIdInformationClass{static_cast<SYSTEM_INFORMATION_CLASS>(88)};
+constexpr auto StatusInfoLengthMismatch{static_cast<NTSTATUS>(0xC0000004L)};
 
-std::string get_process_image_name(const winrt::handle &processHandle) {
+}// namespace
+
+std::pmr::string get_process_image_name(const winrt::handle &processHandle,
+                                        std::pmr::memory_resource *resource) {
   constexpr DWORD PROCESS_NAME_WIN32{0};
 
   // MAX_PATH includes the null-terminator
-  std::string procName(MAX_PATH - 1, '\0');
+  std::pmr::string procName(MAX_PATH - 1, '\0', resource);
   auto procNameSize{static_cast<DWORD>(procName.size())};
   winrt::check_bool(::QueryFullProcessImageNameA(
       processHandle.get(), PROCESS_NAME_WIN32, procName.data(), &procNameSize));
@@ -15,6 +35,15 @@ std::string get_process_image_name(const winrt::handle &processHandle) {
   return procName;
 }
 
+DWORD get_parent_process_id(const winrt::handle &processHandle) {
+  PROCESS_BASIC_INFORMATION info{};
+  const auto status{::NtQueryInformationProcess(processHandle.get(), ProcessBasicInformation,
+                                                &info, sizeof(info), nullptr)};
+  if (status < 0) winrt::throw_hresult(HRESULT_FROM_NT(status));
+  // The SDK leaves the field holding the PID of the parent unnamed.
+  return static_cast<DWORD>(reinterpret_cast<ULONG_PTR>(info.Reserved3));
+}
+
 winrt::handle open_process(DWORD pid) {
   winrt::handle hnd{::OpenProcess(
       PROCESS_QUERY_LIMITED_INFORMATION, /*bInheritHandle=*/false, pid)};
@@ -22,4 +51,56 @@ winrt::handle open_process(DWORD pid) {
   return hnd;
 }
 
+DosDeviceMap::DosDeviceMap() {
+  std::array<wchar_t, 4 * 26 + 1> drives{};
+  const auto size{::GetLogicalDriveStringsW(static_cast<DWORD>(drives.size()), drives.data())};
+  if (size == 0 || size > drives.size()) return;
+
+  // Each drive is given as `C:\`, and its device is looked up without the
+  // trailing separator.
+  std::array<wchar_t, MAX_PATH> device{};
+  for (const wchar_t *drive{drives.data()}; *drive; drive += std::wstring_view{drive}.size() + 1) {
+    const std::wstring letter(drive, 2);
+    if (::QueryDosDeviceW(letter.c_str(), device.data(), static_cast<DWORD>(device.size())) == 0) continue;
+    mDevices.emplace_back(device.data(), letter);
+  }
+}
+
+std::string DosDeviceMap::to_dos_path(std::wstring_view ntPath) const {
+  for (const auto &[device, letter] : mDevices) {
+    if (ntPath.size() > device.size() && ntPath.starts_with(device) && ntPath[device.size()] == L'\\') {
+      return winrt::to_string(letter + std::wstring{ntPath.substr(device.size())});
+    }
+  }
+  constexpr std::wstring_view networkDevice{L"\\Device\\Mup\\"};
+  if (ntPath.starts_with(networkDevice)) {
+    return winrt::to_string(L"\\\\" + std::wstring{ntPath.substr(networkDevice.size())});
+  }
+  return winrt::to_string(ntPath);
+}
+
+std::optional<std::string> query_process_image_name(DWORD pid, const DosDeviceMap &devices) {
+  // Most paths fit in `MAX_PATH`, and the kernel says how long the path is
+  // when they do not.
+  std::wstring name(MAX_PATH, L'\0');
+  for (int attempt{0}; attempt < 2; ++attempt) {
+    SystemProcessIdInformation info{
+        .processId = reinterpret_cast<HANDLE>(static_cast<ULONG_PTR>(pid)),
+        .imageName = {.Length = 0,
+                      .MaximumLength = static_cast<USHORT>(name.size() * sizeof(wchar_t)),
+                      .Buffer = name.data()},
+    };
+    const auto status{::NtQuerySystemInformation(SystemProcessIdInformationClass, &info, sizeof(info), nullptr)};
+    if (status == StatusInfoLengthMismatch) {
+      name.resize(info.imageName.MaximumLength / sizeof(wchar_t));
+      continue;
+    }
+    // The idle process has no image, and any other failure means that there
+    // is no such process.
+    if (status < 0 || info.imageName.Length == 0) return std::nullopt;
+    return devices.to_dos_path(std::wstring_view{name.data(), info.imageName.Length / sizeof(wchar_t)});
+  }
+  return std::nullopt;
+}
+
 }// namespace em
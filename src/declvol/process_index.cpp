@@ -0,0 +1,71 @@
+#include "declvol/process_index.h"
+
+#include <mutex>
+
+namespace em {
+
+void ProcessSource::resolve(
+    std::span<const std::uint32_t> pids,
+    const std::function<void(std::size_t, std::optional<std::string_view>)> &f) {
+  std::unordered_map<std::uint32_t, std::optional<std::string>> resolved;
+  for (std::size_t i{0}; i < pids.size(); ++i) {
+    auto it{resolved.find(pids[i])};
+    if (it == resolved.end()) it = resolved.emplace(pids[i], image_path(pids[i])).first;
+    f(i, it->second);
+  }
+}
+
+ProcessIndex::ProcessIndex(std::unique_ptr<ProcessSource> source, bool watch)
+    : mSource{std::move(source)} {
+  // Start watching before taking the snapshot, so that no process can start
+  // between the two without the index hearing about it. A process that stops
+  // in between may be added by the snapshot after its stop event, leaving a
+  // stale entry, but that is harmless because the start event of any process
+  // that reuses the PID replaces it.
+  if (watch) mSource->watch(*this);
+  mSource->snapshot(*this);
+}
+
+ProcessIndex::~ProcessIndex() = default;
+
+std::optional<std::pmr::string> ProcessIndex::image_path(std::uint32_t pid,
+                                                         std::pmr::memory_resource *resource) {
+  {
+    std::shared_lock lock{mMut};
+    if (const auto it{mProcesses.find(pid)}; it != mProcesses.end()) {
+      mHits.fetch_add(1, std::memory_order_relaxed);
+      return std::pmr::string{it->second.path, resource};
+    }
+  }
+
+  mMisses.fetch_add(1, std::memory_order_relaxed);
+  auto path{mSource->image_path(pid)};
+  if (!path) return std::nullopt;
+
+  // The parent is needed for walking the ancestors of the process, which
+  // only ever look in the index.
+  const auto parent{mSource->parent_pid(pid)};
+  std::pmr::string result{*path, resource};
+  {
+    std::unique_lock lock{mMut};
+    mProcesses.insert_or_assign(pid, Process{std::move(*path), parent.value_or(0)});
+  }
+  return result;
+}
+
+std::size_t ProcessIndex::size() const {
+  std::shared_lock lock{mMut};
+  return mProcesses.size();
+}
+
+void ProcessIndex::process_started(std::uint32_t pid, std::uint32_t parentPid, std::string_view imagePath) {
+  std::unique_lock lock{mMut};
+  mProcesses.insert_or_assign(pid, Process{std::string{imagePath}, parentPid});
+}
+
+void ProcessIndex::process_stopped(std::uint32_t pid) {
+  std::unique_lock lock{mMut};
+  mProcesses.erase(pid);
+}
+
+}// namespace em
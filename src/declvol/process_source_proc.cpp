@@ -0,0 +1,120 @@
+#include "declvol/process_index.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace em {
+namespace {
+
+/**
+ * Process source reading the `/proc` filesystem.
+ *
+ * Linux only reports process events to privileged listeners, through the
+ * netlink process connector, so instead the source notices processes starting
+ * and stopping by comparing the PIDs in `/proc` every `PollInterval`.
+ */
+class ProcProcessSource final : public ProcessSource {
+public:
+  static constexpr std::chrono::milliseconds PollInterval{500};
+
+  void snapshot(ProcessObserver &observer) override {
+    for (const auto pid : list_pids()) {
+      if (const auto path{image_path(pid)}) observer.process_started(pid, parent_pid(pid).value_or(0), *path);
+    }
+  }
+
+  std::optional<std::string> image_path(std::uint32_t pid) override {
+    std::error_code ec;
+    auto path{std::filesystem::read_symlink(std::format("/proc/{}/exe", pid), ec)};
+    if (ec) return std::nullopt;
+    return std::move(path).string();
+  }
+
+  std::optional<std::uint32_t> parent_pid(std::uint32_t pid) override {
+    std::ifstream file{std::format("/proc/{}/stat", pid)};
+    std::string stat;
+    if (!std::getline(file, stat)) return std::nullopt;
+
+    // The name in parentheses may itself contain spaces and parentheses, so
+    // the fields are found after the last closing parenthesis, which is
+    // followed by the state and then the parent's PID.
+    const auto nameEnd{stat.rfind(')')};
+    if (nameEnd == std::string::npos) return std::nullopt;
+    const auto fieldsStart{stat.find(' ', nameEnd + 2)};
+    if (fieldsStart == std::string::npos) return std::nullopt;
+    const auto *begin{stat.data() + fieldsStart + 1};
+    std::uint32_t parent{};
+    const auto [end, err]{std::from_chars(begin, stat.data() + stat.size(), parent)};
+    if (err != std::errc{}) return std::nullopt;
+    return parent;
+  }
+
+  void watch(ProcessObserver &observer) override {
+    mThread = std::jthread{[this, &observer](std::stop_token stop) {
+      auto known{list_pids()};
+      for (;;) {
+        {
+          // Nothing else notifies the condition variable, this just sleeps
+          // until the next poll or until the source is destroyed.
+          std::unique_lock lock{mMut};
+          mCv.wait_for(lock, stop, PollInterval, [] { return false; });
+        }
+        if (stop.stop_requested()) break;
+
+        auto current{list_pids()};
+        std::vector<std::uint32_t> changed;
+        std::ranges::set_difference(known, current, std::back_inserter(changed));
+        for (const auto pid : changed) observer.process_stopped(pid);
+
+        changed.clear();
+        std::ranges::set_difference(current, known, std::back_inserter(changed));
+        for (const auto pid : changed) {
+          if (const auto path{image_path(pid)}) observer.process_started(pid, parent_pid(pid).value_or(0), *path);
+        }
+
+        known = std::move(current);
+      }
+    }};
+  }
+
+private:
+  /**
+   * Return the PIDs of every running process, sorted.
+   */
+  static std::vector<std::uint32_t> list_pids() {
+    std::vector<std::uint32_t> pids;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator{"/proc", ec}) {
+      const auto name{entry.path().filename().string()};
+      std::uint32_t pid{};
+      const auto [end, err]{std::from_chars(name.data(), name.data() + name.size(), pid)};
+      if (err == std::errc{} && end == name.data() + name.size()) pids.push_back(pid);
+    }
+    std::ranges::sort(pids);
+    return pids;
+  }
+
+  std::mutex mMut;
+  std::condition_variable_any mCv;
+  std::jthread mThread;
+};
+
+}// namespace
+
+std::unique_ptr<ProcessSource> make_process_source() {
+  return std::make_unique<ProcProcessSource>();
+}
+
+}// namespace em
@@ -0,0 +1,209 @@
+#include "declvol/process.h"
+#include "declvol/process_index.h"
+#include "declvol/windows.h"
+
+#include <TlHelp32.h>
+#include <WbemIdl.h>
+
+#include <chrono>
+#include <functional>
+#include <new>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace em {
+namespace {
+
+/**
+ * Owning wrapper around a `VARIANT`.
+ */
+struct Variant : VARIANT {
+  Variant() { ::VariantInit(this); }
+
+  Variant(const Variant &) = delete;
+  Variant &operator=(const Variant &) = delete;
+
+  ~Variant() { ::VariantClear(this); }
+};
+
+/**
+ * Owning wrapper around a `BSTR`.
+ */
+class Bstr {
+public:
+  explicit Bstr(const wchar_t *str) : mStr{::SysAllocString(str)} {
+    if (!mStr) throw std::bad_alloc();
+  }
+
+  Bstr(const Bstr &) = delete;
+  Bstr &operator=(const Bstr &) = delete;
+
+  ~Bstr() { ::SysFreeString(mStr); }
+
+  [[nodiscard]] BSTR get() const { return mStr; }
+
+private:
+  BSTR mStr;
+};
+
+/**
+ * Return the value of a property of a WMI object.
+ */
+void get_property(const winrt::com_ptr<IWbemClassObject> &obj, const wchar_t *name, Variant &value) {
+  winrt::check_hresult(obj->Get(name, 0, &value, nullptr, nullptr));
+}
+
+/**
+ * Process source using the Tool Help library for snapshots, the kernel's
+ * image name of each PID for paths, and WMI for process events.
+ *
+ * WMI delivers events for `Win32_Process` instances being created and deleted
+ * by polling on our behalf, which unlike the kernel trace events does not need
+ * the process to be elevated. Events therefore arrive up to `EventLatency`
+ * late.
+ */
+class WindowsProcessSource final : public ProcessSource {
+public:
+  static constexpr std::chrono::seconds EventLatency{1};
+
+  void snapshot(ProcessObserver &observer) override {
+    const winrt::handle snap{::CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0)};
+    if (!snap) winrt::throw_last_error();
+
+    // The snapshot only has the file name of each process, not its full
+    // path, so the path still has to be queried, which is done without
+    // opening the process.
+    const DosDeviceMap devices;
+    PROCESSENTRY32W entry{.dwSize = sizeof(PROCESSENTRY32W)};
+    for (auto ok{::Process32FirstW(snap.get(), &entry)}; ok; ok = ::Process32NextW(snap.get(), &entry)) {
+      if (const auto path{em::query_process_image_name(entry.th32ProcessID, devices)}) {
+        observer.process_started(entry.th32ProcessID, entry.th32ParentProcessID, *path);
+      }
+    }
+  }
+
+  std::optional<std::string> image_path(std::uint32_t pid) override {
+    // The idle and system processes cannot be opened.
+    if (pid == 0 || pid == 4) return std::nullopt;
+    try {
+      return std::string{em::get_process_image_name(em::open_process(pid))};
+    } catch (const winrt::hresult_error &) {
+      return std::nullopt;
+    }
+  }
+
+  std::optional<std::uint32_t> parent_pid(std::uint32_t pid) override {
+    if (pid == 0 || pid == 4) return std::nullopt;
+    try {
+      return em::get_parent_process_id(em::open_process(pid));
+    } catch (const winrt::hresult_error &) {
+      return std::nullopt;
+    }
+  }
+
+  void resolve(std::span<const std::uint32_t> pids,
+               const std::function<void(std::size_t, std::optional<std::string_view>)> &f) override {
+    // The kernel gives the full path of each process by PID, so nothing has
+    // to be opened, and protected processes are resolved too. Only the drive
+    // letters are looked up once for the whole batch.
+    const DosDeviceMap devices;
+    std::unordered_map<std::uint32_t, std::optional<std::string>> resolved;
+    resolved.reserve(pids.size());
+    for (std::size_t i{0}; i < pids.size(); ++i) {
+      auto it{resolved.find(pids[i])};
+      if (it == resolved.end()) it = resolved.emplace(pids[i], em::query_process_image_name(pids[i], devices)).first;
+      f(i, it->second);
+    }
+  }
+
+  void watch(ProcessObserver &observer) override {
+    mThread = std::jthread{[this, &observer](std::stop_token stop) {
+      winrt::init_apartment();
+      try {
+        run(observer, stop);
+      } catch (const winrt::hresult_error &) {
+        // Without events the index still works, it just has to resolve every
+        // new process when it is looked up.
+      }
+    }};
+  }
+
+private:
+  void run(ProcessObserver &observer, std::stop_token stop) {
+    const auto locator{winrt::create_instance<IWbemLocator>(CLSID_WbemLocator, CLSCTX_INPROC_SERVER)};
+    winrt::com_ptr<IWbemServices> services;
+    winrt::check_hresult(locator->ConnectServer(Bstr{L"ROOT\\CIMV2"}.get(), nullptr, nullptr,
+                                                nullptr, 0, nullptr, nullptr, services.put()));
+    winrt::check_hresult(::CoSetProxyBlanket(
+        services.get(), RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, nullptr, RPC_C_AUTHN_LEVEL_CALL,
+        RPC_C_IMP_LEVEL_IMPERSONATE, nullptr, EOAC_NONE));
+
+    // A semisynchronous query is polled from this thread, rather than having
+    // WMI call back into a sink on one of its own threads, which would need
+    // the whole process to lower its COM security.
+    winrt::com_ptr<IEnumWbemClassObject> events;
+    winrt::check_hresult(services->ExecNotificationQuery(
+        Bstr{L"WQL"}.get(),
+        Bstr{L"SELECT * FROM __InstanceOperationEvent WITHIN 1 "
+             L"WHERE (__CLASS = '__InstanceCreationEvent' OR __CLASS = '__InstanceDeletionEvent') "
+             L"AND TargetInstance ISA 'Win32_Process'"}.get(),
+        WBEM_FLAG_RETURN_IMMEDIATELY | WBEM_FLAG_FORWARD_ONLY, nullptr, events.put()));
+
+    constexpr long pollTimeoutMs{250};
+    while (!stop.stop_requested()) {
+      winrt::com_ptr<IWbemClassObject> event;
+      ULONG returned{};
+      const auto hr{events->Next(pollTimeoutMs, 1, event.put(), &returned)};
+      if (hr == WBEM_S_TIMEDOUT || returned == 0) continue;
+      winrt::check_hresult(hr);
+      dispatch(observer, event);
+    }
+  }
+
+  static void dispatch(ProcessObserver &observer, const winrt::com_ptr<IWbemClassObject> &event) {
+    Variant cls;
+    get_property(event, L"__CLASS", cls);
+    Variant target;
+    get_property(event, L"TargetInstance", target);
+    if (V_VT(&cls) != VT_BSTR || V_VT(&target) != VT_UNKNOWN) return;
+
+    winrt::com_ptr<IWbemClassObject> process;
+    winrt::check_hresult(V_UNKNOWN(&target)->QueryInterface(IID_PPV_ARGS(process.put())));
+
+    Variant pid;
+    get_property(process, L"ProcessId", pid);
+    if (V_VT(&pid) != VT_I4) return;
+    const auto processId{static_cast<std::uint32_t>(V_I4(&pid))};
+
+    if (std::wstring_view{V_BSTR(&cls)} == L"__InstanceDeletionEvent") {
+      observer.process_stopped(processId);
+      return;
+    }
+
+    // `ExecutablePath` is null for processes that we are not allowed to query,
+    // so there is nothing to add.
+    Variant path;
+    get_property(process, L"ExecutablePath", path);
+    if (V_VT(&path) != VT_BSTR) return;
+    Variant parentPid;
+    get_property(process, L"ParentProcessId", parentPid);
+    const auto parent{V_VT(&parentPid) == VT_I4 ? static_cast<std::uint32_t>(V_I4(&parentPid)) : 0u};
+    observer.process_started(processId, parent, winrt::to_string(V_BSTR(&path)));
+  }
+
+  std::jthread mThread;
+};
+
+}// namespace
+
+std::unique_ptr<ProcessSource> make_process_source() {
+  return std::make_unique<WindowsProcessSource>();
+}
+
+}// namespace em
@@ -2,49 +2,308 @@
 
 #include <toml.hpp>
 
+#include <array>
+#include <chrono>
 #include <format>
+#include <map>
+#include <optional>
 #include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace em {
+namespace {
+
+/**
+ * Return an error pointing at a particular value in the config file.
+ */
+ProfileError value_error(const std::filesystem::path &profilePath,
+                         const std::string &msg,
+                         const toml::value &value,
+                         const std::string &hint) {
+  return ProfileError(std::format(
+      "[error] Could not read profile at {}\n{}",
+      profilePath.string(), toml::format_error(msg, value, hint)));
+}
+
+/**
+ * Return the ramp curve with the given name as written in a config file.
+ */
+std::optional<RampCurve> parse_ramp_curve(std::string_view name) {
+  if (name == "linear") return RampCurve::Linear;
+  if (name == "ease-in") return RampCurve::EaseIn;
+  if (name == "ease-out") return RampCurve::EaseOut;
+  if (name == "smooth") return RampCurve::Smooth;
+  return std::nullopt;
+}
+
+/**
+ * Read the optional `fade` and `curve` keys of a control.
+ *
+ * `fade` is the duration of the ramp in seconds and `curve` its shape, which
+ * defaults to linear.
+ */
+Fade read_fade(const toml::value &entry, const std::filesystem::path &profilePath) {
+  Fade fade{};
+  if (!entry.contains("fade")) return fade;
+
+  const auto &fadeObj{toml::find(entry, "fade")};
+  const auto seconds{toml::get<float>(fadeObj)};
+  if (seconds < 0.0f) {
+    throw em::value_error(profilePath, "Fade duration is negative", fadeObj,
+                          "fade must not be negative");
+  }
+  fade.duration = std::chrono::round<std::chrono::milliseconds>(
+      std::chrono::duration<float>{seconds});
+
+  if (entry.contains("curve")) {
+    const auto &curveObj{toml::find(entry, "curve")};
+    const auto curve{parse_ramp_curve(toml::get<std::string>(curveObj))};
+    if (!curve) {
+      throw em::value_error(profilePath, "Unknown ramp curve", curveObj,
+                            "expected one of linear, ease-in, ease-out, smooth");
+    }
+    fade.curve = *curve;
+  }
+
+  return fade;
+}
+
+/**
+ * Keys of a control naming the field that it matches, in the same order as
+ * `MatchKind`.
+ */
+constexpr std::array<const char *, 5> MatchKeys{"suffix", "display_name", "icon_path", "session_id", "ancestor"};
+
+/**
+ * Return what a control matches and the text it matches it against.
+ *
+ * A control must have exactly one of the keys in `MatchKeys`.
+ */
+std::pair<MatchKind, std::string> read_match(const toml::value &entry,
+                                             const std::filesystem::path &profilePath) {
+  std::optional<std::pair<MatchKind, std::string>> match;
+  for (std::size_t i{0}; i < MatchKeys.size(); ++i) {
+    if (!entry.contains(MatchKeys[i])) continue;
+    const auto &keyObj{toml::find(entry, MatchKeys[i])};
+    if (match) {
+      throw em::value_error(profilePath, "Control matches more than one field", keyObj,
+                            "remove all but one of suffix, display_name, icon_path, session_id, ancestor");
+    }
+    match.emplace(static_cast<MatchKind>(i), toml::get<std::string>(keyObj));
+  }
+
+  if (!match) {
+    throw em::value_error(profilePath, "Control does not match anything", entry,
+                          "expected one of suffix, display_name, icon_path, session_id, ancestor");
+  }
+  return std::move(*match);
+}
+
+/**
+ * Read the controls defined directly by a profile, ignoring any that it
+ * inherits, and append them to `profile`.
+ */
+void read_own_controls(const toml::value &section,
+                       const std::filesystem::path &profilePath,
+                       VolumeProfile &profile) {
+  // Profiles that extend another can leave out their controls entirely, e.g.
+  // to compose several overlays under a new name.
+  if (section.contains("extends") && !section.contains("controls")) return;
+
+  const auto controls{toml::find(section, "controls").as_array()};
+  for (const auto &entry : controls) {
+    const auto [kind, key]{read_match(entry, profilePath)};
+    const auto &volumeObj{toml::find(entry, "volume")};
+    const auto volume{toml::get<float>(volumeObj)};
+    const auto fade{read_fade(entry, profilePath)};
+
+    try {
+      profile.controls.emplace_back(kind, key, volume, fade);
+    } catch (const std::invalid_argument &e) {
+      throw em::value_error(profilePath, e.what(), volumeObj, "volume must be in range");
+    }
+  }
+}
+
+/**
+ * Remove every control that can never win because a later control matches
+ * everything it does, appending what was removed to `dead` if it is given.
+ *
+ * That is a control matching the same field against the same text as a later
+ * control, or a suffix or ancestor control whose suffix ends with that of a
+ * later control of the same kind. Special suffixes are only removed when
+ * duplicated, since `find_control` looks them up exactly.
+ */
+void remove_dead_controls(VolumeProfile &profile, std::string_view profileName,
+                          std::vector<DeadControl> *dead) {
+  auto &controls{profile.controls};
+
+  // The text of the later control that wins over each control, if any.
+  std::vector<std::optional<std::string_view>> winners(controls.size());
+  {
+    std::array<std::unordered_set<std::string_view>, MatchKeys.size()> seen;
+    for (std::size_t i{controls.size()}; i-- > 0;) {
+      const auto &control{controls[i]};
+      const auto kind{static_cast<std::size_t>(control.kind())};
+      const std::string_view key{control.suffix()};
+
+      // Later suffixes are looked up by every suffix of this one, longest
+      // first, so that the winner reported is the closest match.
+      auto &winner{winners[i]};
+      if ((control.kind() == MatchKind::Suffix || control.kind() == MatchKind::Ancestor) && !key.starts_with(':')) {
+        for (std::size_t start{0}; start <= key.size() && !winner; ++start) {
+          if (seen[kind].contains(key.substr(start))) winner = key.substr(start);
+        }
+      } else if (seen[kind].contains(key)) {
+        winner = key;
+      }
+      if (!winner) seen[kind].insert(key);
+    }
+  }
+
+  // Reported before anything is moved, since the winners refer to controls.
+  if (dead) {
+    for (std::size_t i{0}; i < controls.size(); ++i) {
+      if (!winners[i]) continue;
+      dead->push_back({std::string{profileName}, controls[i].kind(), std::string{controls[i].suffix()},
+                       controls[i].relative_volume(), std::string{*winners[i]}});
+    }
+  }
+
+  auto out{controls.begin()};
+  for (std::size_t i{0}; i < controls.size(); ++i) {
+    if (winners[i]) continue;
+    if (out != controls.begin() + static_cast<std::ptrdiff_t>(i)) {
+      *out = std::move(controls[i]);
+    }
+    ++out;
+  }
+  controls.erase(out, controls.end());
+}
+
+/**
+ * Flattens profiles that extend other profiles into a single table of
+ * controls each.
+ *
+ * A profile's `extends` key names one profile, or a list of profiles that are
+ * overlaid in order. The controls of the extended profiles come first, followed
+ * by the profile's own controls, so that the usual rule of later controls
+ * taking priority lets a profile override what it inherits.
+ */
+class ProfileResolver {
+public:
+  explicit ProfileResolver(const toml::table &sections,
+                           const std::filesystem::path &profilePath,
+                           ProfileMap &profiles,
+                           std::vector<DeadControl> *dead)
+      : mSections{sections}, mProfilePath{profilePath}, mProfiles{profiles}, mDead{dead} {}
+
+  /**
+   * Return the flattened profile with the given name, resolving it first if
+   * necessary.
+   *
+   * `referrer` is the `extends` value that named the profile, if any, and is
+   * used to point at the problem if the profile cannot be resolved.
+   */
+  const VolumeProfile &resolve(const std::string &name, const toml::value *referrer) {
+    if (const auto it{mProfiles.find(std::string_view{name})}; it != mProfiles.end()) {
+      return it->second;
+    }
+
+    const auto sectionIt{mSections.find(name)};
+    if (sectionIt == mSections.end()) {
+      throw em::value_error(mProfilePath, std::format("Profile {} does not exist", name),
+                            *referrer, "extended here");
+    }
+    if (!mResolving.insert(name).second) {
+      throw em::value_error(mProfilePath, std::format("Profile {} extends itself", name),
+                            *referrer, "cycle found here");
+    }
+
+    const auto &section{sectionIt->second};
+    VolumeProfile profile{mProfiles.get_allocator()};
+
+    if (section.contains("extends")) {
+      const auto &extendsObj{toml::find(section, "extends")};
+      const auto parents{extendsObj.is_string()
+                             ? std::vector<std::string>{toml::get<std::string>(extendsObj)}
+                             : toml::get<std::vector<std::string>>(extendsObj)};
+      for (const auto &parent : parents) {
+        const auto &controls{resolve(parent, &extendsObj).controls};
+        profile.controls.insert(profile.controls.end(), controls.begin(), controls.end());
+      }
+    }
+
+    em::read_own_controls(section, mProfilePath, profile);
+    em::remove_dead_controls(profile, name, mDead);
+
+    mResolving.erase(name);
+    return mProfiles.try_emplace(std::pmr::string{name, mProfiles.get_allocator()},
+                                 std::move(profile))
+        .first->second;
+  }
+
+private:
+  const toml::table &mSections;
+  const std::filesystem::path &mProfilePath;
+  ProfileMap &mProfiles;
+  std::vector<DeadControl> *mDead;
+  // Profiles that are partway through being resolved, used to detect cycles.
+  std::unordered_set<std::string> mResolving;
+};
+
+}// namespace
 
 ProfileError::ProfileError(const std::filesystem::path &profilePath,
                            std::string_view context)
     : ProfileError(std::format("[error] Could not read profile file at {}\n{}",
                                profilePath.string(), context)) {}
 
-VolumeControl::VolumeControl(std::string suffix, float relativeVolume)
-    : mSuffix{std::move(suffix)}, mRelativeVolume{relativeVolume} {
+VolumeControl::VolumeControl(MatchKind kind, std::string_view key, float relativeVolume,
+                             Fade fade, const allocator_type &alloc)
+    : mSuffix{key, alloc}, mRelativeVolume{relativeVolume}, mFade{fade}, mKind{kind} {
   if (mRelativeVolume < 0.0f || mRelativeVolume > 1.0f) {
     throw std::invalid_argument(std::format(
         "Volume {} is out of range [0.0, 1.0]", mRelativeVolume));
   }
 }
 
-std::map<std::string, em::VolumeProfile>
-parse_profiles_toml(const std::filesystem::path &profilePath) try {
+const VolumeControl *match_control(const VolumeProfile &profile, std::string_view name) {
+  const auto &controls{profile.controls};
+  for (auto it{controls.rbegin()}; it != controls.rend(); ++it) {
+    if (it->kind() == MatchKind::Suffix && name.ends_with(it->suffix())) return &*it;
+  }
+  return nullptr;
+}
+
+const VolumeControl *find_control(const VolumeProfile &profile, std::string_view suffix) {
+  const auto &controls{profile.controls};
+  for (auto it{controls.rbegin()}; it != controls.rend(); ++it) {
+    if (it->kind() == MatchKind::Suffix && it->suffix() == suffix) return &*it;
+  }
+  return nullptr;
+}
+
+VolumeProfile overlay_profile(const VolumeProfile &base, const VolumeProfile &layer,
+                              std::pmr::memory_resource *resource) {
+  VolumeProfile profile{base, resource};
+  profile.controls.reserve(base.controls.size() + layer.controls.size());
+  profile.controls.insert(profile.controls.end(), layer.controls.begin(), layer.controls.end());
+  em::remove_dead_controls(profile, {}, nullptr);
+  return profile;
+}
+
+ProfileMap parse_profiles_toml(const std::filesystem::path &profilePath,
+                               std::pmr::memory_resource *resource,
+                               std::vector<DeadControl> *dead) try {
   const auto data{toml::parse(profilePath)};
 
-  std::map<std::string, em::VolumeProfile> profiles;
+  ProfileMap profiles{resource};
+  ProfileResolver resolver{data.as_table(), profilePath, profiles, dead};
   for (const auto &section : data.as_table()) {
-    em::VolumeProfile profile{};
-
-    const auto controls{toml::find(section.second, "controls").as_array()};
-    for (const auto &entry : controls) {
-      auto suffix{toml::find<std::string>(entry, "suffix")};
-      const auto &volumeObj{toml::find(entry, "volume")};
-      const auto volume{toml::get<float>(volumeObj)};
-
-      try {
-        profile.controls.emplace_back(em::VolumeControl{std::move(suffix), volume});
-      } catch (const std::invalid_argument &e) {
-        throw ProfileError(std::format(
-            "[error] Could not read profile at {}\n{}",
-            profilePath.string(),
-            toml::format_error(e.what(), volumeObj, "volume must be in range")));
-      }
-    }
-
-    profiles.try_emplace(section.first, std::move(profile));
+    resolver.resolve(section.first, nullptr);
   }
 
   return profiles;
@@ -0,0 +1,190 @@
+#include "declvol/ramp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace em {
+
+void RampScheduler::start(std::string_view key, std::shared_ptr<RampTarget> target,
+                          float volume, const Fade &fade) {
+  auto ticks{static_cast<std::uint64_t>(
+      (fade.duration + TickInterval - std::chrono::milliseconds{1}) / TickInterval)};
+
+  std::unique_lock lock{mMut};
+  auto it{mIndex.find(key)};
+
+  if (ticks == 0) {
+    if (it == mIndex.end()) {
+      lock.unlock();
+      target->set_volume(volume);
+      return;
+    }
+    // Setting the volume here could race with the thread writing the ramp's
+    // last step, so the thread is left to set it instead.
+    ticks = 1;
+  }
+
+  std::optional<float> current;
+  if (it == mIndex.end()) {
+    // Reading the volume of a target can be a cross-process call, so it is not
+    // done with the scheduler locked. A ramp with the same key may have been
+    // started in the meantime, in which case it is retargeted instead.
+    lock.unlock();
+    current = target->volume();
+    lock.lock();
+    it = mIndex.find(key);
+  }
+
+  if (mIndex.empty()) {
+    // The scheduler was idle, so ticks restart from now rather than trying to
+    // catch up on the ones that were skipped while sleeping.
+    mNextTick = clock::now();
+  }
+
+  std::size_t index{};
+  if (it != mIndex.end()) {
+    index = it->second;
+    auto &ramp{mRamps[index]};
+    ramp.target = std::move(target);
+    ramp.from = ramp.current;
+  } else {
+    if (!mFreeRamps.empty()) {
+      index = mFreeRamps.back();
+      mFreeRamps.pop_back();
+    } else {
+      index = mRamps.size();
+      mRamps.emplace_back();
+    }
+    auto &ramp{mRamps[index]};
+    ramp.key = key;
+    ramp.target = std::move(target);
+    ramp.from = *current;
+    ramp.current = *current;
+    ramp.active = true;
+    mIndex.try_emplace(std::string{key}, index);
+  }
+
+  auto &ramp{mRamps[index]};
+  ramp.to = volume;
+  ramp.curve = fade.curve;
+  ramp.startTick = mTick;
+  ramp.endTick = mTick + ticks;
+  const float distance{std::abs(ramp.to - ramp.from)};
+  ramp.stepTicks = distance == 0.0f
+                       ? ticks
+                       : std::clamp<std::uint64_t>(
+                             static_cast<std::uint64_t>(MinStep * static_cast<float>(ticks) / distance), 1, ticks);
+  // Any wheel entry from before a retarget is now stale.
+  ++ramp.generation;
+  schedule(index);
+
+  if (!mThread.joinable()) {
+    mThread = std::jthread{[this](std::stop_token stop) { run(std::move(stop)); }};
+  }
+  lock.unlock();
+  mWake.notify_one();
+}
+
+void RampScheduler::cancel(std::string_view key) {
+  std::lock_guard lock{mMut};
+  if (const auto it{mIndex.find(key)}; it != mIndex.end()) {
+    retire(it->second);
+  }
+  if (mIndex.empty()) mIdle.notify_all();
+}
+
+bool RampScheduler::has_ramps() const {
+  std::lock_guard lock{mMut};
+  return !mIndex.empty();
+}
+
+void RampScheduler::wait_idle() {
+  std::unique_lock lock{mMut};
+  mIdle.wait(lock, [this] { return mIndex.empty(); });
+}
+
+void RampScheduler::run(std::stop_token stop) {
+  std::unique_lock lock{mMut};
+  while (!stop.stop_requested()) {
+    if (mIndex.empty()) {
+      mIdle.notify_all();
+      mWake.wait(lock, stop, [this] { return !mIndex.empty(); });
+      continue;
+    }
+
+    // Waiting on the condition variable instead of sleeping lets a stop
+    // request interrupt the wait. New ramps do not need to interrupt it since
+    // they are picked up on the next tick anyway.
+    mWake.wait_until(lock, stop, mNextTick, [] { return false; });
+    if (stop.stop_requested()) break;
+
+    tick(lock);
+    ++mTick;
+    mNextTick += TickInterval;
+  }
+}
+
+void RampScheduler::tick(std::unique_lock<std::mutex> &lock) {
+  // Work out the volume of every ramp due on this tick. Entries for ramps that
+  // have been retargeted or cancelled since they were added are dropped, and
+  // entries for ramps due on a later lap of the wheel are kept.
+  auto &slot{mWheel[mTick % WheelSize]};
+  std::erase_if(slot, [this](const WheelEntry &entry) {
+    auto &ramp{mRamps[entry.index]};
+    if (!ramp.active || ramp.generation != entry.generation) return true;
+    if (ramp.nextTick > mTick) return false;
+
+    const bool last{mTick >= ramp.endTick};
+    const auto elapsed{static_cast<float>(mTick - ramp.startTick)};
+    const auto length{static_cast<float>(ramp.endTick - ramp.startTick)};
+    const float level{last ? ramp.to
+                           : ramp.from + (ramp.to - ramp.from) * em::apply_ramp_curve(ramp.curve, elapsed / length)};
+    mSteps.push_back({entry.index, entry.generation, ramp.target, level, level != ramp.current, last, false});
+    return true;
+  });
+  // Added afterwards since the next step may be in the same slot.
+  for (const auto &step : mSteps) {
+    if (!step.last) schedule(step.index);
+  }
+  if (mSteps.empty()) return;
+
+  lock.unlock();
+  for (auto &step : mSteps) {
+    if (!step.write) continue;
+    try {
+      step.target->set_volume(step.volume);
+    } catch (...) {
+      // Most likely the session has gone away, in which case there is nothing
+      // left to ramp.
+      step.failed = true;
+    }
+  }
+  lock.lock();
+
+  for (const auto &step : mSteps) {
+    auto &ramp{mRamps[step.index]};
+    // The ramp may have been retargeted or cancelled while it was written.
+    if (!ramp.active || ramp.generation != step.generation) continue;
+    if (!step.failed) ramp.current = step.volume;
+    if (step.failed || step.last) retire(step.index);
+  }
+  mSteps.clear();
+}
+
+void RampScheduler::schedule(std::size_t index) {
+  auto &ramp{mRamps[index]};
+  ramp.nextTick = std::min(mTick + ramp.stepTicks, ramp.endTick);
+  mWheel[ramp.nextTick % WheelSize].push_back({index, ramp.generation});
+}
+
+void RampScheduler::retire(std::size_t index) {
+  auto &ramp{mRamps[index]};
+  mIndex.erase(mIndex.find(std::string_view{ramp.key}));
+  ramp.target.reset();
+  ramp.active = false;
+  ++ramp.generation;
+  mFreeRamps.push_back(index);
+}
+
+}// namespace em
@@ -0,0 +1,166 @@
+#include "declvol/snapshot.h"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+
+namespace em {
+namespace {
+
+void put_varint(std::string &out, std::uint64_t value) {
+  while (value >= 0x80u) {
+    out.push_back(static_cast<char>((value & 0x7fu) | 0x80u));
+    value >>= 7u;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void put_float(std::string &out, float value) {
+  const auto bits{std::bit_cast<std::uint32_t>(value)};
+  for (unsigned shift{0}; shift < 32u; shift += 8u) {
+    out.push_back(static_cast<char>((bits >> shift) & 0xffu));
+  }
+}
+
+/**
+ * Reads the fields of a snapshot from its bytes, returning an empty optional
+ * from any field that runs past the end.
+ */
+class Reader {
+public:
+  explicit Reader(std::string_view data) : mData{data} {}
+
+  std::optional<std::uint64_t> varint() {
+    std::uint64_t value{0};
+    for (unsigned shift{0}; shift < 64u && mPos < mData.size(); shift += 7u) {
+      const auto c{static_cast<std::uint8_t>(mData[mPos++])};
+      value |= static_cast<std::uint64_t>(c & 0x7fu) << shift;
+      if ((c & 0x80u) == 0) return value;
+    }
+    return std::nullopt;
+  }
+
+  std::optional<std::string_view> bytes(std::size_t size) {
+    if (mData.size() - mPos < size) return std::nullopt;
+    const auto value{mData.substr(mPos, size)};
+    mPos += size;
+    return value;
+  }
+
+  std::optional<float> float32() {
+    const auto value{bytes(4)};
+    if (!value) return std::nullopt;
+    std::uint32_t bits{0};
+    for (unsigned i{0}; i < 4u; ++i) {
+      bits |= static_cast<std::uint32_t>(static_cast<std::uint8_t>((*value)[i])) << (8u * i);
+    }
+    return std::bit_cast<float>(bits);
+  }
+
+  std::optional<bool> flag() {
+    const auto value{bytes(1)};
+    if (!value) return std::nullopt;
+    return (*value)[0] != 0;
+  }
+
+  [[nodiscard]] bool done() const noexcept {
+    return mPos == mData.size();
+  }
+
+private:
+  std::string_view mData;
+  std::size_t mPos{0};
+};
+
+}// namespace
+
+void write_snapshot(const std::filesystem::path &path, const VolumeSnapshot &snapshot) {
+  // Built in memory first, so that the file is written in one call.
+  std::string out{VolumeSnapshot::Magic};
+  put_varint(out, VolumeSnapshot::Version);
+  put_float(out, snapshot.deviceVolume);
+  out.push_back(static_cast<char>(snapshot.deviceMuted));
+  put_varint(out, snapshot.sessions.size());
+  for (const auto &session : snapshot.sessions) {
+    put_varint(out, session.name.size());
+    out += session.name;
+    out.append(reinterpret_cast<const char *>(session.grouping.data()), session.grouping.size());
+    put_float(out, session.volume);
+    out.push_back(static_cast<char>(session.muted));
+  }
+
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  file.write(out.data(), static_cast<std::streamsize>(out.size()));
+  if (!file.flush()) {
+    throw SnapshotError(std::format("[error] Could not write snapshot file {}", path.string()));
+  }
+}
+
+VolumeSnapshot read_snapshot(const std::filesystem::path &path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    throw SnapshotError(std::format("[error] Could not open snapshot file {}", path.string()));
+  }
+  const std::string data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+  Reader reader{data};
+  if (reader.bytes(VolumeSnapshot::Magic.size()) != VolumeSnapshot::Magic) {
+    throw SnapshotError(std::format("[error] {} is not a snapshot", path.string()));
+  }
+  if (const auto version{reader.varint()}; !version || *version > VolumeSnapshot::Version) {
+    throw SnapshotError(std::format("[error] {} is from a newer version", path.string()));
+  }
+
+  const auto corrupt{[&path] {
+    return SnapshotError(std::format("[error] Snapshot {} is corrupt", path.string()));
+  }};
+  VolumeSnapshot snapshot;
+  const auto deviceVolume{reader.float32()};
+  const auto deviceMuted{reader.flag()};
+  const auto count{reader.varint()};
+  // Every session takes at least 22 bytes, which bounds the count before
+  // anything is allocated for it.
+  if (!deviceVolume || !deviceMuted || !count || *count > data.size() / 22u) throw corrupt();
+  snapshot.deviceVolume = *deviceVolume;
+  snapshot.deviceMuted = *deviceMuted;
+
+  snapshot.sessions.reserve(*count);
+  for (std::uint64_t i{0}; i < *count; ++i) {
+    const auto nameSize{reader.varint()};
+    const auto name{nameSize ? reader.bytes(*nameSize) : std::nullopt};
+    const auto grouping{reader.bytes(std::tuple_size_v<GroupingKey>)};
+    const auto volume{reader.float32()};
+    const auto muted{reader.flag()};
+    if (!name || !grouping || !volume || !muted) throw corrupt();
+
+    auto &session{snapshot.sessions.emplace_back()};
+    session.name = *name;
+    std::copy(grouping->begin(), grouping->end(), session.grouping.begin());
+    session.volume = *volume;
+    session.muted = *muted;
+  }
+  if (!reader.done()) throw corrupt();
+
+  return snapshot;
+}
+
+SnapshotIndex::SnapshotIndex(const VolumeSnapshot &snapshot) {
+  mByName.reserve(snapshot.sessions.size());
+  for (const auto &session : snapshot.sessions) {
+    mByName[session.name].push_back(&session);
+  }
+}
+
+const SessionSnapshot *SnapshotIndex::find(std::string_view name, const GroupingKey &grouping) const {
+  const auto it{mByName.find(name)};
+  if (it == mByName.end()) return nullptr;
+  for (const auto *session : it->second) {
+    if (session->grouping == grouping) return session;
+  }
+  return it->second.back();
+}
+
+}// namespace em
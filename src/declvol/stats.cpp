@@ -0,0 +1,181 @@
+#include "declvol/stats.h"
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <thread>
+
+namespace em {
+namespace {
+
+/**
+ * Return the FNV-1a hash of `str`, continuing from `hash`.
+ */
+constexpr std::uint64_t fnv1a(std::string_view str, std::uint64_t hash = 0xcbf29ce484222325u) {
+  for (const char c : str) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3u;
+  }
+  return hash;
+}
+
+/**
+ * Append `str` to `out` escaped as an OpenMetrics label value.
+ */
+void append_label_value(std::string &out, std::string_view str) {
+  for (const char c : str) {
+    switch (c) {
+    case '\\': out += "\\\\"; break;
+    case '"': out += "\\\""; break;
+    case '\n': out += "\\n"; break;
+    default: out += c;
+    }
+  }
+}
+
+/**
+ * Append the header of a metric family to `out`.
+ */
+void append_family(std::string &out, std::string_view name, std::string_view type,
+                   std::string_view help) {
+  std::format_to(std::back_inserter(out), "# TYPE {} {}\n# HELP {} {}\n", name, type, name, help);
+}
+
+/**
+ * Append a histogram metric family to `out`.
+ */
+void append_histogram(std::string &out, std::string_view name, std::string_view help,
+                      const LatencyHistogram &histogram) {
+  auto it{std::back_inserter(out)};
+  append_family(out, name, "histogram", help);
+
+  // The buckets are read one at a time while they may be changing, so the
+  // count is taken from the buckets themselves to keep the family consistent.
+  std::uint64_t count{0};
+  for (std::size_t i{0}; i < LatencyHistogram::NumBuckets; ++i) {
+    count += histogram.bucket(i);
+    if (i + 1 < LatencyHistogram::NumBuckets) {
+      std::format_to(it, "{}_bucket{{le=\"{}\"}} {}\n", name,
+                     static_cast<double>(LatencyHistogram::bucket_bound(i)) * 1e-6, count);
+    } else {
+      std::format_to(it, "{}_bucket{{le=\"+Inf\"}} {}\n", name, count);
+    }
+  }
+  std::format_to(it, "{}_sum {}\n", name, std::chrono::duration<double>(histogram.sum()).count());
+  std::format_to(it, "{}_count {}\n", name, count);
+}
+
+}// namespace
+
+void ControlMatchTable::record(MatchKind kind, std::string_view suffix) {
+  suffix = suffix.substr(0, MaxSuffixSize - 1);
+
+  // Open addressing with linear probing. Slots are never released, so a probe
+  // can stop at the first empty slot.
+  const char kindByte{static_cast<char>(kind)};
+  const auto hash{fnv1a(suffix, fnv1a(std::string_view{&kindByte, 1}))};
+  const auto start{static_cast<std::size_t>(hash % MaxControls)};
+  for (std::size_t n{0}; n < MaxControls; ++n) {
+    auto &slot{mSlots[(start + n) % MaxControls]};
+
+    auto state{slot.state.load(std::memory_order_acquire)};
+    if (state == SlotState::Empty
+        && slot.state.compare_exchange_strong(state, SlotState::Claiming,
+                                              std::memory_order_acquire)) {
+      std::ranges::copy(suffix, slot.suffix.begin());
+      slot.kind = kind;
+      slot.size = static_cast<std::uint32_t>(suffix.size());
+      slot.state.store(SlotState::Ready, std::memory_order_release);
+      slot.matches.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    // Another thread is claiming the slot, possibly for this same control, so
+    // wait for it to finish copying the suffix in.
+    while (state == SlotState::Claiming) {
+      std::this_thread::yield();
+      state = slot.state.load(std::memory_order_acquire);
+    }
+
+    if (slot.kind == kind && std::string_view{slot.suffix.data(), slot.size} == suffix) {
+      slot.matches.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  mOverflow.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string format_openmetrics(const StatsPage &stats) {
+  std::string out;
+  auto it{std::back_inserter(out)};
+
+  append_family(out, "declvol_sessions_handled", "counter",
+                "Audio sessions whose volume was set or checked.");
+  std::format_to(it, "declvol_sessions_handled_total {}\n",
+                 stats.sessionsHandled.load(std::memory_order_relaxed));
+
+  append_family(out, "declvol_open_process_failures", "counter",
+                "Audio sessions whose process could not be opened.");
+  std::format_to(it, "declvol_open_process_failures_total {}\n",
+                 stats.openProcessFailures.load(std::memory_order_relaxed));
+
+  append_family(out, "declvol_sessions_grouped", "counter",
+                "Audio sessions that reused the match of another session in the same group.");
+  std::format_to(it, "declvol_sessions_grouped_total {}\n",
+                 stats.sessionsGrouped.load(std::memory_order_relaxed));
+
+  append_family(out, "declvol_switches_received", "counter",
+                "Profile switches received from setters, counting each switch in a batch.");
+  std::format_to(it, "declvol_switches_received_total {}\n",
+                 stats.switchesReceived.load(std::memory_order_relaxed));
+
+  append_family(out, "declvol_match_memo_lookups", "counter",
+                "New audio sessions whose control was looked up in the match memo, by result.");
+  std::format_to(it, "declvol_match_memo_lookups_total{{result=\"hit\"}} {}\n",
+                 stats.memoHits.load(std::memory_order_relaxed));
+  std::format_to(it, "declvol_match_memo_lookups_total{{result=\"miss\"}} {}\n",
+                 stats.memoMisses.load(std::memory_order_relaxed));
+
+  append_family(out, "declvol_volume_enforcements", "counter",
+                "Audio session volume changes made by other programs, by whether they were put back.");
+  std::format_to(it, "declvol_volume_enforcements_total{{result=\"reverted\"}} {}\n",
+                 stats.volumesEnforced.load(std::memory_order_relaxed));
+  std::format_to(it, "declvol_volume_enforcements_total{{result=\"limited\"}} {}\n",
+                 stats.enforcementsLimited.load(std::memory_order_relaxed));
+
+  append_family(out, "declvol_control_matches", "counter",
+                "Audio sessions matched by each control, by kind and suffix or other key.");
+  stats.controlMatches.for_each([&](MatchKind kind, std::string_view suffix, std::uint64_t matches) {
+    std::format_to(it, "declvol_control_matches_total{{kind=\"{}\",key=\"", match_kind_name(kind));
+    append_label_value(out, suffix);
+    std::format_to(it, "\"}} {}\n", matches);
+  });
+
+  append_family(out, "declvol_control_matches_dropped", "counter",
+                "Audio sessions matched by controls that did not fit in the table of control matches.");
+  std::format_to(it, "declvol_control_matches_dropped_total {}\n",
+                 stats.controlMatches.overflow());
+
+  append_family(out, "declvol_queue_depth", "gauge",
+                "New audio sessions waiting to be handled.");
+  std::format_to(it, "declvol_queue_depth {}\n",
+                 stats.queueDepth.load(std::memory_order_relaxed));
+
+  append_family(out, "declvol_queue_overflows", "counter",
+                "New audio sessions deferred to the overflow list because the queue was full.");
+  std::format_to(it, "declvol_queue_overflows_total {}\n",
+                 stats.queueOverflows.load(std::memory_order_relaxed));
+
+  append_histogram(out, "declvol_queue_latency_seconds",
+                   "Time from a new audio session being announced to it being taken off the queue.",
+                   stats.queueLatency);
+  append_histogram(out, "declvol_apply_latency_seconds",
+                   "Time from a new audio session being announced to its volume being set.",
+                   stats.applyLatency);
+
+  out += "# EOF\n";
+  return out;
+}
+
+}// namespace em
@@ -0,0 +1,181 @@
+#include "declvol/trace.h"
+
+#include <array>
+#include <bit>
+#include <format>
+#include <limits>
+
+namespace em {
+
+TraceWriter::TraceWriter(const std::filesystem::path &path)
+    : mFile{path, std::ios::binary | std::ios::trunc},
+      mLast{std::chrono::steady_clock::now()} {
+  if (!mFile) {
+    throw TraceError(std::format("[error] Could not open trace file {}", path.string()));
+  }
+  mFile.write(Magic.data(), static_cast<std::streamsize>(Magic.size()));
+  put_varint(Version);
+}
+
+std::uint64_t TraceWriter::session_created(std::uint32_t pid, std::string_view name) {
+  std::lock_guard lock{mMut};
+  const auto session{mNextSession++};
+  begin(TraceKind::SessionCreated);
+  put_varint(session);
+  put_varint(pid);
+  put_string(name);
+  return session;
+}
+
+void TraceWriter::session_ended(std::uint64_t session) {
+  std::lock_guard lock{mMut};
+  begin(TraceKind::SessionEnded);
+  put_varint(session);
+}
+
+void TraceWriter::request(wire::Operation operation, std::string_view configPath, std::string_view profile) {
+  std::lock_guard lock{mMut};
+  begin(TraceKind::Request);
+  put_varint(static_cast<std::uint32_t>(operation));
+  put_string(configPath);
+  put_string(profile);
+}
+
+void TraceWriter::set_override(std::string_view suffix, float volume) {
+  std::lock_guard lock{mMut};
+  begin(TraceKind::Override);
+  put_string(suffix);
+  // The volume is written as the bits of the float, so that it is read back
+  // exactly.
+  put_varint(std::bit_cast<std::uint32_t>(volume));
+}
+
+void TraceWriter::clear_overrides() {
+  std::lock_guard lock{mMut};
+  begin(TraceKind::ClearOverrides);
+}
+
+void TraceWriter::flush() {
+  std::lock_guard lock{mMut};
+  mFile.flush();
+}
+
+void TraceWriter::begin(TraceKind kind) {
+  // The clock is read with the lock held, so deltas are never negative.
+  const auto now{std::chrono::steady_clock::now()};
+  const auto delta{std::chrono::duration_cast<std::chrono::microseconds>(now - mLast)};
+  // Only whole microseconds are written, so the remainder is carried over to
+  // the next record rather than lost.
+  mLast += delta;
+  mFile.put(static_cast<char>(kind));
+  put_varint(static_cast<std::uint64_t>(delta.count()));
+}
+
+void TraceWriter::put_varint(std::uint64_t value) {
+  std::array<char, 10> buf;
+  std::size_t size{0};
+  while (value >= 0x80u) {
+    buf[size++] = static_cast<char>((value & 0x7fu) | 0x80u);
+    value >>= 7u;
+  }
+  buf[size++] = static_cast<char>(value);
+  mFile.write(buf.data(), static_cast<std::streamsize>(size));
+}
+
+void TraceWriter::put_string(std::string_view value) {
+  put_varint(value.size());
+  mFile.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+TraceReader::TraceReader(const std::filesystem::path &path)
+    : mFile{path, std::ios::binary} {
+  if (!mFile) {
+    throw TraceError(std::format("[error] Could not open trace file {}", path.string()));
+  }
+
+  std::array<char, TraceWriter::Magic.size()> magic{};
+  mFile.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+  if (!mFile || std::string_view{magic.data(), magic.size()} != TraceWriter::Magic) {
+    throw TraceError(std::format("[error] {} is not a trace", path.string()));
+  }
+  if (const auto version{get_varint()}; !version || *version > TraceWriter::Version) {
+    throw TraceError(std::format("[error] {} is from a newer version", path.string()));
+  }
+}
+
+std::optional<TraceRecord> TraceReader::next() {
+  const auto kind{mFile.get()};
+  if (kind == std::char_traits<char>::eof()) return std::nullopt;
+
+  TraceRecord record;
+  record.kind = static_cast<TraceKind>(kind);
+  const auto delta{get_varint()};
+  if (!delta) return std::nullopt;
+  mTime += std::chrono::microseconds{*delta};
+  record.time = mTime;
+
+  switch (record.kind) {
+  case TraceKind::SessionCreated: {
+    const auto session{get_varint()};
+    const auto pid{get_varint()};
+    auto name{get_string()};
+    if (!session || !pid || !name || *pid > std::numeric_limits<std::uint32_t>::max()) return std::nullopt;
+    record.session = *session;
+    record.pid = static_cast<std::uint32_t>(*pid);
+    record.name = std::move(*name);
+    return record;
+  }
+  case TraceKind::SessionEnded: {
+    const auto session{get_varint()};
+    if (!session) return std::nullopt;
+    record.session = *session;
+    return record;
+  }
+  case TraceKind::Request: {
+    const auto operation{get_varint()};
+    auto configPath{get_string()};
+    auto profile{get_string()};
+    if (!operation || !configPath || !profile) return std::nullopt;
+    record.operation = static_cast<wire::Operation>(*operation);
+    record.configPath = std::move(*configPath);
+    record.profile = std::move(*profile);
+    return record;
+  }
+  case TraceKind::Override: {
+    auto suffix{get_string()};
+    const auto volume{get_varint()};
+    if (!suffix || !volume || *volume > std::numeric_limits<std::uint32_t>::max()) return std::nullopt;
+    record.suffix = std::move(*suffix);
+    record.volume = std::bit_cast<float>(static_cast<std::uint32_t>(*volume));
+    return record;
+  }
+  case TraceKind::ClearOverrides: return record;
+  }
+
+  throw TraceError(std::format("[error] Unknown trace record kind {}", kind));
+}
+
+std::optional<std::uint64_t> TraceReader::get_varint() {
+  std::uint64_t value{0};
+  for (unsigned shift{0}; shift < 64u; shift += 7u) {
+    const auto c{mFile.get()};
+    if (c == std::char_traits<char>::eof()) return std::nullopt;
+    value |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+    if ((c & 0x80) == 0) return value;
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> TraceReader::get_string() {
+  // Anything longer is corrupt, and should not be allocated.
+  constexpr std::uint64_t maxSize{1u << 20u};
+  const auto size{get_varint()};
+  if (!size || *size > maxSize) return std::nullopt;
+
+  std::string value(*size, '\0');
+  mFile.read(value.data(), static_cast<std::streamsize>(value.size()));
+  if (mFile.gcount() != static_cast<std::streamsize>(value.size())) return std::nullopt;
+  return value;
+}
+
+}// namespace em
@@ -23,6 +23,7 @@ PROTOBUF_CONSTEXPR SwitchProfileRequest::SwitchProfileRequest(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.profile_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.config_path_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.operation_)*/0
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct SwitchProfileRequestDefaultTypeInternal {
   PROTOBUF_CONSTEXPR SwitchProfileRequestDefaultTypeInternal()
@@ -45,10 +46,126 @@ struct SwitchProfileResponseDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 SwitchProfileResponseDefaultTypeInternal _SwitchProfileResponse_default_instance_;
+PROTOBUF_CONSTEXPR CommandBatch::CommandBatch(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.commands_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct CommandBatchDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR CommandBatchDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~CommandBatchDefaultTypeInternal() {}
+  union {
+    CommandBatch _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 CommandBatchDefaultTypeInternal _CommandBatch_default_instance_;
+PROTOBUF_CONSTEXPR Command::Command(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.command_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_._oneof_case_)*/{}} {}
+struct CommandDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR CommandDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~CommandDefaultTypeInternal() {}
+  union {
+    Command _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 CommandDefaultTypeInternal _Command_default_instance_;
+PROTOBUF_CONSTEXPR SetOverride::SetOverride(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.suffix_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.volume_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct SetOverrideDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR SetOverrideDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~SetOverrideDefaultTypeInternal() {}
+  union {
+    SetOverride _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 SetOverrideDefaultTypeInternal _SetOverride_default_instance_;
+PROTOBUF_CONSTEXPR ClearOverrides::ClearOverrides(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_._cached_size_)*/{}} {}
+struct ClearOverridesDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR ClearOverridesDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~ClearOverridesDefaultTypeInternal() {}
+  union {
+    ClearOverrides _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 ClearOverridesDefaultTypeInternal _ClearOverrides_default_instance_;
 }  // namespace v1
 }  // namespace declvol
 namespace declvol {
 namespace v1 {
+bool SwitchProfileRequest_Operation_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> SwitchProfileRequest_Operation_strings[3] = {};
+
+static const char SwitchProfileRequest_Operation_names[] =
+  "OPERATION_POP"
+  "OPERATION_PUSH"
+  "OPERATION_REPLACE";
+
+static const ::PROTOBUF_NAMESPACE_ID::internal::EnumEntry SwitchProfileRequest_Operation_entries[] = {
+  { {SwitchProfileRequest_Operation_names + 0, 13}, 2 },
+  { {SwitchProfileRequest_Operation_names + 13, 14}, 1 },
+  { {SwitchProfileRequest_Operation_names + 27, 17}, 0 },
+};
+
+static const int SwitchProfileRequest_Operation_entries_by_number[] = {
+  2, // 0 -> OPERATION_REPLACE
+  1, // 1 -> OPERATION_PUSH
+  0, // 2 -> OPERATION_POP
+};
+
+const std::string& SwitchProfileRequest_Operation_Name(
+    SwitchProfileRequest_Operation value) {
+  static const bool dummy =
+      ::PROTOBUF_NAMESPACE_ID::internal::InitializeEnumStrings(
+          SwitchProfileRequest_Operation_entries,
+          SwitchProfileRequest_Operation_entries_by_number,
+          3, SwitchProfileRequest_Operation_strings);
+  (void) dummy;
+  int idx = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumName(
+      SwitchProfileRequest_Operation_entries,
+      SwitchProfileRequest_Operation_entries_by_number,
+      3, value);
+  return idx == -1 ? ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString() :
+                     SwitchProfileRequest_Operation_strings[idx].get();
+}
+bool SwitchProfileRequest_Operation_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, SwitchProfileRequest_Operation* value) {
+  int int_value;
+  bool success = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumValue(
+      SwitchProfileRequest_Operation_entries, 3, name, &int_value);
+  if (success) {
+    *value = static_cast<SwitchProfileRequest_Operation>(int_value);
+  }
+  return success;
+}
+#if (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+constexpr SwitchProfileRequest_Operation SwitchProfileRequest::OPERATION_REPLACE;
+constexpr SwitchProfileRequest_Operation SwitchProfileRequest::OPERATION_PUSH;
+constexpr SwitchProfileRequest_Operation SwitchProfileRequest::OPERATION_POP;
+constexpr SwitchProfileRequest_Operation SwitchProfileRequest::Operation_MIN;
+constexpr SwitchProfileRequest_Operation SwitchProfileRequest::Operation_MAX;
+constexpr int SwitchProfileRequest::Operation_ARRAYSIZE;
+#endif  // (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
 
 // ===================================================================
 
@@ -68,6 +185,7 @@ SwitchProfileRequest::SwitchProfileRequest(const SwitchProfileRequest& from)
   new (&_impl_) Impl_{
       decltype(_impl_.profile_){}
     , decltype(_impl_.config_path_){}
+    , decltype(_impl_.operation_){}
     , /*decltype(_impl_._cached_size_)*/{}};
 
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
@@ -87,6 +205,7 @@ SwitchProfileRequest::SwitchProfileRequest(const SwitchProfileRequest& from)
     _this->_impl_.config_path_.Set(from._internal_config_path(), 
       _this->GetArenaForAllocation());
   }
+  _this->_impl_.operation_ = from._impl_.operation_;
   // @@protoc_insertion_point(copy_constructor:declvol.v1.SwitchProfileRequest)
 }
 
@@ -97,6 +216,7 @@ inline void SwitchProfileRequest::SharedCtor(
   new (&_impl_) Impl_{
       decltype(_impl_.profile_){}
     , decltype(_impl_.config_path_){}
+    , decltype(_impl_.operation_){0}
     , /*decltype(_impl_._cached_size_)*/{}
   };
   _impl_.profile_.InitDefault();
@@ -136,6 +256,7 @@ void SwitchProfileRequest::Clear() {
 
   _impl_.profile_.ClearToEmpty();
   _impl_.config_path_.ClearToEmpty();
+  _impl_.operation_ = 0;
   _internal_metadata_.Clear<std::string>();
 }
 
@@ -165,6 +286,15 @@ const char* SwitchProfileRequest::_InternalParse(const char* ptr, ::_pbi::ParseC
         } else
           goto handle_unusual;
         continue;
+      // .declvol.v1.SwitchProfileRequest.Operation operation = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_operation(static_cast<::declvol::v1::SwitchProfileRequest_Operation>(val));
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -214,6 +344,13 @@ uint8_t* SwitchProfileRequest::_InternalSerialize(
         2, this->_internal_config_path(), target);
   }
 
+  // .declvol.v1.SwitchProfileRequest.Operation operation = 3;
+  if (this->_internal_operation() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      3, this->_internal_operation(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -244,6 +381,12 @@ size_t SwitchProfileRequest::ByteSizeLong() const {
         this->_internal_config_path());
   }
 
+  // .declvol.v1.SwitchProfileRequest.Operation operation = 3;
+  if (this->_internal_operation() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_operation());
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
   }
@@ -271,6 +414,9 @@ void SwitchProfileRequest::MergeFrom(const SwitchProfileRequest& from) {
   if (!from._internal_config_path().empty()) {
     _this->_internal_set_config_path(from._internal_config_path());
   }
+  if (from._internal_operation() != 0) {
+    _this->_internal_set_operation(from._internal_operation());
+  }
   _this->_internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
 }
 
@@ -298,6 +444,7 @@ void SwitchProfileRequest::InternalSwap(SwitchProfileRequest* other) {
       &_impl_.config_path_, lhs_arena,
       &other->_impl_.config_path_, rhs_arena
   );
+  swap(_impl_.operation_, other->_impl_.operation_);
 }
 
 std::string SwitchProfileRequest::GetTypeName() const {
@@ -453,17 +600,977 @@ std::string SwitchProfileResponse::GetTypeName() const {
 }
 
 
-// @@protoc_insertion_point(namespace_scope)
-}  // namespace v1
-}  // namespace declvol
-PROTOBUF_NAMESPACE_OPEN
-template<> PROTOBUF_NOINLINE ::declvol::v1::SwitchProfileRequest*
-Arena::CreateMaybeMessage< ::declvol::v1::SwitchProfileRequest >(Arena* arena) {
-  return Arena::CreateMessageInternal< ::declvol::v1::SwitchProfileRequest >(arena);
+// ===================================================================
+
+class CommandBatch::_Internal {
+ public:
+};
+
+CommandBatch::CommandBatch(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:declvol.v1.CommandBatch)
 }
-template<> PROTOBUF_NOINLINE ::declvol::v1::SwitchProfileResponse*
-Arena::CreateMaybeMessage< ::declvol::v1::SwitchProfileResponse >(Arena* arena) {
-  return Arena::CreateMessageInternal< ::declvol::v1::SwitchProfileResponse >(arena);
+CommandBatch::CommandBatch(const CommandBatch& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite() {
+  CommandBatch* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.commands_){from._impl_.commands_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:declvol.v1.CommandBatch)
+}
+
+inline void CommandBatch::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.commands_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+CommandBatch::~CommandBatch() {
+  // @@protoc_insertion_point(destructor:declvol.v1.CommandBatch)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<std::string>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void CommandBatch::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.commands_.~RepeatedPtrField();
+}
+
+void CommandBatch::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void CommandBatch::Clear() {
+// @@protoc_insertion_point(message_clear_start:declvol.v1.CommandBatch)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.commands_.Clear();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* CommandBatch::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .declvol.v1.Command commands = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_commands(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<34>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* CommandBatch::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:declvol.v1.CommandBatch)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .declvol.v1.Command commands = 4;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_commands_size()); i < n; i++) {
+    const auto& repfield = this->_internal_commands(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(4, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:declvol.v1.CommandBatch)
+  return target;
+}
+
+size_t CommandBatch::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:declvol.v1.CommandBatch)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .declvol.v1.Command commands = 4;
+  total_size += 1UL * this->_internal_commands_size();
+  for (const auto& msg : this->_impl_.commands_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::_pbi::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void CommandBatch::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::_pbi::DownCast<const CommandBatch*>(
+      &from));
+}
+
+void CommandBatch::MergeFrom(const CommandBatch& from) {
+  CommandBatch* const _this = this;
+  // @@protoc_insertion_point(class_specific_merge_from_start:declvol.v1.CommandBatch)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.commands_.MergeFrom(from._impl_.commands_);
+  _this->_internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void CommandBatch::CopyFrom(const CommandBatch& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:declvol.v1.CommandBatch)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool CommandBatch::IsInitialized() const {
+  return true;
+}
+
+void CommandBatch::InternalSwap(CommandBatch* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.commands_.InternalSwap(&other->_impl_.commands_);
+}
+
+std::string CommandBatch::GetTypeName() const {
+  return "declvol.v1.CommandBatch";
+}
+
+
+// ===================================================================
+
+class Command::_Internal {
+ public:
+  static const ::declvol::v1::SwitchProfileRequest& switch_profile(const Command* msg);
+  static const ::declvol::v1::SetOverride& set_override(const Command* msg);
+  static const ::declvol::v1::ClearOverrides& clear_overrides(const Command* msg);
+};
+
+const ::declvol::v1::SwitchProfileRequest&
+Command::_Internal::switch_profile(const Command* msg) {
+  return *msg->_impl_.command_.switch_profile_;
+}
+const ::declvol::v1::SetOverride&
+Command::_Internal::set_override(const Command* msg) {
+  return *msg->_impl_.command_.set_override_;
+}
+const ::declvol::v1::ClearOverrides&
+Command::_Internal::clear_overrides(const Command* msg) {
+  return *msg->_impl_.command_.clear_overrides_;
+}
+void Command::set_allocated_switch_profile(::declvol::v1::SwitchProfileRequest* switch_profile) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_command();
+  if (switch_profile) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(switch_profile);
+    if (message_arena != submessage_arena) {
+      switch_profile = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, switch_profile, submessage_arena);
+    }
+    set_has_switch_profile();
+    _impl_.command_.switch_profile_ = switch_profile;
+  }
+  // @@protoc_insertion_point(field_set_allocated:declvol.v1.Command.switch_profile)
+}
+void Command::set_allocated_set_override(::declvol::v1::SetOverride* set_override) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_command();
+  if (set_override) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(set_override);
+    if (message_arena != submessage_arena) {
+      set_override = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, set_override, submessage_arena);
+    }
+    set_has_set_override();
+    _impl_.command_.set_override_ = set_override;
+  }
+  // @@protoc_insertion_point(field_set_allocated:declvol.v1.Command.set_override)
+}
+void Command::set_allocated_clear_overrides(::declvol::v1::ClearOverrides* clear_overrides) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_command();
+  if (clear_overrides) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(clear_overrides);
+    if (message_arena != submessage_arena) {
+      clear_overrides = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, clear_overrides, submessage_arena);
+    }
+    set_has_clear_overrides();
+    _impl_.command_.clear_overrides_ = clear_overrides;
+  }
+  // @@protoc_insertion_point(field_set_allocated:declvol.v1.Command.clear_overrides)
+}
+Command::Command(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:declvol.v1.Command)
+}
+Command::Command(const Command& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite() {
+  Command* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.command_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}};
+
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  clear_has_command();
+  switch (from.command_case()) {
+    case kSwitchProfile: {
+      _this->_internal_mutable_switch_profile()->::declvol::v1::SwitchProfileRequest::MergeFrom(
+          from._internal_switch_profile());
+      break;
+    }
+    case kSetOverride: {
+      _this->_internal_mutable_set_override()->::declvol::v1::SetOverride::MergeFrom(
+          from._internal_set_override());
+      break;
+    }
+    case kClearOverrides: {
+      _this->_internal_mutable_clear_overrides()->::declvol::v1::ClearOverrides::MergeFrom(
+          from._internal_clear_overrides());
+      break;
+    }
+    case COMMAND_NOT_SET: {
+      break;
+    }
+  }
+  // @@protoc_insertion_point(copy_constructor:declvol.v1.Command)
+}
+
+inline void Command::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.command_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}
+  };
+  clear_has_command();
+}
+
+Command::~Command() {
+  // @@protoc_insertion_point(destructor:declvol.v1.Command)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<std::string>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void Command::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  if (has_command()) {
+    clear_command();
+  }
+}
+
+void Command::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void Command::clear_command() {
+// @@protoc_insertion_point(one_of_clear_start:declvol.v1.Command)
+  switch (command_case()) {
+    case kSwitchProfile: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.command_.switch_profile_;
+      }
+      break;
+    }
+    case kSetOverride: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.command_.set_override_;
+      }
+      break;
+    }
+    case kClearOverrides: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.command_.clear_overrides_;
+      }
+      break;
+    }
+    case COMMAND_NOT_SET: {
+      break;
+    }
+  }
+  _impl_._oneof_case_[0] = COMMAND_NOT_SET;
+}
+
+
+void Command::Clear() {
+// @@protoc_insertion_point(message_clear_start:declvol.v1.Command)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  clear_command();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* Command::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // .declvol.v1.SwitchProfileRequest switch_profile = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr = ctx->ParseMessage(_internal_mutable_switch_profile(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .declvol.v1.SetOverride set_override = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          ptr = ctx->ParseMessage(_internal_mutable_set_override(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .declvol.v1.ClearOverrides clear_overrides = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          ptr = ctx->ParseMessage(_internal_mutable_clear_overrides(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Command::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:declvol.v1.Command)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .declvol.v1.SwitchProfileRequest switch_profile = 1;
+  if (_internal_has_switch_profile()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(1, _Internal::switch_profile(this),
+        _Internal::switch_profile(this).GetCachedSize(), target, stream);
+  }
+
+  // .declvol.v1.SetOverride set_override = 2;
+  if (_internal_has_set_override()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(2, _Internal::set_override(this),
+        _Internal::set_override(this).GetCachedSize(), target, stream);
+  }
+
+  // .declvol.v1.ClearOverrides clear_overrides = 3;
+  if (_internal_has_clear_overrides()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(3, _Internal::clear_overrides(this),
+        _Internal::clear_overrides(this).GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:declvol.v1.Command)
+  return target;
+}
+
+size_t Command::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:declvol.v1.Command)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  switch (command_case()) {
+    // .declvol.v1.SwitchProfileRequest switch_profile = 1;
+    case kSwitchProfile: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.command_.switch_profile_);
+      break;
+    }
+    // .declvol.v1.SetOverride set_override = 2;
+    case kSetOverride: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.command_.set_override_);
+      break;
+    }
+    // .declvol.v1.ClearOverrides clear_overrides = 3;
+    case kClearOverrides: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.command_.clear_overrides_);
+      break;
+    }
+    case COMMAND_NOT_SET: {
+      break;
+    }
+  }
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::_pbi::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void Command::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::_pbi::DownCast<const Command*>(
+      &from));
+}
+
+void Command::MergeFrom(const Command& from) {
+  Command* const _this = this;
+  // @@protoc_insertion_point(class_specific_merge_from_start:declvol.v1.Command)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  switch (from.command_case()) {
+    case kSwitchProfile: {
+      _this->_internal_mutable_switch_profile()->::declvol::v1::SwitchProfileRequest::MergeFrom(
+          from._internal_switch_profile());
+      break;
+    }
+    case kSetOverride: {
+      _this->_internal_mutable_set_override()->::declvol::v1::SetOverride::MergeFrom(
+          from._internal_set_override());
+      break;
+    }
+    case kClearOverrides: {
+      _this->_internal_mutable_clear_overrides()->::declvol::v1::ClearOverrides::MergeFrom(
+          from._internal_clear_overrides());
+      break;
+    }
+    case COMMAND_NOT_SET: {
+      break;
+    }
+  }
+  _this->_internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void Command::CopyFrom(const Command& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:declvol.v1.Command)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Command::IsInitialized() const {
+  return true;
+}
+
+void Command::InternalSwap(Command* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_.command_, other->_impl_.command_);
+  swap(_impl_._oneof_case_[0], other->_impl_._oneof_case_[0]);
+}
+
+std::string Command::GetTypeName() const {
+  return "declvol.v1.Command";
+}
+
+
+// ===================================================================
+
+class SetOverride::_Internal {
+ public:
+};
+
+SetOverride::SetOverride(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:declvol.v1.SetOverride)
+}
+SetOverride::SetOverride(const SetOverride& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite() {
+  SetOverride* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.suffix_){}
+    , decltype(_impl_.volume_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  _impl_.suffix_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.suffix_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_suffix().empty()) {
+    _this->_impl_.suffix_.Set(from._internal_suffix(), 
+      _this->GetArenaForAllocation());
+  }
+  _this->_impl_.volume_ = from._impl_.volume_;
+  // @@protoc_insertion_point(copy_constructor:declvol.v1.SetOverride)
+}
+
+inline void SetOverride::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.suffix_){}
+    , decltype(_impl_.volume_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.suffix_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.suffix_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+SetOverride::~SetOverride() {
+  // @@protoc_insertion_point(destructor:declvol.v1.SetOverride)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<std::string>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void SetOverride::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.suffix_.Destroy();
+}
+
+void SetOverride::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void SetOverride::Clear() {
+// @@protoc_insertion_point(message_clear_start:declvol.v1.SetOverride)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.suffix_.ClearToEmpty();
+  _impl_.volume_ = 0;
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* SetOverride::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string suffix = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_suffix();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, nullptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // float volume = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 21)) {
+          _impl_.volume_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<float>(ptr);
+          ptr += sizeof(float);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* SetOverride::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:declvol.v1.SetOverride)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string suffix = 1;
+  if (!this->_internal_suffix().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_suffix().data(), static_cast<int>(this->_internal_suffix().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "declvol.v1.SetOverride.suffix");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_suffix(), target);
+  }
+
+  // float volume = 2;
+  static_assert(sizeof(uint32_t) == sizeof(float), "Code assumes uint32_t and float are the same size.");
+  float tmp_volume = this->_internal_volume();
+  uint32_t raw_volume;
+  memcpy(&raw_volume, &tmp_volume, sizeof(tmp_volume));
+  if (raw_volume != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFloatToArray(2, this->_internal_volume(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:declvol.v1.SetOverride)
+  return target;
+}
+
+size_t SetOverride::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:declvol.v1.SetOverride)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string suffix = 1;
+  if (!this->_internal_suffix().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_suffix());
+  }
+
+  // float volume = 2;
+  static_assert(sizeof(uint32_t) == sizeof(float), "Code assumes uint32_t and float are the same size.");
+  float tmp_volume = this->_internal_volume();
+  uint32_t raw_volume;
+  memcpy(&raw_volume, &tmp_volume, sizeof(tmp_volume));
+  if (raw_volume != 0) {
+    total_size += 1 + 4;
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::_pbi::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void SetOverride::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::_pbi::DownCast<const SetOverride*>(
+      &from));
+}
+
+void SetOverride::MergeFrom(const SetOverride& from) {
+  SetOverride* const _this = this;
+  // @@protoc_insertion_point(class_specific_merge_from_start:declvol.v1.SetOverride)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_suffix().empty()) {
+    _this->_internal_set_suffix(from._internal_suffix());
+  }
+  static_assert(sizeof(uint32_t) == sizeof(float), "Code assumes uint32_t and float are the same size.");
+  float tmp_volume = from._internal_volume();
+  uint32_t raw_volume;
+  memcpy(&raw_volume, &tmp_volume, sizeof(tmp_volume));
+  if (raw_volume != 0) {
+    _this->_internal_set_volume(from._internal_volume());
+  }
+  _this->_internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void SetOverride::CopyFrom(const SetOverride& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:declvol.v1.SetOverride)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool SetOverride::IsInitialized() const {
+  return true;
+}
+
+void SetOverride::InternalSwap(SetOverride* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.suffix_, lhs_arena,
+      &other->_impl_.suffix_, rhs_arena
+  );
+  swap(_impl_.volume_, other->_impl_.volume_);
+}
+
+std::string SetOverride::GetTypeName() const {
+  return "declvol.v1.SetOverride";
+}
+
+
+// ===================================================================
+
+class ClearOverrides::_Internal {
+ public:
+};
+
+ClearOverrides::ClearOverrides(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:declvol.v1.ClearOverrides)
+}
+ClearOverrides::ClearOverrides(const ClearOverrides& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite() {
+  ClearOverrides* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:declvol.v1.ClearOverrides)
+}
+
+inline void ClearOverrides::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+ClearOverrides::~ClearOverrides() {
+  // @@protoc_insertion_point(destructor:declvol.v1.ClearOverrides)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<std::string>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void ClearOverrides::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void ClearOverrides::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void ClearOverrides::Clear() {
+// @@protoc_insertion_point(message_clear_start:declvol.v1.ClearOverrides)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* ClearOverrides::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ClearOverrides::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:declvol.v1.ClearOverrides)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:declvol.v1.ClearOverrides)
+  return target;
+}
+
+size_t ClearOverrides::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:declvol.v1.ClearOverrides)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::_pbi::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void ClearOverrides::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::_pbi::DownCast<const ClearOverrides*>(
+      &from));
+}
+
+void ClearOverrides::MergeFrom(const ClearOverrides& from) {
+  ClearOverrides* const _this = this;
+  // @@protoc_insertion_point(class_specific_merge_from_start:declvol.v1.ClearOverrides)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void ClearOverrides::CopyFrom(const ClearOverrides& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:declvol.v1.ClearOverrides)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ClearOverrides::IsInitialized() const {
+  return true;
+}
+
+void ClearOverrides::InternalSwap(ClearOverrides* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+}
+
+std::string ClearOverrides::GetTypeName() const {
+  return "declvol.v1.ClearOverrides";
+}
+
+
+// @@protoc_insertion_point(namespace_scope)
+}  // namespace v1
+}  // namespace declvol
+PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::declvol::v1::SwitchProfileRequest*
+Arena::CreateMaybeMessage< ::declvol::v1::SwitchProfileRequest >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::declvol::v1::SwitchProfileRequest >(arena);
+}
+template<> PROTOBUF_NOINLINE ::declvol::v1::SwitchProfileResponse*
+Arena::CreateMaybeMessage< ::declvol::v1::SwitchProfileResponse >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::declvol::v1::SwitchProfileResponse >(arena);
+}
+template<> PROTOBUF_NOINLINE ::declvol::v1::CommandBatch*
+Arena::CreateMaybeMessage< ::declvol::v1::CommandBatch >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::declvol::v1::CommandBatch >(arena);
+}
+template<> PROTOBUF_NOINLINE ::declvol::v1::Command*
+Arena::CreateMaybeMessage< ::declvol::v1::Command >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::declvol::v1::Command >(arena);
+}
+template<> PROTOBUF_NOINLINE ::declvol::v1::SetOverride*
+Arena::CreateMaybeMessage< ::declvol::v1::SetOverride >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::declvol::v1::SetOverride >(arena);
+}
+template<> PROTOBUF_NOINLINE ::declvol::v1::ClearOverrides*
+Arena::CreateMaybeMessage< ::declvol::v1::ClearOverrides >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::declvol::v1::ClearOverrides >(arena);
 }
 PROTOBUF_NAMESPACE_CLOSE
 
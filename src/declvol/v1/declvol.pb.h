@@ -13,7 +13,7 @@
 #error incompatible with your Protocol Buffer headers. Please update
 #error your headers.
 #endif
-#if 3021004 < PROTOBUF_MIN_PROTOC_VERSION
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
 #error This file was generated by an older version of protoc which is
 #error incompatible with your Protocol Buffer headers. Please
 #error regenerate this file with a newer version of protoc.
@@ -28,6 +28,7 @@
 #include <google/protobuf/message_lite.h>
 #include <google/protobuf/repeated_field.h>  // IWYU pragma: export
 #include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/generated_enum_util.h>
 // @@protoc_insertion_point(includes)
 #include <google/protobuf/port_def.inc>
 #define PROTOBUF_INTERNAL_EXPORT_declvol_2fv1_2fdeclvol_2eproto
@@ -43,6 +44,18 @@ struct TableStruct_declvol_2fv1_2fdeclvol_2eproto {
 };
 namespace declvol {
 namespace v1 {
+class ClearOverrides;
+struct ClearOverridesDefaultTypeInternal;
+extern ClearOverridesDefaultTypeInternal _ClearOverrides_default_instance_;
+class Command;
+struct CommandDefaultTypeInternal;
+extern CommandDefaultTypeInternal _Command_default_instance_;
+class CommandBatch;
+struct CommandBatchDefaultTypeInternal;
+extern CommandBatchDefaultTypeInternal _CommandBatch_default_instance_;
+class SetOverride;
+struct SetOverrideDefaultTypeInternal;
+extern SetOverrideDefaultTypeInternal _SetOverride_default_instance_;
 class SwitchProfileRequest;
 struct SwitchProfileRequestDefaultTypeInternal;
 extern SwitchProfileRequestDefaultTypeInternal _SwitchProfileRequest_default_instance_;
@@ -52,32 +65,704 @@ extern SwitchProfileResponseDefaultTypeInternal _SwitchProfileResponse_default_i
 }  // namespace v1
 }  // namespace declvol
 PROTOBUF_NAMESPACE_OPEN
+template<> ::declvol::v1::ClearOverrides* Arena::CreateMaybeMessage<::declvol::v1::ClearOverrides>(Arena*);
+template<> ::declvol::v1::Command* Arena::CreateMaybeMessage<::declvol::v1::Command>(Arena*);
+template<> ::declvol::v1::CommandBatch* Arena::CreateMaybeMessage<::declvol::v1::CommandBatch>(Arena*);
+template<> ::declvol::v1::SetOverride* Arena::CreateMaybeMessage<::declvol::v1::SetOverride>(Arena*);
 template<> ::declvol::v1::SwitchProfileRequest* Arena::CreateMaybeMessage<::declvol::v1::SwitchProfileRequest>(Arena*);
 template<> ::declvol::v1::SwitchProfileResponse* Arena::CreateMaybeMessage<::declvol::v1::SwitchProfileResponse>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace declvol {
 namespace v1 {
 
+enum SwitchProfileRequest_Operation : int {
+  SwitchProfileRequest_Operation_OPERATION_REPLACE = 0,
+  SwitchProfileRequest_Operation_OPERATION_PUSH = 1,
+  SwitchProfileRequest_Operation_OPERATION_POP = 2,
+  SwitchProfileRequest_Operation_SwitchProfileRequest_Operation_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  SwitchProfileRequest_Operation_SwitchProfileRequest_Operation_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool SwitchProfileRequest_Operation_IsValid(int value);
+constexpr SwitchProfileRequest_Operation SwitchProfileRequest_Operation_Operation_MIN = SwitchProfileRequest_Operation_OPERATION_REPLACE;
+constexpr SwitchProfileRequest_Operation SwitchProfileRequest_Operation_Operation_MAX = SwitchProfileRequest_Operation_OPERATION_POP;
+constexpr int SwitchProfileRequest_Operation_Operation_ARRAYSIZE = SwitchProfileRequest_Operation_Operation_MAX + 1;
+
+const std::string& SwitchProfileRequest_Operation_Name(SwitchProfileRequest_Operation value);
+template<typename T>
+inline const std::string& SwitchProfileRequest_Operation_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, SwitchProfileRequest_Operation>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function SwitchProfileRequest_Operation_Name.");
+  return SwitchProfileRequest_Operation_Name(static_cast<SwitchProfileRequest_Operation>(enum_t_value));
+}
+bool SwitchProfileRequest_Operation_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, SwitchProfileRequest_Operation* value);
 // ===================================================================
 
-class SwitchProfileRequest final :
-    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:declvol.v1.SwitchProfileRequest) */ {
+class SwitchProfileRequest final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:declvol.v1.SwitchProfileRequest) */ {
+ public:
+  inline SwitchProfileRequest() : SwitchProfileRequest(nullptr) {}
+  ~SwitchProfileRequest() override;
+  explicit PROTOBUF_CONSTEXPR SwitchProfileRequest(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  SwitchProfileRequest(const SwitchProfileRequest& from);
+  SwitchProfileRequest(SwitchProfileRequest&& from) noexcept
+    : SwitchProfileRequest() {
+    *this = ::std::move(from);
+  }
+
+  inline SwitchProfileRequest& operator=(const SwitchProfileRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline SwitchProfileRequest& operator=(SwitchProfileRequest&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const SwitchProfileRequest& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const SwitchProfileRequest* internal_default_instance() {
+    return reinterpret_cast<const SwitchProfileRequest*>(
+               &_SwitchProfileRequest_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(SwitchProfileRequest& a, SwitchProfileRequest& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(SwitchProfileRequest* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(SwitchProfileRequest* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  SwitchProfileRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<SwitchProfileRequest>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const SwitchProfileRequest& from);
+  void MergeFrom(const SwitchProfileRequest& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(SwitchProfileRequest* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "declvol.v1.SwitchProfileRequest";
+  }
+  protected:
+  explicit SwitchProfileRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef SwitchProfileRequest_Operation Operation;
+  static constexpr Operation OPERATION_REPLACE =
+    SwitchProfileRequest_Operation_OPERATION_REPLACE;
+  static constexpr Operation OPERATION_PUSH =
+    SwitchProfileRequest_Operation_OPERATION_PUSH;
+  static constexpr Operation OPERATION_POP =
+    SwitchProfileRequest_Operation_OPERATION_POP;
+  static inline bool Operation_IsValid(int value) {
+    return SwitchProfileRequest_Operation_IsValid(value);
+  }
+  static constexpr Operation Operation_MIN =
+    SwitchProfileRequest_Operation_Operation_MIN;
+  static constexpr Operation Operation_MAX =
+    SwitchProfileRequest_Operation_Operation_MAX;
+  static constexpr int Operation_ARRAYSIZE =
+    SwitchProfileRequest_Operation_Operation_ARRAYSIZE;
+  template<typename T>
+  static inline const std::string& Operation_Name(T enum_t_value) {
+    static_assert(::std::is_same<T, Operation>::value ||
+      ::std::is_integral<T>::value,
+      "Incorrect type passed to function Operation_Name.");
+    return SwitchProfileRequest_Operation_Name(enum_t_value);
+  }
+  static inline bool Operation_Parse(::PROTOBUF_NAMESPACE_ID::ConstStringParam name,
+      Operation* value) {
+    return SwitchProfileRequest_Operation_Parse(name, value);
+  }
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kProfileFieldNumber = 1,
+    kConfigPathFieldNumber = 2,
+    kOperationFieldNumber = 3,
+  };
+  // string profile = 1;
+  void clear_profile();
+  const std::string& profile() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_profile(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_profile();
+  PROTOBUF_NODISCARD std::string* release_profile();
+  void set_allocated_profile(std::string* profile);
+  private:
+  const std::string& _internal_profile() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_profile(const std::string& value);
+  std::string* _internal_mutable_profile();
+  public:
+
+  // string config_path = 2;
+  void clear_config_path();
+  const std::string& config_path() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_config_path(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_config_path();
+  PROTOBUF_NODISCARD std::string* release_config_path();
+  void set_allocated_config_path(std::string* config_path);
+  private:
+  const std::string& _internal_config_path() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_config_path(const std::string& value);
+  std::string* _internal_mutable_config_path();
+  public:
+
+  // .declvol.v1.SwitchProfileRequest.Operation operation = 3;
+  void clear_operation();
+  ::declvol::v1::SwitchProfileRequest_Operation operation() const;
+  void set_operation(::declvol::v1::SwitchProfileRequest_Operation value);
+  private:
+  ::declvol::v1::SwitchProfileRequest_Operation _internal_operation() const;
+  void _internal_set_operation(::declvol::v1::SwitchProfileRequest_Operation value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:declvol.v1.SwitchProfileRequest)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr profile_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr config_path_;
+    int operation_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_declvol_2fv1_2fdeclvol_2eproto;
+};
+// -------------------------------------------------------------------
+
+class SwitchProfileResponse final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:declvol.v1.SwitchProfileResponse) */ {
+ public:
+  inline SwitchProfileResponse() : SwitchProfileResponse(nullptr) {}
+  ~SwitchProfileResponse() override;
+  explicit PROTOBUF_CONSTEXPR SwitchProfileResponse(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  SwitchProfileResponse(const SwitchProfileResponse& from);
+  SwitchProfileResponse(SwitchProfileResponse&& from) noexcept
+    : SwitchProfileResponse() {
+    *this = ::std::move(from);
+  }
+
+  inline SwitchProfileResponse& operator=(const SwitchProfileResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline SwitchProfileResponse& operator=(SwitchProfileResponse&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const SwitchProfileResponse& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const SwitchProfileResponse* internal_default_instance() {
+    return reinterpret_cast<const SwitchProfileResponse*>(
+               &_SwitchProfileResponse_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(SwitchProfileResponse& a, SwitchProfileResponse& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(SwitchProfileResponse* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(SwitchProfileResponse* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  SwitchProfileResponse* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<SwitchProfileResponse>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const SwitchProfileResponse& from);
+  void MergeFrom(const SwitchProfileResponse& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(SwitchProfileResponse* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "declvol.v1.SwitchProfileResponse";
+  }
+  protected:
+  explicit SwitchProfileResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // @@protoc_insertion_point(class_scope:declvol.v1.SwitchProfileResponse)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_declvol_2fv1_2fdeclvol_2eproto;
+};
+// -------------------------------------------------------------------
+
+class CommandBatch final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:declvol.v1.CommandBatch) */ {
+ public:
+  inline CommandBatch() : CommandBatch(nullptr) {}
+  ~CommandBatch() override;
+  explicit PROTOBUF_CONSTEXPR CommandBatch(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  CommandBatch(const CommandBatch& from);
+  CommandBatch(CommandBatch&& from) noexcept
+    : CommandBatch() {
+    *this = ::std::move(from);
+  }
+
+  inline CommandBatch& operator=(const CommandBatch& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline CommandBatch& operator=(CommandBatch&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const CommandBatch& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const CommandBatch* internal_default_instance() {
+    return reinterpret_cast<const CommandBatch*>(
+               &_CommandBatch_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    2;
+
+  friend void swap(CommandBatch& a, CommandBatch& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(CommandBatch* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(CommandBatch* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  CommandBatch* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<CommandBatch>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const CommandBatch& from);
+  void MergeFrom(const CommandBatch& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(CommandBatch* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "declvol.v1.CommandBatch";
+  }
+  protected:
+  explicit CommandBatch(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kCommandsFieldNumber = 4,
+  };
+  // repeated .declvol.v1.Command commands = 4;
+  int commands_size() const;
+  private:
+  int _internal_commands_size() const;
+  public:
+  void clear_commands();
+  ::declvol::v1::Command* mutable_commands(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::declvol::v1::Command >*
+      mutable_commands();
+  private:
+  const ::declvol::v1::Command& _internal_commands(int index) const;
+  ::declvol::v1::Command* _internal_add_commands();
+  public:
+  const ::declvol::v1::Command& commands(int index) const;
+  ::declvol::v1::Command* add_commands();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::declvol::v1::Command >&
+      commands() const;
+
+  // @@protoc_insertion_point(class_scope:declvol.v1.CommandBatch)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::declvol::v1::Command > commands_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_declvol_2fv1_2fdeclvol_2eproto;
+};
+// -------------------------------------------------------------------
+
+class Command final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:declvol.v1.Command) */ {
+ public:
+  inline Command() : Command(nullptr) {}
+  ~Command() override;
+  explicit PROTOBUF_CONSTEXPR Command(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  Command(const Command& from);
+  Command(Command&& from) noexcept
+    : Command() {
+    *this = ::std::move(from);
+  }
+
+  inline Command& operator=(const Command& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline Command& operator=(Command&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const Command& default_instance() {
+    return *internal_default_instance();
+  }
+  enum CommandCase {
+    kSwitchProfile = 1,
+    kSetOverride = 2,
+    kClearOverrides = 3,
+    COMMAND_NOT_SET = 0,
+  };
+
+  static inline const Command* internal_default_instance() {
+    return reinterpret_cast<const Command*>(
+               &_Command_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    3;
+
+  friend void swap(Command& a, Command& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(Command* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Command* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  Command* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<Command>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const Command& from);
+  void MergeFrom(const Command& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(Command* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "declvol.v1.Command";
+  }
+  protected:
+  explicit Command(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kSwitchProfileFieldNumber = 1,
+    kSetOverrideFieldNumber = 2,
+    kClearOverridesFieldNumber = 3,
+  };
+  // .declvol.v1.SwitchProfileRequest switch_profile = 1;
+  bool has_switch_profile() const;
+  private:
+  bool _internal_has_switch_profile() const;
+  public:
+  void clear_switch_profile();
+  const ::declvol::v1::SwitchProfileRequest& switch_profile() const;
+  PROTOBUF_NODISCARD ::declvol::v1::SwitchProfileRequest* release_switch_profile();
+  ::declvol::v1::SwitchProfileRequest* mutable_switch_profile();
+  void set_allocated_switch_profile(::declvol::v1::SwitchProfileRequest* switch_profile);
+  private:
+  const ::declvol::v1::SwitchProfileRequest& _internal_switch_profile() const;
+  ::declvol::v1::SwitchProfileRequest* _internal_mutable_switch_profile();
+  public:
+  void unsafe_arena_set_allocated_switch_profile(
+      ::declvol::v1::SwitchProfileRequest* switch_profile);
+  ::declvol::v1::SwitchProfileRequest* unsafe_arena_release_switch_profile();
+
+  // .declvol.v1.SetOverride set_override = 2;
+  bool has_set_override() const;
+  private:
+  bool _internal_has_set_override() const;
+  public:
+  void clear_set_override();
+  const ::declvol::v1::SetOverride& set_override() const;
+  PROTOBUF_NODISCARD ::declvol::v1::SetOverride* release_set_override();
+  ::declvol::v1::SetOverride* mutable_set_override();
+  void set_allocated_set_override(::declvol::v1::SetOverride* set_override);
+  private:
+  const ::declvol::v1::SetOverride& _internal_set_override() const;
+  ::declvol::v1::SetOverride* _internal_mutable_set_override();
+  public:
+  void unsafe_arena_set_allocated_set_override(
+      ::declvol::v1::SetOverride* set_override);
+  ::declvol::v1::SetOverride* unsafe_arena_release_set_override();
+
+  // .declvol.v1.ClearOverrides clear_overrides = 3;
+  bool has_clear_overrides() const;
+  private:
+  bool _internal_has_clear_overrides() const;
+  public:
+  void clear_clear_overrides();
+  const ::declvol::v1::ClearOverrides& clear_overrides() const;
+  PROTOBUF_NODISCARD ::declvol::v1::ClearOverrides* release_clear_overrides();
+  ::declvol::v1::ClearOverrides* mutable_clear_overrides();
+  void set_allocated_clear_overrides(::declvol::v1::ClearOverrides* clear_overrides);
+  private:
+  const ::declvol::v1::ClearOverrides& _internal_clear_overrides() const;
+  ::declvol::v1::ClearOverrides* _internal_mutable_clear_overrides();
+  public:
+  void unsafe_arena_set_allocated_clear_overrides(
+      ::declvol::v1::ClearOverrides* clear_overrides);
+  ::declvol::v1::ClearOverrides* unsafe_arena_release_clear_overrides();
+
+  void clear_command();
+  CommandCase command_case() const;
+  // @@protoc_insertion_point(class_scope:declvol.v1.Command)
+ private:
+  class _Internal;
+  void set_has_switch_profile();
+  void set_has_set_override();
+  void set_has_clear_overrides();
+
+  inline bool has_command() const;
+  inline void clear_has_command();
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    union CommandUnion {
+      constexpr CommandUnion() : _constinit_{} {}
+        ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized _constinit_;
+      ::declvol::v1::SwitchProfileRequest* switch_profile_;
+      ::declvol::v1::SetOverride* set_override_;
+      ::declvol::v1::ClearOverrides* clear_overrides_;
+    } command_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    uint32_t _oneof_case_[1];
+
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_declvol_2fv1_2fdeclvol_2eproto;
+};
+// -------------------------------------------------------------------
+
+class SetOverride final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:declvol.v1.SetOverride) */ {
  public:
-  inline SwitchProfileRequest() : SwitchProfileRequest(nullptr) {}
-  ~SwitchProfileRequest() override;
-  explicit PROTOBUF_CONSTEXPR SwitchProfileRequest(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+  inline SetOverride() : SetOverride(nullptr) {}
+  ~SetOverride() override;
+  explicit PROTOBUF_CONSTEXPR SetOverride(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
-  SwitchProfileRequest(const SwitchProfileRequest& from);
-  SwitchProfileRequest(SwitchProfileRequest&& from) noexcept
-    : SwitchProfileRequest() {
+  SetOverride(const SetOverride& from);
+  SetOverride(SetOverride&& from) noexcept
+    : SetOverride() {
     *this = ::std::move(from);
   }
 
-  inline SwitchProfileRequest& operator=(const SwitchProfileRequest& from) {
+  inline SetOverride& operator=(const SetOverride& from) {
     CopyFrom(from);
     return *this;
   }
-  inline SwitchProfileRequest& operator=(SwitchProfileRequest&& from) noexcept {
+  inline SetOverride& operator=(SetOverride&& from) noexcept {
     if (this == &from) return *this;
     if (GetOwningArena() == from.GetOwningArena()
   #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
@@ -91,20 +776,20 @@ class SwitchProfileRequest final :
     return *this;
   }
 
-  static const SwitchProfileRequest& default_instance() {
+  static const SetOverride& default_instance() {
     return *internal_default_instance();
   }
-  static inline const SwitchProfileRequest* internal_default_instance() {
-    return reinterpret_cast<const SwitchProfileRequest*>(
-               &_SwitchProfileRequest_default_instance_);
+  static inline const SetOverride* internal_default_instance() {
+    return reinterpret_cast<const SetOverride*>(
+               &_SetOverride_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    0;
+    4;
 
-  friend void swap(SwitchProfileRequest& a, SwitchProfileRequest& b) {
+  friend void swap(SetOverride& a, SetOverride& b) {
     a.Swap(&b);
   }
-  inline void Swap(SwitchProfileRequest* other) {
+  inline void Swap(SetOverride* other) {
     if (other == this) return;
   #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
     if (GetOwningArena() != nullptr &&
@@ -117,7 +802,7 @@ class SwitchProfileRequest final :
       ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
     }
   }
-  void UnsafeArenaSwap(SwitchProfileRequest* other) {
+  void UnsafeArenaSwap(SetOverride* other) {
     if (other == this) return;
     GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
     InternalSwap(other);
@@ -125,12 +810,12 @@ class SwitchProfileRequest final :
 
   // implements Message ----------------------------------------------
 
-  SwitchProfileRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
-    return CreateMaybeMessage<SwitchProfileRequest>(arena);
+  SetOverride* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<SetOverride>(arena);
   }
   void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
-  void CopyFrom(const SwitchProfileRequest& from);
-  void MergeFrom(const SwitchProfileRequest& from);
+  void CopyFrom(const SetOverride& from);
+  void MergeFrom(const SetOverride& from);
   PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
 
@@ -144,15 +829,15 @@ class SwitchProfileRequest final :
   void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const;
-  void InternalSwap(SwitchProfileRequest* other);
+  void InternalSwap(SetOverride* other);
 
   private:
   friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
   static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
-    return "declvol.v1.SwitchProfileRequest";
+    return "declvol.v1.SetOverride";
   }
   protected:
-  explicit SwitchProfileRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+  explicit SetOverride(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                        bool is_message_owned = false);
   public:
 
@@ -163,38 +848,33 @@ class SwitchProfileRequest final :
   // accessors -------------------------------------------------------
 
   enum : int {
-    kProfileFieldNumber = 1,
-    kConfigPathFieldNumber = 2,
+    kSuffixFieldNumber = 1,
+    kVolumeFieldNumber = 2,
   };
-  // string profile = 1;
-  void clear_profile();
-  const std::string& profile() const;
+  // string suffix = 1;
+  void clear_suffix();
+  const std::string& suffix() const;
   template <typename ArgT0 = const std::string&, typename... ArgT>
-  void set_profile(ArgT0&& arg0, ArgT... args);
-  std::string* mutable_profile();
-  PROTOBUF_NODISCARD std::string* release_profile();
-  void set_allocated_profile(std::string* profile);
+  void set_suffix(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_suffix();
+  PROTOBUF_NODISCARD std::string* release_suffix();
+  void set_allocated_suffix(std::string* suffix);
   private:
-  const std::string& _internal_profile() const;
-  inline PROTOBUF_ALWAYS_INLINE void _internal_set_profile(const std::string& value);
-  std::string* _internal_mutable_profile();
+  const std::string& _internal_suffix() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_suffix(const std::string& value);
+  std::string* _internal_mutable_suffix();
   public:
 
-  // string config_path = 2;
-  void clear_config_path();
-  const std::string& config_path() const;
-  template <typename ArgT0 = const std::string&, typename... ArgT>
-  void set_config_path(ArgT0&& arg0, ArgT... args);
-  std::string* mutable_config_path();
-  PROTOBUF_NODISCARD std::string* release_config_path();
-  void set_allocated_config_path(std::string* config_path);
+  // float volume = 2;
+  void clear_volume();
+  float volume() const;
+  void set_volume(float value);
   private:
-  const std::string& _internal_config_path() const;
-  inline PROTOBUF_ALWAYS_INLINE void _internal_set_config_path(const std::string& value);
-  std::string* _internal_mutable_config_path();
+  float _internal_volume() const;
+  void _internal_set_volume(float value);
   public:
 
-  // @@protoc_insertion_point(class_scope:declvol.v1.SwitchProfileRequest)
+  // @@protoc_insertion_point(class_scope:declvol.v1.SetOverride)
  private:
   class _Internal;
 
@@ -202,8 +882,8 @@ class SwitchProfileRequest final :
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
   struct Impl_ {
-    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr profile_;
-    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr config_path_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr suffix_;
+    float volume_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -211,24 +891,24 @@ class SwitchProfileRequest final :
 };
 // -------------------------------------------------------------------
 
-class SwitchProfileResponse final :
-    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:declvol.v1.SwitchProfileResponse) */ {
+class ClearOverrides final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:declvol.v1.ClearOverrides) */ {
  public:
-  inline SwitchProfileResponse() : SwitchProfileResponse(nullptr) {}
-  ~SwitchProfileResponse() override;
-  explicit PROTOBUF_CONSTEXPR SwitchProfileResponse(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+  inline ClearOverrides() : ClearOverrides(nullptr) {}
+  ~ClearOverrides() override;
+  explicit PROTOBUF_CONSTEXPR ClearOverrides(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
-  SwitchProfileResponse(const SwitchProfileResponse& from);
-  SwitchProfileResponse(SwitchProfileResponse&& from) noexcept
-    : SwitchProfileResponse() {
+  ClearOverrides(const ClearOverrides& from);
+  ClearOverrides(ClearOverrides&& from) noexcept
+    : ClearOverrides() {
     *this = ::std::move(from);
   }
 
-  inline SwitchProfileResponse& operator=(const SwitchProfileResponse& from) {
+  inline ClearOverrides& operator=(const ClearOverrides& from) {
     CopyFrom(from);
     return *this;
   }
-  inline SwitchProfileResponse& operator=(SwitchProfileResponse&& from) noexcept {
+  inline ClearOverrides& operator=(ClearOverrides&& from) noexcept {
     if (this == &from) return *this;
     if (GetOwningArena() == from.GetOwningArena()
   #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
@@ -242,20 +922,20 @@ class SwitchProfileResponse final :
     return *this;
   }
 
-  static const SwitchProfileResponse& default_instance() {
+  static const ClearOverrides& default_instance() {
     return *internal_default_instance();
   }
-  static inline const SwitchProfileResponse* internal_default_instance() {
-    return reinterpret_cast<const SwitchProfileResponse*>(
-               &_SwitchProfileResponse_default_instance_);
+  static inline const ClearOverrides* internal_default_instance() {
+    return reinterpret_cast<const ClearOverrides*>(
+               &_ClearOverrides_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    1;
+    5;
 
-  friend void swap(SwitchProfileResponse& a, SwitchProfileResponse& b) {
+  friend void swap(ClearOverrides& a, ClearOverrides& b) {
     a.Swap(&b);
   }
-  inline void Swap(SwitchProfileResponse* other) {
+  inline void Swap(ClearOverrides* other) {
     if (other == this) return;
   #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
     if (GetOwningArena() != nullptr &&
@@ -268,7 +948,7 @@ class SwitchProfileResponse final :
       ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
     }
   }
-  void UnsafeArenaSwap(SwitchProfileResponse* other) {
+  void UnsafeArenaSwap(ClearOverrides* other) {
     if (other == this) return;
     GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
     InternalSwap(other);
@@ -276,12 +956,12 @@ class SwitchProfileResponse final :
 
   // implements Message ----------------------------------------------
 
-  SwitchProfileResponse* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
-    return CreateMaybeMessage<SwitchProfileResponse>(arena);
+  ClearOverrides* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ClearOverrides>(arena);
   }
   void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
-  void CopyFrom(const SwitchProfileResponse& from);
-  void MergeFrom(const SwitchProfileResponse& from);
+  void CopyFrom(const ClearOverrides& from);
+  void MergeFrom(const ClearOverrides& from);
   PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
 
@@ -295,15 +975,15 @@ class SwitchProfileResponse final :
   void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const;
-  void InternalSwap(SwitchProfileResponse* other);
+  void InternalSwap(ClearOverrides* other);
 
   private:
   friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
   static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
-    return "declvol.v1.SwitchProfileResponse";
+    return "declvol.v1.ClearOverrides";
   }
   protected:
-  explicit SwitchProfileResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+  explicit ClearOverrides(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                        bool is_message_owned = false);
   public:
 
@@ -313,7 +993,7 @@ class SwitchProfileResponse final :
 
   // accessors -------------------------------------------------------
 
-  // @@protoc_insertion_point(class_scope:declvol.v1.SwitchProfileResponse)
+  // @@protoc_insertion_point(class_scope:declvol.v1.ClearOverrides)
  private:
   class _Internal;
 
@@ -437,21 +1117,412 @@ inline void SwitchProfileRequest::set_allocated_config_path(std::string* config_
   // @@protoc_insertion_point(field_set_allocated:declvol.v1.SwitchProfileRequest.config_path)
 }
 
+// .declvol.v1.SwitchProfileRequest.Operation operation = 3;
+inline void SwitchProfileRequest::clear_operation() {
+  _impl_.operation_ = 0;
+}
+inline ::declvol::v1::SwitchProfileRequest_Operation SwitchProfileRequest::_internal_operation() const {
+  return static_cast< ::declvol::v1::SwitchProfileRequest_Operation >(_impl_.operation_);
+}
+inline ::declvol::v1::SwitchProfileRequest_Operation SwitchProfileRequest::operation() const {
+  // @@protoc_insertion_point(field_get:declvol.v1.SwitchProfileRequest.operation)
+  return _internal_operation();
+}
+inline void SwitchProfileRequest::_internal_set_operation(::declvol::v1::SwitchProfileRequest_Operation value) {
+  
+  _impl_.operation_ = value;
+}
+inline void SwitchProfileRequest::set_operation(::declvol::v1::SwitchProfileRequest_Operation value) {
+  _internal_set_operation(value);
+  // @@protoc_insertion_point(field_set:declvol.v1.SwitchProfileRequest.operation)
+}
+
 // -------------------------------------------------------------------
 
 // SwitchProfileResponse
 
+// -------------------------------------------------------------------
+
+// CommandBatch
+
+// repeated .declvol.v1.Command commands = 4;
+inline int CommandBatch::_internal_commands_size() const {
+  return _impl_.commands_.size();
+}
+inline int CommandBatch::commands_size() const {
+  return _internal_commands_size();
+}
+inline void CommandBatch::clear_commands() {
+  _impl_.commands_.Clear();
+}
+inline ::declvol::v1::Command* CommandBatch::mutable_commands(int index) {
+  // @@protoc_insertion_point(field_mutable:declvol.v1.CommandBatch.commands)
+  return _impl_.commands_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::declvol::v1::Command >*
+CommandBatch::mutable_commands() {
+  // @@protoc_insertion_point(field_mutable_list:declvol.v1.CommandBatch.commands)
+  return &_impl_.commands_;
+}
+inline const ::declvol::v1::Command& CommandBatch::_internal_commands(int index) const {
+  return _impl_.commands_.Get(index);
+}
+inline const ::declvol::v1::Command& CommandBatch::commands(int index) const {
+  // @@protoc_insertion_point(field_get:declvol.v1.CommandBatch.commands)
+  return _internal_commands(index);
+}
+inline ::declvol::v1::Command* CommandBatch::_internal_add_commands() {
+  return _impl_.commands_.Add();
+}
+inline ::declvol::v1::Command* CommandBatch::add_commands() {
+  ::declvol::v1::Command* _add = _internal_add_commands();
+  // @@protoc_insertion_point(field_add:declvol.v1.CommandBatch.commands)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::declvol::v1::Command >&
+CommandBatch::commands() const {
+  // @@protoc_insertion_point(field_list:declvol.v1.CommandBatch.commands)
+  return _impl_.commands_;
+}
+
+// -------------------------------------------------------------------
+
+// Command
+
+// .declvol.v1.SwitchProfileRequest switch_profile = 1;
+inline bool Command::_internal_has_switch_profile() const {
+  return command_case() == kSwitchProfile;
+}
+inline bool Command::has_switch_profile() const {
+  return _internal_has_switch_profile();
+}
+inline void Command::set_has_switch_profile() {
+  _impl_._oneof_case_[0] = kSwitchProfile;
+}
+inline void Command::clear_switch_profile() {
+  if (_internal_has_switch_profile()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.command_.switch_profile_;
+    }
+    clear_has_command();
+  }
+}
+inline ::declvol::v1::SwitchProfileRequest* Command::release_switch_profile() {
+  // @@protoc_insertion_point(field_release:declvol.v1.Command.switch_profile)
+  if (_internal_has_switch_profile()) {
+    clear_has_command();
+    ::declvol::v1::SwitchProfileRequest* temp = _impl_.command_.switch_profile_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.command_.switch_profile_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::declvol::v1::SwitchProfileRequest& Command::_internal_switch_profile() const {
+  return _internal_has_switch_profile()
+      ? *_impl_.command_.switch_profile_
+      : reinterpret_cast< ::declvol::v1::SwitchProfileRequest&>(::declvol::v1::_SwitchProfileRequest_default_instance_);
+}
+inline const ::declvol::v1::SwitchProfileRequest& Command::switch_profile() const {
+  // @@protoc_insertion_point(field_get:declvol.v1.Command.switch_profile)
+  return _internal_switch_profile();
+}
+inline ::declvol::v1::SwitchProfileRequest* Command::unsafe_arena_release_switch_profile() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:declvol.v1.Command.switch_profile)
+  if (_internal_has_switch_profile()) {
+    clear_has_command();
+    ::declvol::v1::SwitchProfileRequest* temp = _impl_.command_.switch_profile_;
+    _impl_.command_.switch_profile_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Command::unsafe_arena_set_allocated_switch_profile(::declvol::v1::SwitchProfileRequest* switch_profile) {
+  clear_command();
+  if (switch_profile) {
+    set_has_switch_profile();
+    _impl_.command_.switch_profile_ = switch_profile;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:declvol.v1.Command.switch_profile)
+}
+inline ::declvol::v1::SwitchProfileRequest* Command::_internal_mutable_switch_profile() {
+  if (!_internal_has_switch_profile()) {
+    clear_command();
+    set_has_switch_profile();
+    _impl_.command_.switch_profile_ = CreateMaybeMessage< ::declvol::v1::SwitchProfileRequest >(GetArenaForAllocation());
+  }
+  return _impl_.command_.switch_profile_;
+}
+inline ::declvol::v1::SwitchProfileRequest* Command::mutable_switch_profile() {
+  ::declvol::v1::SwitchProfileRequest* _msg = _internal_mutable_switch_profile();
+  // @@protoc_insertion_point(field_mutable:declvol.v1.Command.switch_profile)
+  return _msg;
+}
+
+// .declvol.v1.SetOverride set_override = 2;
+inline bool Command::_internal_has_set_override() const {
+  return command_case() == kSetOverride;
+}
+inline bool Command::has_set_override() const {
+  return _internal_has_set_override();
+}
+inline void Command::set_has_set_override() {
+  _impl_._oneof_case_[0] = kSetOverride;
+}
+inline void Command::clear_set_override() {
+  if (_internal_has_set_override()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.command_.set_override_;
+    }
+    clear_has_command();
+  }
+}
+inline ::declvol::v1::SetOverride* Command::release_set_override() {
+  // @@protoc_insertion_point(field_release:declvol.v1.Command.set_override)
+  if (_internal_has_set_override()) {
+    clear_has_command();
+    ::declvol::v1::SetOverride* temp = _impl_.command_.set_override_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.command_.set_override_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::declvol::v1::SetOverride& Command::_internal_set_override() const {
+  return _internal_has_set_override()
+      ? *_impl_.command_.set_override_
+      : reinterpret_cast< ::declvol::v1::SetOverride&>(::declvol::v1::_SetOverride_default_instance_);
+}
+inline const ::declvol::v1::SetOverride& Command::set_override() const {
+  // @@protoc_insertion_point(field_get:declvol.v1.Command.set_override)
+  return _internal_set_override();
+}
+inline ::declvol::v1::SetOverride* Command::unsafe_arena_release_set_override() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:declvol.v1.Command.set_override)
+  if (_internal_has_set_override()) {
+    clear_has_command();
+    ::declvol::v1::SetOverride* temp = _impl_.command_.set_override_;
+    _impl_.command_.set_override_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Command::unsafe_arena_set_allocated_set_override(::declvol::v1::SetOverride* set_override) {
+  clear_command();
+  if (set_override) {
+    set_has_set_override();
+    _impl_.command_.set_override_ = set_override;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:declvol.v1.Command.set_override)
+}
+inline ::declvol::v1::SetOverride* Command::_internal_mutable_set_override() {
+  if (!_internal_has_set_override()) {
+    clear_command();
+    set_has_set_override();
+    _impl_.command_.set_override_ = CreateMaybeMessage< ::declvol::v1::SetOverride >(GetArenaForAllocation());
+  }
+  return _impl_.command_.set_override_;
+}
+inline ::declvol::v1::SetOverride* Command::mutable_set_override() {
+  ::declvol::v1::SetOverride* _msg = _internal_mutable_set_override();
+  // @@protoc_insertion_point(field_mutable:declvol.v1.Command.set_override)
+  return _msg;
+}
+
+// .declvol.v1.ClearOverrides clear_overrides = 3;
+inline bool Command::_internal_has_clear_overrides() const {
+  return command_case() == kClearOverrides;
+}
+inline bool Command::has_clear_overrides() const {
+  return _internal_has_clear_overrides();
+}
+inline void Command::set_has_clear_overrides() {
+  _impl_._oneof_case_[0] = kClearOverrides;
+}
+inline void Command::clear_clear_overrides() {
+  if (_internal_has_clear_overrides()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.command_.clear_overrides_;
+    }
+    clear_has_command();
+  }
+}
+inline ::declvol::v1::ClearOverrides* Command::release_clear_overrides() {
+  // @@protoc_insertion_point(field_release:declvol.v1.Command.clear_overrides)
+  if (_internal_has_clear_overrides()) {
+    clear_has_command();
+    ::declvol::v1::ClearOverrides* temp = _impl_.command_.clear_overrides_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.command_.clear_overrides_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::declvol::v1::ClearOverrides& Command::_internal_clear_overrides() const {
+  return _internal_has_clear_overrides()
+      ? *_impl_.command_.clear_overrides_
+      : reinterpret_cast< ::declvol::v1::ClearOverrides&>(::declvol::v1::_ClearOverrides_default_instance_);
+}
+inline const ::declvol::v1::ClearOverrides& Command::clear_overrides() const {
+  // @@protoc_insertion_point(field_get:declvol.v1.Command.clear_overrides)
+  return _internal_clear_overrides();
+}
+inline ::declvol::v1::ClearOverrides* Command::unsafe_arena_release_clear_overrides() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:declvol.v1.Command.clear_overrides)
+  if (_internal_has_clear_overrides()) {
+    clear_has_command();
+    ::declvol::v1::ClearOverrides* temp = _impl_.command_.clear_overrides_;
+    _impl_.command_.clear_overrides_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void Command::unsafe_arena_set_allocated_clear_overrides(::declvol::v1::ClearOverrides* clear_overrides) {
+  clear_command();
+  if (clear_overrides) {
+    set_has_clear_overrides();
+    _impl_.command_.clear_overrides_ = clear_overrides;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:declvol.v1.Command.clear_overrides)
+}
+inline ::declvol::v1::ClearOverrides* Command::_internal_mutable_clear_overrides() {
+  if (!_internal_has_clear_overrides()) {
+    clear_command();
+    set_has_clear_overrides();
+    _impl_.command_.clear_overrides_ = CreateMaybeMessage< ::declvol::v1::ClearOverrides >(GetArenaForAllocation());
+  }
+  return _impl_.command_.clear_overrides_;
+}
+inline ::declvol::v1::ClearOverrides* Command::mutable_clear_overrides() {
+  ::declvol::v1::ClearOverrides* _msg = _internal_mutable_clear_overrides();
+  // @@protoc_insertion_point(field_mutable:declvol.v1.Command.clear_overrides)
+  return _msg;
+}
+
+inline bool Command::has_command() const {
+  return command_case() != COMMAND_NOT_SET;
+}
+inline void Command::clear_has_command() {
+  _impl_._oneof_case_[0] = COMMAND_NOT_SET;
+}
+inline Command::CommandCase Command::command_case() const {
+  return Command::CommandCase(_impl_._oneof_case_[0]);
+}
+// -------------------------------------------------------------------
+
+// SetOverride
+
+// string suffix = 1;
+inline void SetOverride::clear_suffix() {
+  _impl_.suffix_.ClearToEmpty();
+}
+inline const std::string& SetOverride::suffix() const {
+  // @@protoc_insertion_point(field_get:declvol.v1.SetOverride.suffix)
+  return _internal_suffix();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void SetOverride::set_suffix(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.suffix_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:declvol.v1.SetOverride.suffix)
+}
+inline std::string* SetOverride::mutable_suffix() {
+  std::string* _s = _internal_mutable_suffix();
+  // @@protoc_insertion_point(field_mutable:declvol.v1.SetOverride.suffix)
+  return _s;
+}
+inline const std::string& SetOverride::_internal_suffix() const {
+  return _impl_.suffix_.Get();
+}
+inline void SetOverride::_internal_set_suffix(const std::string& value) {
+  
+  _impl_.suffix_.Set(value, GetArenaForAllocation());
+}
+inline std::string* SetOverride::_internal_mutable_suffix() {
+  
+  return _impl_.suffix_.Mutable(GetArenaForAllocation());
+}
+inline std::string* SetOverride::release_suffix() {
+  // @@protoc_insertion_point(field_release:declvol.v1.SetOverride.suffix)
+  return _impl_.suffix_.Release();
+}
+inline void SetOverride::set_allocated_suffix(std::string* suffix) {
+  if (suffix != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.suffix_.SetAllocated(suffix, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.suffix_.IsDefault()) {
+    _impl_.suffix_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:declvol.v1.SetOverride.suffix)
+}
+
+// float volume = 2;
+inline void SetOverride::clear_volume() {
+  _impl_.volume_ = 0;
+}
+inline float SetOverride::_internal_volume() const {
+  return _impl_.volume_;
+}
+inline float SetOverride::volume() const {
+  // @@protoc_insertion_point(field_get:declvol.v1.SetOverride.volume)
+  return _internal_volume();
+}
+inline void SetOverride::_internal_set_volume(float value) {
+  
+  _impl_.volume_ = value;
+}
+inline void SetOverride::set_volume(float value) {
+  _internal_set_volume(value);
+  // @@protoc_insertion_point(field_set:declvol.v1.SetOverride.volume)
+}
+
+// -------------------------------------------------------------------
+
+// ClearOverrides
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
 }  // namespace v1
 }  // namespace declvol
 
+PROTOBUF_NAMESPACE_OPEN
+
+template <> struct is_proto_enum< ::declvol::v1::SwitchProfileRequest_Operation> : ::std::true_type {};
+
+PROTOBUF_NAMESPACE_CLOSE
+
 // @@protoc_insertion_point(global_scope)
 
 #include <google/protobuf/port_undef.inc>
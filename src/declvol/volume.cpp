@@ -1,9 +1,126 @@
 #include "declvol/volume.h"
 
-#include <endpointvolume.h>
+#include <memory>
+#include <stdexcept>
 
 namespace em {
 
+// {5C1C7D0E-3F9B-4E2A-9A61-0D8E2B7F4C93}
+const GUID VolumeSetterEventContext{
+    0x5c1c7d0e, 0x3f9b, 0x4e2a, {0x9a, 0x61, 0x0d, 0x8e, 0x2b, 0x7f, 0x4c, 0x93}};
+
+namespace {
+
+/**
+ * Ramp target for the master volume of an audio session.
+ */
+class SessionRampTarget final : public RampTarget {
+public:
+  explicit SessionRampTarget(winrt::com_ptr<ISimpleAudioVolume> volume)
+      : mVolume{std::move(volume)} {}
+
+  float volume() override {
+    float v;
+    winrt::check_hresult(mVolume->GetMasterVolume(&v));
+    return v;
+  }
+
+  void set_volume(float v) override {
+    winrt::check_hresult(mVolume->SetMasterVolume(v, &VolumeSetterEventContext));
+  }
+
+private:
+  winrt::com_ptr<ISimpleAudioVolume> mVolume;
+};
+
+/**
+ * Ramp target for the master volume of an audio device.
+ */
+class DeviceRampTarget final : public RampTarget {
+public:
+  explicit DeviceRampTarget(winrt::com_ptr<IAudioEndpointVolume> volume)
+      : mVolume{std::move(volume)} {}
+
+  float volume() override {
+    float v;
+    winrt::check_hresult(mVolume->GetMasterVolumeLevelScalar(&v));
+    return v;
+  }
+
+  void set_volume(float v) override {
+    winrt::check_hresult(mVolume->SetMasterVolumeLevelScalar(v, &VolumeSetterEventContext));
+  }
+
+private:
+  winrt::com_ptr<IAudioEndpointVolume> mVolume;
+};
+
+/**
+ * Audio session events forwarded to a set of handlers.
+ */
+struct SessionEvents : winrt::implements<SessionEvents, IAudioSessionEvents> {
+  explicit SessionEvents(SessionEventHandlers handlers) : handlers{std::move(handlers)} {}
+
+  HRESULT STDMETHODCALLTYPE OnSimpleVolumeChanged(float newVolume, BOOL, LPCGUID eventContext) noexcept override try {
+    if (handlers.volumeChanged) handlers.volumeChanged(newVolume, eventContext);
+    return S_OK;
+  } catch (...) {
+    return winrt::to_hresult();
+  }
+
+  HRESULT STDMETHODCALLTYPE OnStateChanged(AudioSessionState state) noexcept override try {
+    if (state == AudioSessionStateExpired && handlers.ended) handlers.ended();
+    return S_OK;
+  } catch (...) {
+    return winrt::to_hresult();
+  }
+
+  HRESULT STDMETHODCALLTYPE OnSessionDisconnected(AudioSessionDisconnectReason) noexcept override try {
+    if (handlers.ended) handlers.ended();
+    return S_OK;
+  } catch (...) {
+    return winrt::to_hresult();
+  }
+
+  HRESULT STDMETHODCALLTYPE OnDisplayNameChanged(LPCWSTR, LPCGUID) noexcept override { return S_OK; }
+  HRESULT STDMETHODCALLTYPE OnIconPathChanged(LPCWSTR, LPCGUID) noexcept override { return S_OK; }
+  HRESULT STDMETHODCALLTYPE OnChannelVolumeChanged(DWORD, float[], DWORD, LPCGUID) noexcept override { return S_OK; }
+  HRESULT STDMETHODCALLTYPE OnGroupingParamChanged(LPCGUID, LPCGUID) noexcept override { return S_OK; }
+
+  SessionEventHandlers handlers;
+};
+
+/**
+ * Return a string returned by an audio session getter, taking ownership of it.
+ */
+std::string take_session_string(wchar_t *str) {
+  const std::unique_ptr<wchar_t, decltype(&::CoTaskMemFree)> owned{str, &::CoTaskMemFree};
+  return winrt::to_string(owned.get());
+}
+
+/**
+ * Return a string returned by an audio session getter as UTF-8 allocated from
+ * `resource`, taking ownership of it.
+ */
+std::pmr::string take_session_string(wchar_t *str, std::pmr::memory_resource *resource) {
+  const std::unique_ptr<wchar_t, decltype(&::CoTaskMemFree)> owned{str, &::CoTaskMemFree};
+  std::pmr::string out{resource};
+  if (!str || !*str) return out;
+
+  // The first call finds the size without writing, which includes the
+  // null-terminator since the input is null-terminated.
+  const auto size{::WideCharToMultiByte(CP_UTF8, 0, str, -1, nullptr, 0, nullptr, nullptr)};
+  if (size <= 0) winrt::throw_last_error();
+  out.resize(static_cast<std::size_t>(size));
+  if (::WideCharToMultiByte(CP_UTF8, 0, str, -1, out.data(), size, nullptr, nullptr) <= 0) {
+    winrt::throw_last_error();
+  }
+  out.pop_back();
+  return out;
+}
+
+}// namespace
+
 winrt::com_ptr<IMMDevice> get_default_audio_device() {
   const auto deviceEnumerator{winrt::create_instance<IMMDeviceEnumerator>(
       winrt::guid_of<MMDeviceEnumerator>(), CLSCTX_ALL, nullptr)};
@@ -23,68 +140,147 @@ get_audio_session_manager(const winrt::com_ptr<IMMDevice> &device) {
   return sessionMgr;
 }
 
+winrt::com_ptr<IAudioEndpointVolume> get_endpoint_volume(const winrt::com_ptr<IMMDevice> &device) {
+  winrt::com_ptr<IAudioEndpointVolume> deviceVolume;
+  winrt::check_hresult(device->Activate(
+      winrt::guid_of<IAudioEndpointVolume>(), CLSCTX_ALL, nullptr, deviceVolume.put_void()));
+  return deviceVolume;
+}
+
 DWORD get_process_id(const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl2) {
   DWORD pid;
   winrt::check_hresult(sessionCtrl2->GetProcessId(&pid));
   return pid;
 }
 
-std::optional<float> set_device_volume(
-    const VolumeProfile &profile,
-    const winrt::com_ptr<IMMDevice> &device) {
-  winrt::com_ptr<IAudioEndpointVolume> deviceVolume;
-  winrt::check_hresult(device->Activate(
-      winrt::guid_of<IAudioEndpointVolume>(), CLSCTX_ALL, nullptr, deviceVolume.put_void()));
+std::string get_display_name(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl) {
+  wchar_t *name{};
+  winrt::check_hresult(sessionCtrl->GetDisplayName(&name));
+  return em::take_session_string(name);
+}
+
+std::string get_icon_path(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl) {
+  wchar_t *path{};
+  winrt::check_hresult(sessionCtrl->GetIconPath(&path));
+  return em::take_session_string(path);
+}
 
-  std::optional<float> setVolume{};
-  for (const auto &control : profile.controls) {
-    if (control.suffix() != ":device") continue;
-    const float targetVol{control.relative_volume()};
+std::string get_session_identifier(const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl2) {
+  wchar_t *id{};
+  winrt::check_hresult(sessionCtrl2->GetSessionIdentifier(&id));
+  return em::take_session_string(id);
+}
 
-    winrt::check_hresult(deviceVolume->SetMasterVolumeLevelScalar(targetVol, nullptr));
-    setVolume = targetVol;
-    // To be consistent with later controls overriding earlier ones when they
-    // both match the same executable, do not early exit.
+std::pmr::string get_session_field(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl, MatchKind kind,
+                                   std::pmr::memory_resource *resource) {
+  // Fetched directly rather than through the getters above so that the field
+  // is converted straight into `resource`.
+  wchar_t *str{};
+  switch (kind) {
+  case MatchKind::DisplayName:
+    winrt::check_hresult(sessionCtrl->GetDisplayName(&str));
+    return em::take_session_string(str, resource);
+  case MatchKind::IconPath:
+    winrt::check_hresult(sessionCtrl->GetIconPath(&str));
+    return em::take_session_string(str, resource);
+  case MatchKind::SessionId:
+    winrt::check_hresult(sessionCtrl.as<IAudioSessionControl2>()->GetSessionIdentifier(&str));
+    return em::take_session_string(str, resource);
+  case MatchKind::Suffix:
+  case MatchKind::Ancestor: break;
   }
-  return setVolume;
+  throw std::invalid_argument("Suffix and ancestor controls do not match a session field");
 }
 
-std::optional<float> set_system_sound_volume(
-    const VolumeProfile &profile,
-    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl) {
-  std::optional<float> setVolume{};
-  for (const auto &control : profile.controls) {
-    if (control.suffix() != ":system") continue;
-    const float targetVol{control.relative_volume()};
-
-    // HACK: See em::set_session_volume()
-    const auto volume{sessionCtrl.as<ISimpleAudioVolume>()};
-    winrt::check_hresult(volume->SetMasterVolume(targetVol, nullptr));
-    setVolume = targetVol;
+GUID get_grouping_param(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl) {
+  GUID grouping{};
+  winrt::check_hresult(sessionCtrl->GetGroupingParam(&grouping));
+  return grouping;
+}
+
+std::string get_session_instance_id(const winrt::com_ptr<IAudioSessionControl2> &sessionCtrl2) {
+  wchar_t *id{};
+  winrt::check_hresult(sessionCtrl2->GetSessionInstanceIdentifier(&id));
+  return em::take_session_string(id);
+}
+
+void set_session_master_volume(const VolumeControl &control,
+                               const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+                               RampScheduler *ramps) {
+  // HACK: This is undocumented behaviour! At least, as far as I know.
+  //       With mild apologies to the Windows developers, I was not able to
+  //       do this another way, and it seems quite absurd that a user cannot
+  //       programmatically change the volume of their own applications.
+  //       Best I've found is this answer by a Microsoft employee stating that
+  //       you can often do it: https://stackoverflow.com/a/6084029
+  const auto volume{sessionCtrl.as<ISimpleAudioVolume>()};
+  const float targetVol{control.relative_volume()};
+
+  // Looking up the instance identifier allocates, so only do it if there is a
+  // ramp to start or one that might need cancelling.
+  if (!ramps || (control.fade().duration.count() == 0 && !ramps->has_ramps())) {
+    // Switching between similar profiles, such as two that extend the same
+    // base, leaves most volumes alone. Reading the volume is much cheaper than
+    // setting it, which notifies every client of the session, so only set the
+    // volumes that actually differ.
+    float currentVol;
+    winrt::check_hresult(volume->GetMasterVolume(&currentVol));
+    if (currentVol != targetVol) {
+      winrt::check_hresult(volume->SetMasterVolume(targetVol, &VolumeSetterEventContext));
+    }
+    return;
   }
-  return setVolume;
+
+  const auto key{em::get_session_instance_id(sessionCtrl.as<IAudioSessionControl2>())};
+  ramps->start(key, std::make_shared<SessionRampTarget>(volume), targetVol, control.fade());
 }
 
-std::optional<float> set_named_session_volume(
-    const VolumeProfile &profile,
-    std::string_view procName,
-    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl) {
-  std::optional<float> setVolume{};
-  for (const auto &control : profile.controls) {
-    if (!procName.ends_with(control.suffix())) continue;
-    const float targetVol{control.relative_volume()};
-
-    // HACK: This is undocumented behaviour! At least, as far as I know.
-    //       With mild apologies to the Windows developers, I was not able to
-    //       do this another way, and it seems quite absurd that a user cannot
-    //       programmatically change the volume of their own applications.
-    //       Best I've found is this answer by a Microsoft employee stating that
-    //       you can often do it: https://stackoverflow.com/a/6084029
-    const auto volume{sessionCtrl.as<ISimpleAudioVolume>()};
-    winrt::check_hresult(volume->SetMasterVolume(targetVol, nullptr));
-    setVolume = targetVol;
+void set_device_master_volume(const VolumeControl &control,
+                              const winrt::com_ptr<IMMDevice> &device,
+                              RampScheduler *ramps) {
+  const auto deviceVolume{em::get_endpoint_volume(device)};
+  const float targetVol{control.relative_volume()};
+
+  if (ramps) {
+    ramps->start(":device", std::make_shared<DeviceRampTarget>(deviceVolume), targetVol, control.fade());
+  } else {
+    // As with sessions, avoid setting the volume if it's already right.
+    float currentVol;
+    winrt::check_hresult(deviceVolume->GetMasterVolumeLevelScalar(&currentVol));
+    if (currentVol != targetVol) {
+      winrt::check_hresult(deviceVolume->SetMasterVolumeLevelScalar(targetVol, &VolumeSetterEventContext));
+    }
   }
-  return setVolume;
+}
+
+std::optional<float> set_device_volume(
+    const VolumeProfile &profile,
+    const winrt::com_ptr<IMMDevice> &device,
+    RampScheduler *ramps) {
+  // Only the last control counts, as with later controls overriding earlier
+  // ones when they both match the same executable.
+  const auto *deviceControl{em::find_control(profile, ":device")};
+  if (!deviceControl) return std::nullopt;
+
+  em::set_device_master_volume(*deviceControl, device, ramps);
+  return deviceControl->relative_volume();
+}
+
+std::optional<float> set_system_sound_volume(
+    const VolumeProfile &profile,
+    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+    RampScheduler *ramps) {
+  const auto *systemControl{em::find_control(profile, ":system")};
+  if (!systemControl) return std::nullopt;
+
+  em::set_session_master_volume(*systemControl, sessionCtrl, ramps);
+  return systemControl->relative_volume();
+}
+
+bool is_session_expired(const winrt::com_ptr<IAudioSessionControl> &sessionCtrl) {
+  AudioSessionState state;
+  winrt::check_hresult(sessionCtrl->GetState(&state));
+  return state == AudioSessionStateExpired;
 }
 
 void unregister_session_notification(
@@ -93,4 +289,17 @@ void unregister_session_notification(
   winrt::check_hresult(mgr->UnregisterSessionNotification(handle.get()));
 }
 
+winrt::com_ptr<IAudioSessionEvents> register_session_events(
+    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl, SessionEventHandlers handlers) {
+  const auto events{winrt::make<SessionEvents>(std::move(handlers))};
+  winrt::check_hresult(sessionCtrl->RegisterAudioSessionNotification(events.get()));
+  return events;
+}
+
+void unregister_session_events(
+    const winrt::com_ptr<IAudioSessionControl> &sessionCtrl,
+    const winrt::com_ptr<IAudioSessionEvents> &handle) {
+  winrt::check_hresult(sessionCtrl->UnregisterAudioSessionNotification(handle.get()));
+}
+
 }// namespace em
@@ -0,0 +1,73 @@
+#include "declvol/watcher.h"
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+namespace em {
+namespace {
+
+class InotifyWatcher final : public FileWatcher {
+public:
+  explicit InotifyWatcher(const std::filesystem::path &path)
+      : mFileName{path.filename().string()},
+        mFd{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)} {
+    if (mFd < 0) throw std::system_error(errno, std::generic_category(), "inotify_init1");
+
+    const auto dir{std::filesystem::absolute(path).parent_path()};
+    if (::inotify_add_watch(mFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+      const int err{errno};
+      ::close(mFd);
+      throw std::system_error(err, std::generic_category(), "inotify_add_watch");
+    }
+  }
+
+  InotifyWatcher(const InotifyWatcher &) = delete;
+  InotifyWatcher &operator=(const InotifyWatcher &) = delete;
+
+  ~InotifyWatcher() override { ::close(mFd); }
+
+  bool wait_for_change(std::chrono::milliseconds timeout) override {
+    ::pollfd pfd{mFd, POLLIN, 0};
+    if (::poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) return false;
+
+    bool changed{false};
+    alignas(::inotify_event) std::array<char, 4096> buf;
+    for (;;) {
+      const auto len{::read(mFd, buf.data(), buf.size())};
+      if (len <= 0) break;
+
+      for (std::size_t offset{0}; offset < static_cast<std::size_t>(len);) {
+        const auto *event{reinterpret_cast<const ::inotify_event *>(buf.data() + offset)};
+        if ((event->mask & IN_Q_OVERFLOW) || (event->len != 0 && mFileName == event->name)) {
+          changed = true;
+        }
+        offset += sizeof(::inotify_event) + event->len;
+      }
+    }
+
+    return changed;
+  }
+
+  [[nodiscard]] NativeHandle native_handle() const override {
+    return mFd;
+  }
+
+private:
+  std::string mFileName;
+  int mFd;
+};
+
+}// namespace
+
+std::unique_ptr<FileWatcher> make_file_watcher(const std::filesystem::path &path) {
+  return std::make_unique<InotifyWatcher>(path);
+}
+
+}// namespace em
@@ -0,0 +1,96 @@
+#include "declvol/watcher.h"
+#include "declvol/windows.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace em {
+namespace {
+
+class DirectoryChangesWatcher final : public FileWatcher {
+public:
+  explicit DirectoryChangesWatcher(const std::filesystem::path &path)
+      : mFileName{path.filename().wstring()},
+        mEvent{::CreateEventW(nullptr, /*bManualReset=*/true, /*bInitialState=*/false, nullptr)} {
+    if (!mEvent) winrt::throw_last_error();
+
+    const auto dir{std::filesystem::absolute(path).parent_path()};
+    mDir.attach(::CreateFileW(
+        dir.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr));
+    if (!mDir) winrt::throw_last_error();
+
+    issue();
+  }
+
+  DirectoryChangesWatcher(const DirectoryChangesWatcher &) = delete;
+  DirectoryChangesWatcher &operator=(const DirectoryChangesWatcher &) = delete;
+
+  ~DirectoryChangesWatcher() override {
+    // The pending read refers to our buffer, so it must be finished before the
+    // buffer is freed.
+    if (::CancelIoEx(mDir.get(), &mOverlapped)) {
+      DWORD bytes{};
+      ::GetOverlappedResult(mDir.get(), &mOverlapped, &bytes, /*bWait=*/true);
+    }
+  }
+
+  bool wait_for_change(std::chrono::milliseconds timeout) override {
+    if (::WaitForSingleObject(mEvent.get(), static_cast<DWORD>(timeout.count())) != WAIT_OBJECT_0) {
+      return false;
+    }
+
+    DWORD bytes{};
+    winrt::check_bool(::GetOverlappedResult(mDir.get(), &mOverlapped, &bytes, /*bWait=*/false));
+
+    // Zero bytes means the buffer overflowed and the changes were dropped, so
+    // all we know is that something changed.
+    bool changed{bytes == 0};
+    for (std::size_t offset{0}; bytes != 0;) {
+      const auto *info{reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(mBuf.data() + offset)};
+      const std::wstring_view name{info->FileName, info->FileNameLength / sizeof(wchar_t)};
+      if (::CompareStringOrdinal(name.data(), static_cast<int>(name.size()),
+                                 mFileName.data(), static_cast<int>(mFileName.size()),
+                                 /*bIgnoreCase=*/true)
+          == CSTR_EQUAL) {
+        changed = true;
+      }
+      if (info->NextEntryOffset == 0) break;
+      offset += info->NextEntryOffset;
+    }
+
+    issue();
+    return changed;
+  }
+
+  [[nodiscard]] NativeHandle native_handle() const override {
+    return mEvent.get();
+  }
+
+private:
+  void issue() {
+    winrt::check_bool(::ResetEvent(mEvent.get()));
+    mOverlapped = {};
+    mOverlapped.hEvent = mEvent.get();
+    winrt::check_bool(::ReadDirectoryChangesW(
+        mDir.get(), mBuf.data(), static_cast<DWORD>(mBuf.size()), /*bWatchSubtree=*/false,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+        nullptr, &mOverlapped, nullptr));
+  }
+
+  std::wstring mFileName;
+  winrt::handle mEvent;
+  winrt::file_handle mDir;
+  OVERLAPPED mOverlapped{};
+  alignas(DWORD) std::array<std::byte, 4096> mBuf{};
+};
+
+}// namespace
+
+std::unique_ptr<FileWatcher> make_file_watcher(const std::filesystem::path &path) {
+  return std::make_unique<DirectoryChangesWatcher>(path);
+}
+
+}// namespace em
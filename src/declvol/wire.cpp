@@ -0,0 +1,461 @@
+#include "declvol/wire.h"
+
+#include <bit>
+#include <cstring>
+#include <format>
+#include <utility>
+
+namespace em::wire {
+namespace {
+
+/**
+ * Return the number of bytes needed to encode `value` as a varint.
+ */
+constexpr std::size_t varint_size(std::uint64_t value) {
+  std::size_t size{1};
+  while (value >= 0x80u) {
+    value >>= 7u;
+    ++size;
+  }
+  return size;
+}
+
+/**
+ * Return the number of bytes needed to encode a length-delimited field.
+ *
+ * Like Protobuf, empty strings are not written at all.
+ */
+constexpr std::size_t string_field_size(std::uint32_t field, std::string_view value) {
+  if (value.empty()) return 0;
+  return varint_size(make_tag(field, WireType::Len)) + varint_size(value.size()) + value.size();
+}
+
+/**
+ * Return the number of bytes needed to encode a varint field.
+ *
+ * Like Protobuf, zero values are not written at all.
+ */
+constexpr std::size_t varint_field_size(std::uint32_t field, std::uint64_t value) {
+  if (value == 0) return 0;
+  return varint_size(make_tag(field, WireType::Varint)) + varint_size(value);
+}
+
+/**
+ * Return the number of bytes needed to encode a 32-bit floating point field.
+ *
+ * Like Protobuf, zero values are not written at all.
+ */
+constexpr std::size_t float_field_size(std::uint32_t field, float value) {
+  if (std::bit_cast<std::uint32_t>(value) == 0) return 0;
+  return varint_size(make_tag(field, WireType::I32)) + sizeof(std::uint32_t);
+}
+
+/**
+ * Return the number of bytes needed to encode an embedded message whose own
+ * fields take `size` bytes.
+ *
+ * Unlike strings, embedded messages are written even when empty, because
+ * which field of a `oneof` is set is all that some commands say.
+ */
+constexpr std::size_t message_field_size(std::uint32_t field, std::size_t size) {
+  return varint_size(make_tag(field, WireType::Len)) + varint_size(size) + size;
+}
+
+/**
+ * Return the number of bytes needed to encode the fields of a
+ * `SwitchProfileRequest`, leaving out the version.
+ */
+std::size_t switch_profile_fields_size(const SwitchProfileRequest &request) {
+  return string_field_size(SwitchProfileLayout::Profile, request.profile)
+         + string_field_size(SwitchProfileLayout::ConfigPath, request.configPath)
+         + varint_field_size(SwitchProfileLayout::Operation, static_cast<std::uint32_t>(request.operation));
+}
+
+std::size_t set_override_fields_size(const SetOverride &command) {
+  return string_field_size(SetOverrideLayout::Suffix, command.suffix)
+         + float_field_size(SetOverrideLayout::Volume, command.volume);
+}
+
+/**
+ * Return the field of `declvol.v1.Command` holding `command`, and the number of
+ * bytes needed to encode its fields.
+ */
+std::pair<std::uint32_t, std::size_t> command_field(const Command &command) {
+  if (const auto *request{std::get_if<SwitchProfileRequest>(&command)}) {
+    return {CommandLayout::SwitchProfile, switch_profile_fields_size(*request)};
+  }
+  if (const auto *setOverride{std::get_if<SetOverride>(&command)}) {
+    return {CommandLayout::SetOverride, set_override_fields_size(*setOverride)};
+  }
+  return {CommandLayout::ClearOverrides, 0};
+}
+
+/**
+ * Appends fields to a buffer whose size has already been checked.
+ */
+class Writer {
+public:
+  explicit Writer(std::byte *out) : mOut{out} {}
+
+  void varint(std::uint64_t value) {
+    while (value >= 0x80u) {
+      *mOut++ = static_cast<std::byte>((value & 0x7fu) | 0x80u);
+      value >>= 7u;
+    }
+    *mOut++ = static_cast<std::byte>(value);
+  }
+
+  void varint_field(std::uint32_t field, std::uint64_t value) {
+    varint(make_tag(field, WireType::Varint));
+    varint(value);
+  }
+
+  void string_field(std::uint32_t field, std::string_view value) {
+    if (value.empty()) return;
+    varint(make_tag(field, WireType::Len));
+    varint(value.size());
+    std::memcpy(mOut, value.data(), value.size());
+    mOut += value.size();
+  }
+
+  void float_field(std::uint32_t field, float value) {
+    auto bits{std::bit_cast<std::uint32_t>(value)};
+    if (bits == 0) return;
+    varint(make_tag(field, WireType::I32));
+    // Fixed-width fields are little-endian whatever the host is.
+    for (std::size_t i{0}; i < sizeof(bits); ++i, bits >>= 8u) {
+      *mOut++ = static_cast<std::byte>(bits & 0xffu);
+    }
+  }
+
+  /**
+   * Begin an embedded message whose fields take `size` bytes, which must be
+   * written next.
+   */
+  void message_field(std::uint32_t field, std::size_t size) {
+    varint(make_tag(field, WireType::Len));
+    varint(size);
+  }
+
+  void switch_profile_fields(const SwitchProfileRequest &request) {
+    string_field(SwitchProfileLayout::Profile, request.profile);
+    string_field(SwitchProfileLayout::ConfigPath, request.configPath);
+    if (request.operation != Operation::Replace) {
+      varint_field(SwitchProfileLayout::Operation, static_cast<std::uint32_t>(request.operation));
+    }
+  }
+
+private:
+  std::byte *mOut;
+};
+
+/**
+ * Reads fields from a buffer, failing on anything truncated or malformed.
+ */
+class Reader {
+public:
+  explicit Reader(std::span<const std::byte> buf) : mBuf{buf} {}
+
+  [[nodiscard]] bool done() const {
+    return mBuf.empty();
+  }
+
+  bool varint(std::uint64_t &value) {
+    value = 0;
+    // A varint is at most 10 bytes, and the tenth may only hold one bit.
+    for (unsigned int shift{0}; shift < 64u && !mBuf.empty(); shift += 7u) {
+      const auto b{static_cast<std::uint8_t>(mBuf.front())};
+      mBuf = mBuf.subspan(1);
+      value |= static_cast<std::uint64_t>(b & 0x7fu) << shift;
+      if ((b & 0x80u) == 0) return true;
+    }
+    return false;
+  }
+
+  bool bytes(std::size_t size, std::string_view &value) {
+    if (size > mBuf.size()) return false;
+    value = {reinterpret_cast<const char *>(mBuf.data()), size};
+    mBuf = mBuf.subspan(size);
+    return true;
+  }
+
+  bool string(std::string_view &value) {
+    std::uint64_t size{};
+    return varint(size) && bytes(size, value);
+  }
+
+  bool fixed32(std::uint32_t &value) {
+    std::string_view data;
+    if (!bytes(sizeof(value), data)) return false;
+    value = 0;
+    for (std::size_t i{sizeof(value)}; i-- > 0;) {
+      value = (value << 8u) | static_cast<std::uint8_t>(data[i]);
+    }
+    return true;
+  }
+
+  /**
+   * Read an embedded message, returning a reader of its fields.
+   */
+  std::optional<Reader> message() {
+    std::string_view data;
+    if (!string(data)) return std::nullopt;
+    return Reader{std::as_bytes(std::span{data.data(), data.size()})};
+  }
+
+  /**
+   * Read the tag of the next field, failing on anything that is not a tag.
+   */
+  bool tag(std::uint32_t &field, WireType &type) {
+    std::uint64_t tag{};
+    if (!varint(tag) || tag > UINT32_MAX) return false;
+    field = static_cast<std::uint32_t>(tag >> 3u);
+    type = static_cast<WireType>(tag & 0x7u);
+    return field != 0;
+  }
+
+  /**
+   * Skip the value of a field that is not understood.
+   */
+  bool skip(WireType type) {
+    std::uint64_t size{};
+    std::string_view ignored;
+    switch (type) {
+    case WireType::Varint: return varint(size);
+    case WireType::I64: return bytes(8, ignored);
+    case WireType::Len: return string(ignored);
+    case WireType::I32: return bytes(4, ignored);
+    // Groups are deprecated and never used by our messages.
+    case WireType::SGroup:
+    case WireType::EGroup: return false;
+    }
+    return false;
+  }
+
+private:
+  std::span<const std::byte> mBuf;
+};
+
+}// namespace
+
+std::size_t encoded_size(const SwitchProfileRequest &request) {
+  return varint_size(make_tag(VersionField, WireType::Varint)) + varint_size(request.version)
+         + switch_profile_fields_size(request);
+}
+
+std::size_t encode(const SwitchProfileRequest &request, std::span<std::byte> buf) {
+  const auto size{encoded_size(request)};
+  if (size > buf.size()) {
+    throw WireError(std::format("Message of {} bytes does not fit in buffer of {} bytes",
+                                size, buf.size()));
+  }
+
+  // Fields are written in field number order, as Protobuf does, so that the
+  // output is byte-for-byte what Protobuf would write followed by the version.
+  Writer writer{buf.data()};
+  writer.switch_profile_fields(request);
+  writer.varint_field(VersionField, request.version);
+  return size;
+}
+
+std::size_t encoded_size(const CommandBatch &batch) {
+  std::size_t size{varint_size(make_tag(VersionField, WireType::Varint)) + varint_size(batch.version)};
+  for (const auto &command : batch.commands) {
+    const auto [field, fieldsSize]{command_field(command)};
+    size += message_field_size(CommandBatchLayout::Commands, message_field_size(field, fieldsSize));
+  }
+  return size;
+}
+
+std::size_t encode(const CommandBatch &batch, std::span<std::byte> buf) {
+  const auto size{encoded_size(batch)};
+  if (size > buf.size()) {
+    throw WireError(std::format("Message of {} bytes does not fit in buffer of {} bytes",
+                                size, buf.size()));
+  }
+
+  Writer writer{buf.data()};
+  for (const auto &command : batch.commands) {
+    const auto [field, fieldsSize]{command_field(command)};
+    writer.message_field(CommandBatchLayout::Commands, message_field_size(field, fieldsSize));
+    writer.message_field(field, fieldsSize);
+    if (const auto *request{std::get_if<SwitchProfileRequest>(&command)}) {
+      writer.switch_profile_fields(*request);
+    } else if (const auto *setOverride{std::get_if<SetOverride>(&command)}) {
+      writer.string_field(SetOverrideLayout::Suffix, setOverride->suffix);
+      writer.float_field(SetOverrideLayout::Volume, setOverride->volume);
+    }
+  }
+  writer.varint_field(VersionField, batch.version);
+  return size;
+}
+
+namespace {
+
+/**
+ * Read a field of a `SwitchProfileRequest` into `request`, returning whether it
+ * was one.
+ *
+ * `ok` is set to whether the field could be read, if it was one.
+ */
+bool read_switch_profile_field(Reader &reader, std::uint32_t field, WireType type,
+                               SwitchProfileRequest &request, bool &ok) {
+  if (field == SwitchProfileLayout::Profile && type == WireType::Len) {
+    ok = reader.string(request.profile);
+  } else if (field == SwitchProfileLayout::ConfigPath && type == WireType::Len) {
+    ok = reader.string(request.configPath);
+  } else if (field == SwitchProfileLayout::Operation && type == WireType::Varint) {
+    std::uint64_t operation{};
+    ok = reader.varint(operation);
+    // Like an unknown enum value in Protobuf, an operation from a newer
+    // writer is not understood and so the message is rejected.
+    if (operation > static_cast<std::uint32_t>(Operation::Pop)) ok = false;
+    request.operation = static_cast<Operation>(operation);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::optional<SwitchProfileRequest> read_switch_profile(Reader reader) {
+  SwitchProfileRequest request;
+  while (!reader.done()) {
+    std::uint32_t field{};
+    WireType type{};
+    if (!reader.tag(field, type)) return std::nullopt;
+    bool ok{};
+    if (!read_switch_profile_field(reader, field, type, request, ok)) ok = reader.skip(type);
+    if (!ok) return std::nullopt;
+  }
+  return request;
+}
+
+std::optional<SetOverride> read_set_override(Reader reader) {
+  SetOverride command;
+  while (!reader.done()) {
+    std::uint32_t field{};
+    WireType type{};
+    if (!reader.tag(field, type)) return std::nullopt;
+    bool ok{};
+    if (field == SetOverrideLayout::Suffix && type == WireType::Len) {
+      ok = reader.string(command.suffix);
+    } else if (field == SetOverrideLayout::Volume && type == WireType::I32) {
+      std::uint32_t bits{};
+      ok = reader.fixed32(bits);
+      command.volume = std::bit_cast<float>(bits);
+    } else {
+      ok = reader.skip(type);
+    }
+    if (!ok) return std::nullopt;
+  }
+  return command;
+}
+
+/**
+ * Read a `declvol.v1.Command`, of which the last field set wins, as for any
+ * `oneof`.
+ */
+std::optional<Command> read_command(Reader reader) {
+  std::optional<Command> command;
+  while (!reader.done()) {
+    std::uint32_t field{};
+    WireType type{};
+    if (!reader.tag(field, type)) return std::nullopt;
+    if (type != WireType::Len) {
+      if (!reader.skip(type)) return std::nullopt;
+      continue;
+    }
+    if (field == CommandLayout::SwitchProfile) {
+      auto fields{reader.message()};
+      auto request{fields ? read_switch_profile(*fields) : std::nullopt};
+      if (!request) return std::nullopt;
+      command = *request;
+    } else if (field == CommandLayout::SetOverride) {
+      auto fields{reader.message()};
+      auto setOverride{fields ? read_set_override(*fields) : std::nullopt};
+      if (!setOverride) return std::nullopt;
+      command = *setOverride;
+    } else if (field == CommandLayout::ClearOverrides) {
+      if (!reader.message()) return std::nullopt;
+      command = ClearOverrides{};
+    } else if (!reader.skip(type)) {
+      return std::nullopt;
+    }
+  }
+  // A command of a kind that this reader does not know of cannot be run, so
+  // the whole batch is rejected rather than run in part.
+  return command;
+}
+
+}// namespace
+
+std::optional<SwitchProfileRequest> decode_switch_profile(std::span<const std::byte> buf) {
+  // Messages without a version come from Protobuf writers, which predate this
+  // codec.
+  SwitchProfileRequest request;
+  request.version = 0u;
+  Reader reader{buf};
+
+  while (!reader.done()) {
+    std::uint32_t field{};
+    WireType type{};
+    if (!reader.tag(field, type)) return std::nullopt;
+
+    // As in Protobuf, if a field appears more than once then the last wins.
+    bool ok{};
+    if (read_switch_profile_field(reader, field, type, request, ok)) {
+      if (!ok) return std::nullopt;
+      continue;
+    }
+    if (field == VersionField && type == WireType::Varint) {
+      std::uint64_t version{};
+      ok = reader.varint(version);
+      request.version = static_cast<std::uint32_t>(version);
+    } else {
+      ok = reader.skip(type);
+    }
+    if (!ok) return std::nullopt;
+  }
+
+  return request;
+}
+
+std::optional<CommandBatch> decode_request(std::span<const std::byte> buf) {
+  CommandBatch batch;
+  batch.version = 0u;
+  Reader reader{buf};
+
+  while (!reader.done()) {
+    std::uint32_t field{};
+    WireType type{};
+    if (!reader.tag(field, type)) return std::nullopt;
+
+    bool ok{};
+    if (field == CommandBatchLayout::Commands && type == WireType::Len) {
+      auto fields{reader.message()};
+      auto command{fields ? read_command(*fields) : std::nullopt};
+      if (!command) return std::nullopt;
+      batch.commands.push_back(*command);
+      ok = true;
+    } else if (field == VersionField && type == WireType::Varint) {
+      std::uint64_t version{};
+      ok = reader.varint(version);
+      batch.version = static_cast<std::uint32_t>(version);
+    } else {
+      ok = reader.skip(type);
+    }
+    if (!ok) return std::nullopt;
+  }
+
+  if (!batch.commands.empty()) return batch;
+
+  // Without any commands this is a `SwitchProfileRequest` on its own, which is
+  // also what an empty message is.
+  auto request{decode_switch_profile(buf)};
+  if (!request) return std::nullopt;
+  batch.version = request->version;
+  batch.commands.push_back(*request);
+  return batch;
+}
+
+}// namespace em::wire
@@ -0,0 +1,271 @@
+// Check that the control index picks the same control as the order of the
+// profile says should win.
+//
+// Usage: control_index_test
+//
+// Sessions are matched against a profile mixing every kind of control, with
+// the winner being whichever matching control comes last in the profile
+// whatever its kind. The fields of each session are fetched through a counter,
+// to check that each kind is fetched at most once and kinds that no control
+// uses are not fetched at all. Ancestors are walked through a fixed chain of
+// image paths, counting how many are visited before the walk is stopped, and
+// then through every short chain from a pool of paths matching ancestor
+// suffixes of several lengths, against a check of every control.
+
+#include "declvol/control_index.h"
+#include "declvol/profile.h"
+
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+class Checker {
+public:
+  void check(bool ok, std::string_view what) {
+    if (ok) return;
+    std::cerr << "FAILED: " << what << '\n';
+    mFailed = true;
+  }
+
+  /**
+   * Check that `actual` is the control at position `expected` of `profile`,
+   * or null if `expected` is empty.
+   */
+  void check_control(const em::VolumeProfile &profile, const em::VolumeControl *actual,
+                     std::optional<std::size_t> expected, std::string_view what) {
+    const auto *control{expected ? &profile.controls[*expected] : nullptr};
+    if (actual == control) return;
+    std::cerr << "FAILED: " << what << ": got " << describe(profile, actual) << " instead of "
+              << describe(profile, control) << '\n';
+    mFailed = true;
+  }
+
+  bool failed() const { return mFailed; }
+
+private:
+  static std::string describe(const em::VolumeProfile &profile, const em::VolumeControl *control) {
+    if (!control) return "no control";
+    return std::format("control {} ({} {})", control - profile.controls.data(),
+                       em::match_kind_name(control->kind()), control->suffix());
+  }
+
+  bool mFailed{false};
+};
+
+/**
+ * The fields of a session other than its image path.
+ */
+struct Fields {
+  std::optional<std::string> displayName{};
+  std::optional<std::string> iconPath{};
+  std::optional<std::string> sessionId{};
+  // Number of times each kind has been fetched, indexed by `MatchKind`.
+  std::array<std::size_t, 5> fetches{};
+
+  std::optional<std::string> operator()(em::MatchKind kind) {
+    ++fetches[static_cast<std::size_t>(kind)];
+    switch (kind) {
+    case em::MatchKind::DisplayName: return displayName;
+    case em::MatchKind::IconPath: return iconPath;
+    case em::MatchKind::SessionId: return sessionId;
+    default: return std::nullopt;
+    }
+  }
+};
+
+/**
+ * Return the winning control for a session of `path` with `fields`.
+ */
+const em::VolumeControl *match(const em::VolumeProfile &profile, const em::ControlIndex &index,
+                               std::string_view path, Fields &fields) {
+  return index.match(em::match_control(profile, path), [&fields](em::MatchKind kind) { return fields(kind); });
+}
+
+/**
+ * Return the winning control out of `winner` and the ancestor controls
+ * matching `ancestors`, nearest first, and set `visited` to the number of
+ * ancestors visited.
+ */
+const em::VolumeControl *match_ancestors(const em::ControlIndex &index, const em::VolumeControl *winner,
+                                         const std::vector<std::string_view> &ancestors, std::size_t &visited) {
+  visited = 0;
+  return index.match_ancestors(winner, [&](auto &&visit) {
+    for (const auto path : ancestors) {
+      ++visited;
+      if (visit(path)) return;
+    }
+  });
+}
+
+void check_kinds(Checker &checker) {
+  em::VolumeProfile profile;
+  profile.controls.emplace_back(em::MatchKind::DisplayName, "Voice chat", 0.1f, em::Fade{});
+  profile.controls.emplace_back(R"(\chat.exe)", 0.2f);
+  profile.controls.emplace_back(em::MatchKind::SessionId, "chat-session", 0.3f, em::Fade{});
+  profile.controls.emplace_back(R"(\browser.exe)", 0.4f);
+  profile.controls.emplace_back(em::MatchKind::DisplayName, "Music", 0.5f, em::Fade{});
+  // The same text under a later control of the same kind wins over it.
+  profile.controls.emplace_back(em::MatchKind::DisplayName, "Voice chat", 0.6f, em::Fade{});
+  const em::ControlIndex index{profile};
+
+  checker.check(index.uses(em::MatchKind::DisplayName) && index.uses(em::MatchKind::SessionId)
+                        && !index.uses(em::MatchKind::IconPath) && !index.uses(em::MatchKind::Ancestor)
+                        && !index.uses(em::MatchKind::Suffix),
+                "kinds used by the profile");
+
+  {
+    Fields fields{.displayName = "Voice chat", .sessionId = "chat-session"};
+    checker.check_control(profile, match(profile, index, R"(C:\chat.exe)", fields), 5,
+                          "later display name over earlier session identifier and suffix");
+    checker.check(fields.fetches[static_cast<std::size_t>(em::MatchKind::DisplayName)] == 1
+                          && fields.fetches[static_cast<std::size_t>(em::MatchKind::SessionId)] == 1,
+                  "each used kind fetched once");
+    checker.check(fields.fetches[static_cast<std::size_t>(em::MatchKind::IconPath)] == 0,
+                  "unused kind not fetched");
+  }
+  {
+    Fields fields{.sessionId = "chat-session"};
+    checker.check_control(profile, match(profile, index, R"(C:\chat.exe)", fields), 2,
+                          "session identifier after the suffix");
+  }
+  {
+    Fields fields{.displayName = "Other"};
+    checker.check_control(profile, match(profile, index, R"(C:\chat.exe)", fields), 1,
+                          "suffix when no field matches");
+  }
+  {
+    Fields fields{.sessionId = "chat-session"};
+    checker.check_control(profile, match(profile, index, R"(C:\browser.exe)", fields), 3,
+                          "suffix after the session identifier");
+  }
+  {
+    Fields fields{.displayName = "Music"};
+    checker.check_control(profile, match(profile, index, R"(C:\browser.exe)", fields), 4,
+                          "display name after the suffix");
+  }
+  {
+    Fields fields;
+    checker.check_control(profile, match(profile, index, R"(C:\other.exe)", fields), std::nullopt,
+                          "nothing matching");
+  }
+}
+
+void check_ancestors(Checker &checker) {
+  em::VolumeProfile profile;
+  profile.controls.emplace_back(em::MatchKind::Ancestor, R"(\launcher.exe)", 0.1f, em::Fade{});
+  profile.controls.emplace_back(R"(\game.exe)", 0.2f);
+  profile.controls.emplace_back(em::MatchKind::Ancestor, R"(\steam.exe)", 0.3f, em::Fade{});
+  profile.controls.emplace_back(R"(\tool.exe)", 0.4f);
+  const em::ControlIndex index{profile};
+  checker.check(index.uses(em::MatchKind::Ancestor), "ancestor kind used");
+
+  const std::vector<std::string_view> chain{R"(C:\Games\launcher.exe)", R"(C:\Steam\steam.exe)",
+                                            R"(C:\Windows\explorer.exe)"};
+  std::size_t visited{};
+
+  const auto *game{em::match_control(profile, R"(C:\Games\game.exe)")};
+  checker.check_control(profile, match_ancestors(index, game, chain, visited), 2,
+                        "further ancestor after the suffix");
+  checker.check(visited == 2, "walk stopped at the last ancestor control");
+
+  const auto *tool{em::match_control(profile, R"(C:\Tools\tool.exe)")};
+  checker.check_control(profile, match_ancestors(index, tool, chain, visited), 3,
+                        "suffix after every ancestor control");
+  checker.check(visited == 0, "walk skipped when no ancestor control can win");
+
+  checker.check_control(profile, match_ancestors(index, nullptr, {R"(C:\Games\launcher.exe)"}, visited), 0,
+                        "only ancestor matching");
+  checker.check_control(profile, match_ancestors(index, game, {R"(C:\Windows\explorer.exe)"}, visited), 1,
+                        "no ancestor matching");
+}
+
+/**
+ * Return the position of the control that should win for a session whose own
+ * winner is at `winner`, if any, and whose ancestors are `ancestors`, found by
+ * testing every ancestor control against every ancestor.
+ */
+std::optional<std::size_t> expected_ancestor_winner(const em::VolumeProfile &profile,
+                                                    std::optional<std::size_t> winner,
+                                                    const std::vector<std::string_view> &ancestors) {
+  for (std::size_t i{profile.controls.size()}; i-- > 0;) {
+    if (winner && i <= *winner) break;
+    const auto &control{profile.controls[i]};
+    if (control.kind() != em::MatchKind::Ancestor) continue;
+    for (const auto path : ancestors) {
+      if (path.ends_with(control.suffix())) return i;
+    }
+  }
+  return winner;
+}
+
+void check_ancestor_lengths(Checker &checker) {
+  em::VolumeProfile profile;
+  profile.controls.emplace_back(em::MatchKind::Ancestor, R"(\Launchers\launcher.exe)", 0.1f, em::Fade{});
+  profile.controls.emplace_back(em::MatchKind::Ancestor, "steam.exe", 0.2f, em::Fade{});
+  profile.controls.emplace_back(R"(\game.exe)", 0.3f);
+  profile.controls.emplace_back(em::MatchKind::Ancestor, R"(\launcher.exe)", 0.4f, em::Fade{});
+  profile.controls.emplace_back(em::MatchKind::Ancestor, R"(C:\Program Files\Steam\steam.exe)", 0.5f, em::Fade{});
+  profile.controls.emplace_back(R"(\tool.exe)", 0.6f);
+  profile.controls.emplace_back(em::MatchKind::Ancestor, R"(\a.exe)", 0.7f, em::Fade{});
+  // The same suffix again, which must win over its earlier copy.
+  profile.controls.emplace_back(em::MatchKind::Ancestor, "steam.exe", 0.8f, em::Fade{});
+  profile.controls.emplace_back(R"(\other.exe)", 0.9f);
+  const em::ControlIndex index{profile};
+
+  // Paths shorter and longer than the suffixes, matching several of them at
+  // once, or none.
+  const std::array<std::string_view, 7> pool{
+      R"(C:\Launchers\launcher.exe)",
+      R"(D:\launcher.exe)",
+      R"(C:\Program Files\Steam\steam.exe)",
+      R"(D:\Steam\steam.exe)",
+      R"(\a.exe)",
+      R"(a.exe)",
+      R"(C:\Windows\explorer.exe)",
+  };
+  const std::array<std::string_view, 4> sessions{
+      R"(C:\Games\game.exe)", R"(C:\Tools\tool.exe)", R"(C:\Other\other.exe)", R"(C:\Unknown\unknown.exe)"};
+
+  // Every chain of up to three ancestors from the pool, in every order.
+  std::vector<std::string_view> chain;
+  std::size_t visited{};
+  for (std::size_t a{0}; a <= pool.size(); ++a) {
+    for (std::size_t b{0}; b <= pool.size(); ++b) {
+      for (std::size_t c{0}; c <= pool.size(); ++c) {
+        chain.clear();
+        for (const auto i : {a, b, c}) {
+          if (i < pool.size()) chain.push_back(pool[i]);
+        }
+        for (const auto session : sessions) {
+          const auto *winner{em::match_control(profile, session)};
+          std::optional<std::size_t> winnerPosition;
+          if (winner) winnerPosition = static_cast<std::size_t>(winner - profile.controls.data());
+          checker.check_control(profile, match_ancestors(index, winner, chain, visited),
+                                expected_ancestor_winner(profile, winnerPosition, chain),
+                                std::format("{} with {} ancestors", session, chain.size()));
+        }
+      }
+    }
+  }
+}
+
+}// namespace
+
+int main() try {
+  Checker checker;
+  check_kinds(checker);
+  check_ancestors(checker);
+  check_ancestor_lengths(checker);
+  return checker.failed() ? 1 : 0;
+} catch (const std::exception &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,132 @@
+// Check that the event loop runs posted, delayed and source handlers on its own
+// thread, in order, and stops when asked.
+//
+// Usage: event_loop_test
+//
+// Handlers are posted from another thread while the loop runs, delayed
+// handlers are posted out of order, and a pipe is added as a source and
+// written to from another thread. Every handler records the thread it ran on
+// and what it was, so that the order can be checked once the loop has been
+// stopped, also from another thread, after which nothing more may run.
+
+#include "declvol/event_loop.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+class Checker {
+public:
+  void check(bool ok, std::string_view what) {
+    if (ok) return;
+    std::cerr << "FAILED: " << what << '\n';
+    mFailed = true;
+  }
+
+  bool failed() const { return mFailed; }
+
+private:
+  bool mFailed{false};
+};
+
+std::string join(const std::vector<std::string> &values) {
+  std::string out;
+  for (const auto &value : values) {
+    if (!out.empty()) out += ' ';
+    out += value;
+  }
+  return out;
+}
+
+}// namespace
+
+int main() try {
+  Checker checker;
+  const auto loop{em::make_event_loop()};
+
+  // Only touched on the loop thread.
+  std::vector<std::string> ran;
+  bool offThread{false};
+  std::thread::id loopThread;
+  const auto record{[&](std::string what) {
+    if (std::this_thread::get_id() != loopThread) offThread = true;
+    ran.push_back(std::move(what));
+  }};
+
+  int fds[2];
+  if (::pipe(fds) != 0) throw std::runtime_error("Could not create a pipe");
+  std::size_t bytesRead{0};
+  loop->add_source(fds[0], [&] {
+    char buf[16];
+    const auto len{::read(fds[0], buf, sizeof(buf))};
+    if (len > 0) bytesRead += static_cast<std::size_t>(len);
+    record("pipe");
+    // Once the pipe has been read from it is done with, which also checks
+    // that a handler can remove its own source.
+    loop->remove_source(fds[0]);
+  });
+
+  // Delayed handlers run in order of when they are due, not of when they were
+  // posted.
+  loop->post_after(200ms, [&] { record("late"); });
+  loop->post_after(100ms, [&] { record("early"); });
+  loop->post_after(150ms, [&] {
+    record("middle");
+    // A handler posted from the loop thread runs after the one posting it.
+    loop->post([&] { record("from middle"); });
+  });
+
+  bool wrote{false};
+  std::thread poster{[&] {
+    // Posts from one thread run in the order they were posted.
+    for (int i{0}; i < 3; ++i) loop->post([&, i] { record(std::format("post {}", i)); });
+    std::this_thread::sleep_for(300ms);
+    wrote = ::write(fds[1], "x", 1) == 1;
+    std::this_thread::sleep_for(100ms);
+    loop->post([&] { record("last"); });
+    std::this_thread::sleep_for(100ms);
+    loop->stop();
+    // Handlers left when the loop stops are dropped.
+    loop->post([&] { record("after stop"); });
+  }};
+
+  const auto start{std::chrono::steady_clock::now()};
+  loopThread = std::this_thread::get_id();
+  loop->run();
+  const auto elapsed{std::chrono::steady_clock::now() - start};
+  poster.join();
+  ::close(fds[0]);
+  ::close(fds[1]);
+
+  const std::vector<std::string> expected{"post 0", "post 1", "post 2", "early", "middle",
+                                          "from middle", "late", "pipe", "last"};
+  checker.check(ran == expected, std::format("ran {}", join(ran)));
+  checker.check(!offThread, "every handler ran on the loop thread");
+  checker.check(wrote && bytesRead == 1, "pipe read once");
+  checker.check(elapsed < 5s, "stopped when asked");
+
+  // A loop that is stopped before it runs returns without running anything.
+  const auto stopped{em::make_event_loop()};
+  bool ranAfterStop{false};
+  stopped->post([&] { ranAfterStop = true; });
+  stopped->stop();
+  stopped->run();
+  checker.check(!ranAfterStop, "loop stopped before running");
+
+  return checker.failed() ? 1 : 0;
+} catch (const std::exception &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}
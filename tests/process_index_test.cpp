@@ -0,0 +1,128 @@
+// Check that the process index finds a child process and its ancestors, and
+// forgets the child once it has exited.
+//
+// Usage: process_index_test
+//
+// The test forks a child that waits on a pipe, so the child runs the test's
+// own executable with the test as its parent. Once the process source has
+// polled, the index must report that executable as the child's image path and
+// as its nearest ancestor, followed by the image of whatever started the test.
+// Once the pipe is closed and the child has exited, the index must drop it
+// within a few more polls.
+
+#include "declvol/process_index.h"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+class Checker {
+public:
+  void check(bool ok, std::string_view what) {
+    if (ok) return;
+    std::cerr << "FAILED: " << what << '\n';
+    mFailed = true;
+  }
+
+  bool failed() const { return mFailed; }
+
+private:
+  bool mFailed{false};
+};
+
+std::string image_of(pid_t pid) {
+  return std::filesystem::read_symlink(std::format("/proc/{}/exe", pid)).string();
+}
+
+std::vector<std::string> ancestors_of(const em::ProcessIndex &index, std::uint32_t pid) {
+  std::vector<std::string> paths;
+  index.for_each_ancestor(pid, [&paths](std::string_view path) {
+    paths.emplace_back(path);
+    return false;
+  });
+  return paths;
+}
+
+}// namespace
+
+int main() try {
+  const auto self{image_of(::getpid())};
+  const auto parent{image_of(::getppid())};
+
+  em::ProcessIndex index{em::make_process_source()};
+
+  int fds[2];
+  if (::pipe(fds) != 0) throw std::runtime_error("Could not create a pipe");
+  const auto child{::fork()};
+  if (child < 0) throw std::runtime_error("Could not fork");
+  if (child == 0) {
+    // Only async-signal-safe calls are made in the child, since the index has
+    // a thread of its own in the parent.
+    ::close(fds[1]);
+    char c;
+    while (::read(fds[0], &c, 1) > 0) {}
+    ::_exit(0);
+  }
+  ::close(fds[0]);
+  const auto childPid{static_cast<std::uint32_t>(child)};
+
+  // The `/proc` source polls every half a second, so after a few polls the
+  // child must have been added by the source rather than by the lookup.
+  std::this_thread::sleep_for(1500ms);
+  Checker checker;
+  const auto misses{index.misses()};
+  const auto path{index.image_path(childPid)};
+  checker.check(path && std::string_view{*path} == self,
+                std::format("child image path is {}", path ? std::string_view{*path} : "unknown"));
+  checker.check(index.misses() == misses, "child found by the source");
+
+  const auto ancestors{ancestors_of(index, childPid)};
+  checker.check(ancestors.size() >= 2, std::format("{} ancestors of the child", ancestors.size()));
+  if (ancestors.size() >= 2) {
+    checker.check(ancestors[0] == self, std::format("nearest ancestor is {}", ancestors[0]));
+    checker.check(ancestors[1] == parent, std::format("second ancestor is {}", ancestors[1]));
+  }
+
+  // Stopping the walk stops it.
+  std::size_t visited{0};
+  index.for_each_ancestor(childPid, [&visited](std::string_view) {
+    ++visited;
+    return true;
+  });
+  checker.check(visited == 1, "walk stopped by the visitor");
+
+  ::close(fds[1]);
+  ::waitpid(child, nullptr, 0);
+
+  // The source polls, so give it a few intervals to notice.
+  const auto deadline{std::chrono::steady_clock::now() + 5s};
+  std::optional<std::pmr::string> stale;
+  do {
+    std::this_thread::sleep_for(50ms);
+    stale = index.image_path(childPid);
+  } while (stale && std::chrono::steady_clock::now() < deadline);
+  checker.check(!stale, "exited child removed from the index");
+  checker.check(ancestors_of(index, childPid).empty(), "exited child has no ancestors");
+
+  return checker.failed() ? 1 : 0;
+} catch (const std::exception &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,221 @@
+// Check that handling a session whose executable has been seen before does not
+// touch the heap.
+//
+// Usage: session_alloc_test
+//
+// The global `operator new` is replaced by one that counts the allocations
+// made by the thread running the test. A handful of sessions are then handled
+// the way the waiter handles a new session, through the process index, the
+// memo of the active profile, the control index and a scratch arena, with the
+// result counted in the stats and logged. The first pass fills the memo, after
+// which every pass must make no allocations at all. Talking to the audio
+// session itself is left out, since that is COM and only runs on Windows.
+
+#include "declvol/arena.h"
+#include "declvol/log.h"
+#include "declvol/match_memo.h"
+#include "declvol/process_index.h"
+#include "declvol/profile.h"
+#include "declvol/session_match.h"
+#include "declvol/stats.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+// Only allocations made by the thread running the test are counted, since the
+// logger formats and writes lines on a thread of its own.
+thread_local bool tCounting{false};
+std::atomic<std::size_t> gAllocations{0};
+
+void count_allocation() {
+  if (tCounting) gAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+}// namespace
+
+void *operator new(std::size_t size) {
+  count_allocation();
+  if (void *ptr{std::malloc(size == 0 ? 1 : size)}) return ptr;
+  throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+  count_allocation();
+  const auto alignment{static_cast<std::size_t>(align)};
+  size = (size + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+  if (void *ptr{::_aligned_malloc(size == 0 ? alignment : size, alignment)}) return ptr;
+#else
+  if (void *ptr{std::aligned_alloc(alignment, size == 0 ? alignment : size)}) return ptr;
+#endif
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+#ifdef _WIN32
+  ::_aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t align) noexcept {
+  ::operator delete(ptr, align);
+}
+
+namespace {
+
+/**
+ * Process source reporting a fixed set of processes.
+ */
+class FixedProcessSource final : public em::ProcessSource {
+public:
+  void snapshot(em::ProcessObserver &observer) override {
+    observer.process_started(10, 1, R"(C:\Launcher\launcher.exe)");
+    observer.process_started(11, 10, R"(C:\Games\game.exe)");
+    observer.process_started(12, 10, R"(C:\Games\helper.exe)");
+    observer.process_started(20, 0, R"(C:\Program Files\Browser\browser.exe)");
+  }
+
+  std::optional<std::string> image_path(std::uint32_t) override {
+    return std::nullopt;
+  }
+
+  std::optional<std::uint32_t> parent_pid(std::uint32_t) override {
+    return std::nullopt;
+  }
+
+  void watch(em::ProcessObserver &) override {}
+};
+
+struct Session {
+  std::uint32_t pid;
+  std::string_view displayName;
+  // Volume that the session should be set to.
+  float expected;
+};
+
+/**
+ * Everything that the waiter keeps between sessions.
+ */
+struct Waiter {
+  em::MatchMemo memo;
+  em::ProcessIndex processes;
+  std::unique_ptr<em::StatsPage> stats;
+  em::Logger log;
+};
+
+/**
+ * Handle a new session as the waiter does, returning the control that decided
+ * its volume.
+ */
+const em::VolumeControl *handle_session(Waiter &waiter, const Session &session) {
+  em::ScratchArena<em::SessionArenaSize> scratch;
+  waiter.stats->sessionsHandled.fetch_add(1, std::memory_order_relaxed);
+
+  const auto path{waiter.processes.image_path(session.pid, scratch.resource())};
+  if (!path) return nullptr;
+
+  const auto fetch{[&](em::MatchKind kind) -> std::optional<std::pmr::string> {
+    if (kind != em::MatchKind::DisplayName || session.displayName.empty()) return std::nullopt;
+    return std::pmr::string{session.displayName, scratch.resource()};
+  }};
+  const auto *control{em::match_session(waiter.memo, *path, session.pid, fetch,
+                                        &waiter.processes, waiter.stats.get())};
+  if (!control) return nullptr;
+
+  waiter.stats->controlMatches.record(control->kind(), control->suffix());
+  waiter.log.info("Set volume of {} to {}", std::string_view{*path}, control->relative_volume());
+  return control;
+}
+
+std::shared_ptr<const em::VolumeProfile> make_profile() {
+  em::VolumeProfile profile;
+  profile.controls.emplace_back(R"(\browser.exe)", 0.5f);
+  profile.controls.emplace_back(R"(\game.exe)", 0.8f);
+  profile.controls.emplace_back(em::MatchKind::Ancestor, R"(\launcher.exe)", 0.6f, em::Fade{});
+  profile.controls.emplace_back(R"(\helper.exe)", 0.9f);
+  profile.controls.emplace_back(em::MatchKind::DisplayName, "Voice chat", 0.3f, em::Fade{});
+  return std::make_shared<const em::VolumeProfile>(std::move(profile));
+}
+
+}// namespace
+
+int main() try {
+  constexpr std::size_t NumPasses{1000};
+
+  const auto logPath{std::filesystem::temp_directory_path() / "declvol_session_alloc_test.log"};
+  int result{0};
+  {
+    Waiter waiter{em::MatchMemo{make_profile()},
+                  em::ProcessIndex{std::make_unique<FixedProcessSource>(), false},
+                  std::make_unique<em::StatsPage>(),
+                  em::Logger{logPath}};
+
+    constexpr std::array<Session, 5> sessions{{
+        {20, {}, 0.5f},
+        // The launcher comes after the game's own control, so wins.
+        {11, {}, 0.6f},
+        // But not over a control after it.
+        {12, {}, 0.9f},
+        {20, "Voice chat", 0.3f},
+        {20, "Music", 0.5f},
+    }};
+
+    const em::VolumeControl *wrong{};
+    const Session *wrongSession{};
+    for (std::size_t pass{0}; pass <= NumPasses && !wrongSession; ++pass) {
+      // The first pass fills the memo, and is not counted.
+      tCounting = pass > 0;
+      for (const auto &session : sessions) {
+        wrong = handle_session(waiter, session);
+        if (!wrong || wrong->relative_volume() != session.expected) {
+          wrongSession = &session;
+          break;
+        }
+      }
+    }
+    tCounting = false;
+
+    if (wrongSession) {
+      std::cerr << "Session of process " << wrongSession->pid << " got volume "
+                << (wrong ? wrong->relative_volume() : -1.0f) << " instead of " << wrongSession->expected << '\n';
+      result = 1;
+    } else if (const auto allocations{gAllocations.load()}; allocations != 0) {
+      std::cerr << allocations << " allocations in " << NumPasses * sessions.size()
+                << " sessions handled after the first pass\n";
+      result = 1;
+    }
+  }
+  std::filesystem::remove(logPath);
+  return result;
+} catch (const std::exception &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,86 @@
+// Check that the file watcher reports changes to the watched file, and only to
+// it.
+//
+// Usage: watcher_test
+//
+// A config file is written to a fresh directory and watched. Other files in
+// the directory are then written and renamed, which must not count as changes,
+// while writing the file in place and renaming another file over it, as many
+// editors save, must. Each change must also be reported only once.
+
+#include "declvol/watcher.h"
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Long enough for an event to be delivered if one is coming.
+constexpr std::chrono::milliseconds Timeout{200ms};
+
+class Checker {
+public:
+  void check(bool ok, std::string_view what) {
+    if (ok) return;
+    std::cerr << "FAILED: " << what << '\n';
+    mFailed = true;
+  }
+
+  bool failed() const { return mFailed; }
+
+private:
+  bool mFailed{false};
+};
+
+void write_file(const std::filesystem::path &path, std::string_view contents) {
+  std::ofstream file{path, std::ios::trunc};
+  file << contents;
+}
+
+}// namespace
+
+int main() try {
+  const auto dir{std::filesystem::temp_directory_path() / "declvol_watcher_test"};
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  const auto config{dir / "config.toml"};
+  write_file(config, "[default]\n");
+
+  Checker checker;
+  {
+    const auto watcher{em::make_file_watcher(config)};
+    checker.check(!watcher->wait_for_change(Timeout), "no change before anything is written");
+
+    write_file(dir / "other.toml", "[other]\n");
+    checker.check(!watcher->wait_for_change(Timeout), "writing another file");
+
+    std::filesystem::rename(dir / "other.toml", dir / "renamed.toml");
+    checker.check(!watcher->wait_for_change(Timeout), "renaming another file");
+
+    write_file(config, "[default]\nchanged = true\n");
+    checker.check(watcher->wait_for_change(Timeout), "writing the file in place");
+    checker.check(!watcher->wait_for_change(Timeout), "writing in place reported once");
+
+    write_file(dir / "config.toml.tmp", "[default]\nsaved = true\n");
+    std::filesystem::rename(dir / "config.toml.tmp", config);
+    checker.check(watcher->wait_for_change(Timeout), "renaming another file over the file");
+    checker.check(!watcher->wait_for_change(Timeout), "renaming over the file reported once");
+
+    // Renaming the file away is not a change to it, since there is nothing
+    // left to read.
+    std::filesystem::rename(config, dir / "moved.toml");
+    checker.check(!watcher->wait_for_change(Timeout), "renaming the file away");
+  }
+  std::filesystem::remove_all(dir);
+  return checker.failed() ? 1 : 0;
+} catch (const std::exception &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,295 @@
+// Check that the built-in codec writes and reads the same bytes as Protobuf.
+//
+// Usage: wire_test
+//
+// The golden messages below were written once by libprotobuf, using
+// `protoc --encode` on `declvol.proto`. The codec must write exactly those
+// bytes followed by its version field, and read them back, with or without the
+// version. When built with Protobuf the same messages are also serialised by
+// libprotobuf at runtime, in case the golden bytes were to go stale.
+
+#include "declvol/wire.h"
+
+#ifdef EM_USE_PROTOBUF
+#include "declvol/v1/declvol.pb.h"
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using Bytes = std::vector<std::byte>;
+
+Bytes bytes(std::initializer_list<unsigned char> values) {
+  Bytes out;
+  out.reserve(values.size());
+  for (const auto value : values) out.push_back(static_cast<std::byte>(value));
+  return out;
+}
+
+Bytes concat(const Bytes &a, const Bytes &b) {
+  auto out{a};
+  out.insert(out.end(), b.begin(), b.end());
+  return out;
+}
+
+std::string hex(std::span<const std::byte> buf) {
+  std::ostringstream out;
+  out << std::hex << std::setfill('0');
+  for (const auto byte : buf) out << std::setw(2) << static_cast<unsigned>(byte) << ' ';
+  return out.str();
+}
+
+constexpr std::string_view ConfigPath{R"(C:\Users\me\declvol.toml)"};
+
+// `profile: "work" config_path: "C:\Users\me\declvol.toml"`
+const Bytes PlainRequest{bytes({
+    0x0a, 0x04, 'w', 'o', 'r', 'k',
+    0x12, 0x18, 'C', ':', '\\', 'U', 's', 'e', 'r', 's', '\\', 'm', 'e', '\\',
+    'd', 'e', 'c', 'l', 'v', 'o', 'l', '.', 't', 'o', 'm', 'l',
+})};
+
+// `profile: "game" config_path: "C:\Users\me\declvol.toml"
+//  operation: OPERATION_PUSH`
+const Bytes PushRequest{bytes({
+    0x0a, 0x04, 'g', 'a', 'm', 'e',
+    0x12, 0x18, 'C', ':', '\\', 'U', 's', 'e', 'r', 's', '\\', 'm', 'e', '\\',
+    'd', 'e', 'c', 'l', 'v', 'o', 'l', '.', 't', 'o', 'm', 'l',
+    0x18, 0x01,
+})};
+
+// `operation: OPERATION_POP`, as sent by a setter that predates the codec and
+// so has no version.
+const Bytes LegacyPopRequest{bytes({0x18, 0x02})};
+
+// ```
+// commands { set_override { suffix: "\chat.exe" volume: 0.25 } }
+// commands { clear_overrides {} }
+// commands { switch_profile { profile: "game"
+//                             config_path: "C:\Users\me\declvol.toml"
+//                             operation: OPERATION_PUSH } }
+// ```
+const Bytes Batch{bytes({
+    0x22, 0x12, 0x12, 0x10,
+    0x0a, 0x09, '\\', 'c', 'h', 'a', 't', '.', 'e', 'x', 'e',
+    0x15, 0x00, 0x00, 0x80, 0x3e,
+    0x22, 0x02, 0x1a, 0x00,
+    0x22, 0x24, 0x0a, 0x22,
+    0x0a, 0x04, 'g', 'a', 'm', 'e',
+    0x12, 0x18, 'C', ':', '\\', 'U', 's', 'e', 'r', 's', '\\', 'm', 'e', '\\',
+    'd', 'e', 'c', 'l', 'v', 'o', 'l', '.', 't', 'o', 'm', 'l',
+    0x18, 0x01,
+})};
+
+// The version field that the codec appends to every message.
+const Bytes VersionTail{bytes({0x78, static_cast<unsigned char>(em::wire::Version)})};
+
+class Checker {
+public:
+  void check(bool ok, std::string_view what) {
+    if (ok) return;
+    std::cerr << "FAILED: " << what << '\n';
+    mFailed = true;
+  }
+
+  void check_bytes(std::span<const std::byte> actual, const Bytes &expected, std::string_view what) {
+    if (std::equal(actual.begin(), actual.end(), expected.begin(), expected.end())) return;
+    std::cerr << "FAILED: " << what << "\n  expected " << hex(expected) << "\n  actual   " << hex(actual) << '\n';
+    mFailed = true;
+  }
+
+  bool failed() const { return mFailed; }
+
+private:
+  bool mFailed{false};
+};
+
+Bytes encode(const em::wire::SwitchProfileRequest &request) {
+  Bytes out(em::wire::encoded_size(request));
+  out.resize(em::wire::encode(request, out));
+  return out;
+}
+
+Bytes encode(const em::wire::CommandBatch &batch) {
+  Bytes out(em::wire::encoded_size(batch));
+  out.resize(em::wire::encode(batch, out));
+  return out;
+}
+
+bool same_request(const em::wire::SwitchProfileRequest &a, const em::wire::SwitchProfileRequest &b) {
+  return a.version == b.version && a.profile == b.profile && a.configPath == b.configPath
+         && a.operation == b.operation;
+}
+
+/**
+ * Check that `request` encodes as `golden` plus the version, and that both
+ * that and `golden` on its own decode to `request`.
+ */
+void check_request(Checker &checker, const em::wire::SwitchProfileRequest &request, const Bytes &golden,
+                   std::string_view name) {
+  const std::string prefix{name};
+  const auto encoded{encode(request)};
+  checker.check_bytes(encoded, concat(golden, VersionTail), prefix + ": encode");
+
+  const auto decoded{em::wire::decode_switch_profile(encoded)};
+  checker.check(decoded && same_request(*decoded, request), prefix + ": decode round trip");
+
+  // Without the version this is what a Protobuf writer sends.
+  auto unversioned{request};
+  unversioned.version = 0u;
+  const auto legacy{em::wire::decode_switch_profile(golden)};
+  checker.check(legacy && same_request(*legacy, unversioned), prefix + ": decode without version");
+
+  const auto batch{em::wire::decode_request(encoded)};
+  checker.check(batch && batch->version == request.version && batch->commands.size() == 1
+                        && std::holds_alternative<em::wire::SwitchProfileRequest>(batch->commands[0])
+                        && same_request(std::get<em::wire::SwitchProfileRequest>(batch->commands[0]), request),
+                prefix + ": decode as a batch of one");
+}
+
+bool same_command(const em::wire::Command &a, const em::wire::Command &b) {
+  if (a.index() != b.index()) return false;
+  if (const auto *request{std::get_if<em::wire::SwitchProfileRequest>(&a)}) {
+    // Commands inside a batch have no version of their own.
+    auto expected{std::get<em::wire::SwitchProfileRequest>(b)};
+    return request->profile == expected.profile && request->configPath == expected.configPath
+           && request->operation == expected.operation;
+  }
+  if (const auto *setOverride{std::get_if<em::wire::SetOverride>(&a)}) {
+    const auto &expected{std::get<em::wire::SetOverride>(b)};
+    return setOverride->suffix == expected.suffix && setOverride->volume == expected.volume;
+  }
+  return true;
+}
+
+bool same_batch(const em::wire::CommandBatch &a, const em::wire::CommandBatch &b) {
+  return a.version == b.version
+         && std::equal(a.commands.begin(), a.commands.end(), b.commands.begin(), b.commands.end(), same_command);
+}
+
+#ifdef EM_USE_PROTOBUF
+void check_protobuf(Checker &checker, const ::google::protobuf::MessageLite &message, const Bytes &golden,
+                    std::string_view name) {
+  const auto serialised{message.SerializeAsString()};
+  checker.check_bytes(std::as_bytes(std::span{serialised}), golden, std::string{name} + ": libprotobuf");
+}
+#endif
+
+}// namespace
+
+int main() try {
+  Checker checker;
+
+  const em::wire::SwitchProfileRequest plain{.profile = "work", .configPath = ConfigPath};
+  check_request(checker, plain, PlainRequest, "plain request");
+
+  const em::wire::SwitchProfileRequest push{.profile = "game", .configPath = ConfigPath,
+                                            .operation = em::wire::Operation::Push};
+  check_request(checker, push, PushRequest, "push request");
+
+  em::wire::SwitchProfileRequest pop;
+  pop.operation = em::wire::Operation::Pop;
+  check_request(checker, pop, LegacyPopRequest, "legacy pop request");
+
+  const em::wire::CommandBatch batch{.commands = {
+      em::wire::SetOverride{.suffix = R"(\chat.exe)", .volume = 0.25f},
+      em::wire::ClearOverrides{},
+      push,
+  }};
+  {
+    const auto encoded{encode(batch)};
+    checker.check_bytes(encoded, concat(Batch, VersionTail), "batch: encode");
+    const auto decoded{em::wire::decode_request(encoded)};
+    checker.check(decoded && same_batch(*decoded, batch), "batch: decode round trip");
+
+    auto unversioned{batch};
+    unversioned.version = 0u;
+    const auto legacy{em::wire::decode_request(Batch)};
+    checker.check(legacy && same_batch(*legacy, unversioned), "batch: decode without version");
+  }
+
+  // Without commands a message is a request on its own, whatever else it has,
+  // including no fields at all.
+  {
+    const auto encoded{concat(PlainRequest, VersionTail)};
+    const auto decoded{em::wire::decode_request(encoded)};
+    checker.check(decoded && same_batch(*decoded, em::wire::CommandBatch{.commands = {plain}}),
+                  "request without commands: decode as a batch of one");
+
+    const auto empty{em::wire::decode_request({})};
+    checker.check(empty && same_batch(*empty, em::wire::CommandBatch{.version = 0u,
+                                                                     .commands = {em::wire::SwitchProfileRequest{}}}),
+                  "empty message: decode as a batch of one");
+  }
+
+  // A buffer one byte too small must be refused rather than overrun.
+  {
+    Bytes small(em::wire::encoded_size(plain) - 1);
+    bool threw{false};
+    try {
+      em::wire::encode(plain, small);
+    } catch (const em::wire::WireError &) {
+      threw = true;
+    }
+    checker.check(threw, "encode into a buffer too small");
+  }
+
+  // A length running past the end of the message is not a valid message.
+  {
+    const auto truncated{bytes({0x0a, 0x05, 'w', 'o', 'r', 'k'})};
+    checker.check(!em::wire::decode_switch_profile(truncated), "decode a truncated string");
+  }
+
+#ifdef EM_USE_PROTOBUF
+  {
+    ::declvol::v1::SwitchProfileRequest request;
+    request.set_profile("work");
+    request.set_config_path(std::string{ConfigPath});
+    check_protobuf(checker, request, PlainRequest, "plain request");
+
+    request.set_profile("game");
+    request.set_operation(::declvol::v1::SwitchProfileRequest_Operation_OPERATION_PUSH);
+    check_protobuf(checker, request, PushRequest, "push request");
+
+    request.Clear();
+    request.set_operation(::declvol::v1::SwitchProfileRequest_Operation_OPERATION_POP);
+    check_protobuf(checker, request, LegacyPopRequest, "legacy pop request");
+
+    // And libprotobuf reads what the codec writes, skipping the version.
+    const auto encoded{encode(push)};
+    checker.check(request.ParseFromArray(encoded.data(), static_cast<int>(encoded.size()))
+                          && request.profile() == "game" && request.config_path() == ConfigPath
+                          && request.operation() == ::declvol::v1::SwitchProfileRequest_Operation_OPERATION_PUSH,
+                  "push request: parse with libprotobuf");
+  }
+  {
+    ::declvol::v1::CommandBatch message;
+    auto *setOverride{message.add_commands()->mutable_set_override()};
+    setOverride->set_suffix(R"(\chat.exe)");
+    setOverride->set_volume(0.25f);
+    message.add_commands()->mutable_clear_overrides();
+    auto *request{message.add_commands()->mutable_switch_profile()};
+    request->set_profile("game");
+    request->set_config_path(std::string{ConfigPath});
+    request->set_operation(::declvol::v1::SwitchProfileRequest_Operation_OPERATION_PUSH);
+    check_protobuf(checker, message, Batch, "batch");
+  }
+#endif
+
+  return checker.failed() ? 1 : 0;
+} catch (const std::exception &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,736 @@
+// Benchmark the parts of the library behind the waiter and setters, against
+// simulated sessions and processes so that the numbers can be taken on any
+// machine.
+//
+// Usage: bench [<benchmark>...]
+//
+// Runs the named benchmarks, or all of them if none are named, and prints a
+// table of results for each. `bench --list` lists the benchmarks.
+
+#include "declvol/arena.h"
+#include "declvol/embedded.h"
+#include "declvol/log.h"
+#include "declvol/match_memo.h"
+#include "declvol/process_index.h"
+#include "declvol/profile.h"
+#include "declvol/ramp.h"
+#include "declvol/rpc.h"
+#include "declvol/session_match.h"
+#include "declvol/wire.h"
+
+#ifdef EM_USE_PROTOBUF
+#include "declvol/v1/declvol.pb.h"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+/**
+ * Return `d` in microseconds.
+ */
+double to_us(SteadyClock::duration d) {
+  return std::chrono::duration<double, std::micro>(d).count();
+}
+
+/**
+ * Return the `p`th quantile of `samples`, sorting them first.
+ */
+SteadyClock::duration quantile(std::vector<SteadyClock::duration> &samples, double p) {
+  if (samples.empty()) return {};
+  std::ranges::sort(samples);
+  return samples[static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1) + 0.5)];
+}
+
+/**
+ * Return how long `f()` takes the first time it is called, and the median of
+ * `runs` more calls.
+ */
+template<class F>
+std::pair<SteadyClock::duration, SteadyClock::duration> time_runs(std::size_t runs, F &&f) {
+  auto start{SteadyClock::now()};
+  f();
+  const auto first{SteadyClock::now() - start};
+
+  std::vector<SteadyClock::duration> samples;
+  for (std::size_t i{0}; i < runs; ++i) {
+    start = SteadyClock::now();
+    f();
+    samples.push_back(SteadyClock::now() - start);
+  }
+  return {first, quantile(samples, 0.5)};
+}
+
+/**
+ * Return the image path of the `i`th simulated application.
+ */
+std::string app_path(std::size_t i) {
+  return std::format(R"(C:\Program Files\App{}\app{}.exe)", i, i);
+}
+
+/**
+ * Return the application and volume of the `control`th control of the
+ * `profile`th profile of a generated config with `numControls` controls in each
+ * profile.
+ *
+ * Each profile gives a new volume to most of the applications of the one it
+ * extends, so that loading it removes the controls that it shadows.
+ */
+std::pair<std::size_t, float> config_control(std::size_t profile, std::size_t control, std::size_t numControls) {
+  return {(control * 7 + profile) % (numControls + numControls / 4),
+          static_cast<float>((control + profile) % 100) / 100.0f};
+}
+
+/**
+ * Write a config file to `path` with `numProfiles` profiles of
+ * `numControls` controls each, every profile but the first extending the one
+ * before it.
+ */
+void write_config(const std::filesystem::path &path, std::size_t numProfiles, std::size_t numControls) {
+  std::ofstream file{path, std::ios::trunc};
+  for (std::size_t profile{0}; profile < numProfiles; ++profile) {
+    file << std::format("[profile{}]\n", profile);
+    if (profile > 0) file << std::format("extends = \"profile{}\"\n", profile - 1);
+    file << "controls = [\n";
+    for (std::size_t control{0}; control < numControls; ++control) {
+      const auto [app, volume]{config_control(profile, control, numControls)};
+      file << std::format("  {{ suffix = '\\app{}.exe', volume = {:.2f} }},\n", app, volume);
+    }
+    file << "]\n\n";
+  }
+  if (!file.flush()) throw std::runtime_error(std::format("Could not write {}", path.string()));
+}
+
+/**
+ * A config file in the temporary directory that is removed again when it goes
+ * out of scope.
+ */
+class TempConfig {
+public:
+  TempConfig(std::size_t numProfiles, std::size_t numControls)
+      : mPath{std::filesystem::temp_directory_path() / std::format("declvol_bench_{}x{}.toml", numProfiles, numControls)} {
+    write_config(mPath, numProfiles, numControls);
+  }
+
+  TempConfig(const TempConfig &) = delete;
+  TempConfig &operator=(const TempConfig &) = delete;
+
+  ~TempConfig() {
+    std::error_code ec;
+    std::filesystem::remove(mPath, ec);
+  }
+
+  [[nodiscard]] const std::filesystem::path &path() const noexcept {
+    return mPath;
+  }
+
+private:
+  std::filesystem::path mPath;
+};
+
+/**
+ * Volume standing in for that of an audio session, written once a profile has
+ * been resolved so that the work cannot be optimised away.
+ */
+volatile float gSessionVolume{};
+
+/**
+ * Sink for sizes and counts, so that the work producing them cannot be
+ * optimised away.
+ */
+volatile std::size_t gSink{};
+
+/**
+ * Compare the time from wanting a profile to setting the volume of the first
+ * session with it, between reading a config file at runtime and using the same
+ * profiles compiled into the executable.
+ *
+ * Each path resolves the last profile, which extends every other, builds the
+ * memo the waiter keeps for it, matches a session and writes its volume. The
+ * embedded tables are made from the config file by the same flattening as
+ * `embed_profiles`. The work common to both, such as starting the process and
+ * finding the audio device, is left out.
+ */
+void bench_embedded() {
+  std::cout << std::format("{:>9} {:>9} {:>15} {:>15} {:>15} {:>15}\n", "profiles", "controls",
+                           "parsed 1st (us)", "parsed (us)", "embedded 1st", "embedded (us)");
+  for (const auto &[numProfiles, numControls] :
+       std::initializer_list<std::pair<std::size_t, std::size_t>>{{1, 16}, {8, 32}, {32, 128}}) {
+    const TempConfig config{numProfiles, numControls};
+    const auto profileName{std::format("profile{}", numProfiles - 1)};
+    const auto session{app_path(1)};
+
+    // The same tables `embed_profiles` would generate.
+    std::pmr::monotonic_buffer_resource parsedArena;
+    const auto parsed{em::parse_profiles_toml(config.path(), &parsedArena)};
+    std::vector<std::vector<em::EmbeddedControl>> tables;
+    std::vector<em::EmbeddedProfile> embedded;
+    tables.reserve(parsed.size());
+    for (const auto &[name, profile] : parsed) {
+      auto &table{tables.emplace_back()};
+      for (const auto &control : profile.controls) {
+        table.push_back({control.suffix(), control.relative_volume(), control.fade().duration.count(),
+                         control.fade().curve, control.kind()});
+      }
+      embedded.push_back({name, table});
+    }
+
+    const auto set_first_volume{[&session](const em::VolumeProfile &profile) {
+      em::MatchMemo memo{std::make_shared<const em::VolumeProfile>(profile)};
+      if (const auto *control{memo.match(session)}) gSessionVolume = control->relative_volume();
+    }};
+    const auto [parsedFirst, parsedMedian]{time_runs(20, [&] {
+      std::pmr::monotonic_buffer_resource arena;
+      const auto profiles{em::parse_profiles_toml(config.path(), &arena)};
+      set_first_volume(profiles.find(std::string_view{profileName})->second);
+    })};
+    const auto [embeddedFirst, embeddedMedian]{time_runs(20, [&] {
+      em::ScratchArena<em::EmbeddedProfileArenaSize> arena;
+      const auto *profile{em::find_embedded_profile(embedded, profileName)};
+      set_first_volume(em::to_volume_profile(*profile, arena.resource()));
+    })};
+
+    std::cout << std::format("{:>9} {:>9} {:>15.1f} {:>15.1f} {:>15.1f} {:>15.1f}\n", numProfiles,
+                             numControls, to_us(parsedFirst), to_us(parsedMedian), to_us(embeddedFirst),
+                             to_us(embeddedMedian));
+  }
+}
+
+/**
+ * Compare the cost of matching sessions against the last profile of a large
+ * generated config before and after the controls that can never win are
+ * removed from it, along with how long reading the config takes.
+ *
+ * The profile before removal holds every control of every profile that it
+ * extends, in order, as it was flattened before dead controls were removed.
+ * Each session is matched by suffix alone, as a setter applying the profile or
+ * a waiter seeing an application for the first time does, and a fifth of them
+ * are of applications that no control matches.
+ */
+void bench_dead_controls() {
+  std::cout << std::format("{:>9} {:>9} {:>11} {:>9} {:>13} {:>14} {:>14}\n", "profiles", "controls", "read (ms)",
+                           "removed", "kept", "before (ns)", "after (ns)");
+  for (const auto &[numProfiles, numControls] :
+       std::initializer_list<std::pair<std::size_t, std::size_t>>{{8, 128}, {32, 256}, {64, 512}}) {
+    const TempConfig config{numProfiles, numControls};
+    const auto profileName{std::format("profile{}", numProfiles - 1)};
+
+    std::vector<em::DeadControl> dead;
+    std::pmr::monotonic_buffer_resource arena;
+    const auto readMedian{time_runs(5, [&] {
+      std::pmr::monotonic_buffer_resource scratch;
+      gSink = em::parse_profiles_toml(config.path(), &scratch).size();
+    }).second};
+    const auto profiles{em::parse_profiles_toml(config.path(), &arena, &dead)};
+    const auto &after{profiles.find(std::string_view{profileName})->second};
+
+    em::VolumeProfile before;
+    for (std::size_t profile{0}; profile < numProfiles; ++profile) {
+      for (std::size_t control{0}; control < numControls; ++control) {
+        const auto [app, volume]{config_control(profile, control, numControls)};
+        before.controls.emplace_back(std::format("\\app{}.exe", app), volume);
+      }
+    }
+
+    std::vector<std::string> sessions;
+    const auto numApps{numControls + numControls / 4};
+    for (std::size_t i{0}; i < numApps + numApps / 4; ++i) sessions.push_back(app_path(i));
+    const auto per_session{[&](const em::VolumeProfile &profile) {
+      constexpr std::size_t NumRounds{20};
+      const auto start{SteadyClock::now()};
+      for (std::size_t round{0}; round < NumRounds; ++round) {
+        for (const auto &session : sessions) {
+          if (const auto *control{em::match_control(profile, session)}) gSessionVolume = control->relative_volume();
+        }
+      }
+      return (SteadyClock::now() - start) / (NumRounds * sessions.size());
+    }};
+    const auto beforeCost{per_session(before)};
+    const auto afterCost{per_session(after)};
+
+    std::cout << std::format("{:>9} {:>9} {:>11.2f} {:>9} {:>13} {:>14.1f} {:>14.1f}\n", numProfiles, numControls,
+                             to_us(readMedian) / 1000.0, dead.size(),
+                             std::format("{}/{}", after.controls.size(), before.controls.size()),
+                             to_us(beforeCost) * 1000.0, to_us(afterCost) * 1000.0);
+  }
+}
+
+/**
+ * Return how long each of `iterations` calls of `f()` takes on average.
+ */
+template<class F>
+SteadyClock::duration time_each(std::size_t iterations, F &&f) {
+  const auto start{SteadyClock::now()};
+  for (std::size_t i{0}; i < iterations; ++i) f();
+  return (SteadyClock::now() - start) / iterations;
+}
+
+/**
+ * Print a row of the codec benchmark.
+ */
+void print_codec_row(std::string_view codec, std::string_view message,
+                     std::optional<SteadyClock::duration> first, SteadyClock::duration encode,
+                     SteadyClock::duration decode, std::size_t size) {
+  const auto firstUs{first ? std::format("{:.2f}", to_us(*first)) : std::string{"-"}};
+  std::cout << std::format("{:<10} {:<8} {:>14} {:>12.1f} {:>12.1f} {:>7}\n", codec, message, firstUs,
+                           to_us(encode) * 1000.0, to_us(decode) * 1000.0, size);
+}
+
+/**
+ * Compare the built-in codec against Protobuf, when it is built with
+ * `EM_USE_PROTOBUF`, on the messages that setters send.
+ *
+ * The first column is the time for the first encode and decode in the
+ * process, which for Protobuf includes initialising its runtime. Loading the
+ * Protobuf library itself happens before `main` and is not included. The rest
+ * are the average over many messages once warm.
+ */
+void bench_codec() {
+  constexpr std::size_t Iterations{200000};
+  constexpr std::string_view ConfigPath{R"(C:\Users\someone\AppData\Local\volume-setter\config.toml)"};
+  constexpr std::string_view ProfileName{"gaming"};
+  std::array<std::byte, em::MaxMessageSize> buf{};
+
+  std::cout << std::format("{:<10} {:<8} {:>14} {:>12} {:>12} {:>7}\n", "codec", "message", "first (us)",
+                           "encode (ns)", "decode (ns)", "bytes");
+  {
+    const em::wire::SwitchProfileRequest request{em::wire::Version, ProfileName, ConfigPath,
+                                                 em::wire::Operation::Replace};
+    std::size_t size{};
+    const auto first{time_each(1, [&] {
+      size = em::wire::encode(request, buf);
+      gSink = em::wire::decode_request(std::span{buf}.first(size))->commands.size();
+    })};
+    const auto encode{time_each(Iterations, [&] { size = em::wire::encode(request, buf); })};
+    const auto decode{time_each(Iterations, [&] {
+      gSink = em::wire::decode_switch_profile(std::span{buf}.first(size))->profile.size();
+    })};
+    print_codec_row("wire", "switch", first, encode, decode, size);
+  }
+  {
+    em::wire::CommandBatch batch;
+    batch.commands.emplace_back(em::wire::ClearOverrides{});
+    for (std::size_t i{0}; i < 8; ++i) {
+      batch.commands.emplace_back(em::wire::SetOverride{R"(\discord.exe)", 0.25f});
+    }
+    std::size_t size{};
+    const auto encode{time_each(Iterations, [&] { size = em::wire::encode(batch, buf); })};
+    const auto decode{time_each(Iterations, [&] {
+      gSink = em::wire::decode_request(std::span{buf}.first(size))->commands.size();
+    })};
+    print_codec_row("wire", "batch", std::nullopt, encode, decode, size);
+  }
+
+#ifdef EM_USE_PROTOBUF
+  {
+    std::size_t size{};
+    const auto encode_request{[&] {
+      ::declvol::v1::SwitchProfileRequest request;
+      request.set_profile(std::string{ProfileName});
+      request.set_config_path(std::string{ConfigPath});
+      request.set_operation(::declvol::v1::SwitchProfileRequest_Operation_OPERATION_REPLACE);
+      size = request.ByteSizeLong();
+      request.SerializeToArray(buf.data(), static_cast<int>(buf.size()));
+    }};
+    const auto decode_request{[&] {
+      ::declvol::v1::SwitchProfileRequest request;
+      request.ParseFromArray(buf.data(), static_cast<int>(size));
+      gSink = request.profile().size();
+    }};
+    const auto first{time_each(1, [&] {
+      encode_request();
+      decode_request();
+    })};
+    const auto encode{time_each(Iterations, encode_request)};
+    const auto decode{time_each(Iterations, decode_request)};
+    print_codec_row("protobuf", "switch", first, encode, decode, size);
+  }
+  {
+    std::size_t size{};
+    const auto encode_batch{[&] {
+      ::declvol::v1::CommandBatch batch;
+      batch.add_commands()->mutable_clear_overrides();
+      for (std::size_t i{0}; i < 8; ++i) {
+        auto *setOverride{batch.add_commands()->mutable_set_override()};
+        setOverride->set_suffix(R"(\discord.exe)");
+        setOverride->set_volume(0.25f);
+      }
+      size = batch.ByteSizeLong();
+      batch.SerializeToArray(buf.data(), static_cast<int>(buf.size()));
+    }};
+    const auto decode_batch{[&] {
+      ::declvol::v1::CommandBatch batch;
+      batch.ParseFromArray(buf.data(), static_cast<int>(size));
+      gSink = static_cast<std::size_t>(batch.commands_size());
+    }};
+    const auto encode{time_each(Iterations, encode_batch)};
+    const auto decode{time_each(Iterations, decode_batch)};
+    print_codec_row("protobuf", "batch", std::nullopt, encode, decode, size);
+  }
+#else
+  std::cout << "(build with EM_USE_PROTOBUF to compare against Protobuf)\n";
+#endif
+}
+
+/**
+ * Observer collecting the processes of a snapshot, or scanning it for one.
+ */
+class ProcessList final : public em::ProcessObserver {
+public:
+  explicit ProcessList(std::uint32_t wanted = 0) : mWanted{wanted} {}
+
+  void process_started(std::uint32_t pid, std::uint32_t, std::string_view imagePath) override {
+    if (mWanted == 0) {
+      mPids.push_back(pid);
+    } else if (pid == mWanted) {
+      mFound = imagePath.size();
+    }
+  }
+
+  void process_stopped(std::uint32_t) override {}
+
+  [[nodiscard]] const std::vector<std::uint32_t> &pids() const {
+    return mPids;
+  }
+
+  [[nodiscard]] std::size_t found() const {
+    return mFound;
+  }
+
+private:
+  std::uint32_t mWanted;
+  std::vector<std::uint32_t> mPids;
+  std::size_t mFound{};
+};
+
+/**
+ * Return the PIDs of the running processes whose image path can be found.
+ */
+std::vector<std::uint32_t> running_pids(em::ProcessSource &source) {
+  ProcessList list;
+  source.snapshot(list);
+  if (list.pids().empty()) throw std::runtime_error("No running processes could be found");
+  return list.pids();
+}
+
+/**
+ * Compare finding the image path of a session's process in the index that the
+ * waiter keeps against resolving it when the session appears, by opening the
+ * process or by scanning a snapshot of every process for it.
+ *
+ * Unlike the other benchmarks this uses the real processes of the machine,
+ * through the same process source as the waiter, so the numbers depend on how
+ * many are running. Each session is of one of them, in turn.
+ */
+void bench_processes() {
+  auto source{em::make_process_source()};
+  const auto pids{running_pids(*source)};
+
+  const auto [buildFirst, buildMedian]{time_runs(5, [] {
+    const em::ProcessIndex index{em::make_process_source(), false};
+    gSink = index.size();
+  })};
+  std::cout << std::format("{} processes, building the index took {:.1f} us first, {:.1f} us median\n",
+                           pids.size(), to_us(buildFirst), to_us(buildMedian));
+
+  em::ProcessIndex index{em::make_process_source(), false};
+  const auto per_session{[&](std::size_t numSessions, auto &&f) {
+    const auto start{SteadyClock::now()};
+    for (std::size_t i{0}; i < numSessions; ++i) f(pids[i % pids.size()]);
+    return (SteadyClock::now() - start) / numSessions;
+  }};
+  const auto indexed{per_session(100000, [&](std::uint32_t pid) {
+    em::ScratchArena<em::SessionArenaSize> scratch;
+    gSink = index.image_path(pid, scratch.resource()).value_or("").size();
+  })};
+  const auto opened{per_session(std::max<std::size_t>(pids.size(), 1000), [&](std::uint32_t pid) {
+    gSink = source->image_path(pid).value_or("").size();
+  })};
+  const auto scanned{per_session(std::min<std::size_t>(pids.size(), 100), [&](std::uint32_t pid) {
+    ProcessList scan{pid};
+    source->snapshot(scan);
+    gSink = scan.found();
+  })};
+
+  std::cout << std::format("{:<14} {:>16}\n", "lookup", "per session (us)");
+  std::cout << std::format("{:<14} {:>16.3f}\n", "index", to_us(indexed));
+  std::cout << std::format("{:<14} {:>16.3f}\n", "open process", to_us(opened));
+  std::cout << std::format("{:<14} {:>16.3f}\n", "snapshot scan", to_us(scanned));
+}
+
+/**
+ * Process source resolving each process on its own, as the default
+ * `ProcessSource::resolve` does, whatever the source it wraps does instead.
+ */
+class PerPidSource final : public em::ProcessSource {
+public:
+  explicit PerPidSource(em::ProcessSource &source) : mSource{source} {}
+
+  void snapshot(em::ProcessObserver &observer) override {
+    mSource.snapshot(observer);
+  }
+
+  std::optional<std::string> image_path(std::uint32_t pid) override {
+    return mSource.image_path(pid);
+  }
+
+  std::optional<std::uint32_t> parent_pid(std::uint32_t pid) override {
+    return mSource.parent_pid(pid);
+  }
+
+  void watch(em::ProcessObserver &observer) override {
+    mSource.watch(observer);
+  }
+
+private:
+  em::ProcessSource &mSource;
+};
+
+/**
+ * Compare resolving the processes of every session at once, as a setter does
+ * when switching profile, against resolving each process on its own.
+ *
+ * Sessions are of the machine's real processes, several to a process once
+ * there are more sessions than processes, as with browsers and games. The
+ * `/proc` source has no batch resolver, so on Linux both columns measure the
+ * same thing and only show the noise between runs.
+ */
+void bench_resolve() {
+  auto source{em::make_process_source()};
+  PerPidSource perPid{*source};
+  const auto running{running_pids(*source)};
+
+  std::cout << std::format("{} processes\n", running.size());
+#ifndef _WIN32
+  std::cout << "/proc has no batch resolver, so both columns resolve each process on its own\n";
+#endif
+  std::cout << std::format("{:>9} {:>16} {:>16}\n", "sessions", "batch (us)", "per pid (us)");
+  for (const auto numSessions : std::initializer_list<std::size_t>{10, 100, 1000}) {
+    std::vector<std::uint32_t> pids(numSessions);
+    for (std::size_t i{0}; i < numSessions; ++i) pids[i] = running[i % running.size()];
+
+    const auto resolve_with{[&](em::ProcessSource &resolver) {
+      return time_runs(20, [&] {
+        std::size_t numResolved{0};
+        resolver.resolve(pids, [&](std::size_t, std::optional<std::string_view> path) {
+          if (path) ++numResolved;
+        });
+        gSink = numResolved;
+      }).second;
+    }};
+    const auto batch{resolve_with(*source)};
+    const auto each{resolve_with(perPid)};
+    std::cout << std::format("{:>9} {:>16.1f} {:>16.1f}\n", numSessions, to_us(batch), to_us(each));
+  }
+}
+
+/**
+ * Compare the cost of handling a new session, with its volume written to a
+ * stand-in, when the line reporting it is not logged, is queued on the
+ * asynchronous logger, and is written and flushed on the spot as it was before
+ * that logger.
+ *
+ * Lines go to a file in the temporary directory rather than the console, so
+ * the numbers are for a fast output. The logger drops lines rather than wait
+ * once its buffer is full, which at this rate it is, so how many were dropped
+ * is shown too.
+ */
+void bench_logging() {
+  constexpr std::size_t NumSessions{20000};
+  constexpr std::size_t NumApps{64};
+
+  em::VolumeProfile profile;
+  for (std::size_t i{0}; i < NumApps; ++i) {
+    profile.controls.emplace_back(std::format("\\app{}.exe", i), static_cast<float>(i % 10) / 10.0f);
+  }
+  em::MatchMemo memo{std::make_shared<const em::VolumeProfile>(std::move(profile))};
+  std::vector<std::string> sessions;
+  for (std::size_t i{0}; i < NumApps; ++i) sessions.push_back(app_path(i));
+
+  const auto logPath{std::filesystem::temp_directory_path() / "declvol_bench_logging.log"};
+  const auto handle_sessions{[&](auto &&log) {
+    const auto start{SteadyClock::now()};
+    for (std::size_t i{0}; i < NumSessions; ++i) {
+      const auto &name{sessions[i % NumApps]};
+      const auto *control{em::match_session(memo, name, 0, [](em::MatchKind) -> std::optional<std::string> {
+        return std::nullopt;
+      }, nullptr, nullptr)};
+      if (!control) continue;
+      gSessionVolume = control->relative_volume();
+      log(name, control->relative_volume());
+    }
+    return (SteadyClock::now() - start) / NumSessions;
+  }};
+
+  std::cout << std::format("{:<12} {:>18} {:>18} {:>9}\n", "logging", "per session (us)", "until written (us)",
+                           "dropped");
+  for (const auto level : {em::LogLevel::Warning, em::LogLevel::Info}) {
+    const auto start{SteadyClock::now()};
+    std::uint64_t dropped{};
+    SteadyClock::duration perSession{};
+    {
+      em::Logger log{logPath, level};
+      perSession = handle_sessions([&](std::string_view name, float volume) {
+        log.info("Set volume of {} to {}", name, volume);
+      });
+      log.flush();
+      dropped = log.dropped();
+    }
+    const auto written{(SteadyClock::now() - start) / NumSessions};
+    std::cout << std::format("{:<12} {:>18.3f} {:>18.3f} {:>9}\n", level == em::LogLevel::Info ? "async" : "off",
+                             to_us(perSession), to_us(written), dropped);
+  }
+  {
+    const auto start{SteadyClock::now()};
+    std::ofstream file{logPath, std::ios::app};
+    const auto perSession{handle_sessions([&](std::string_view name, float volume) {
+      file << "Set volume of " << name << " to " << volume << std::endl;
+    })};
+    const auto written{(SteadyClock::now() - start) / NumSessions};
+    std::cout << std::format("{:<12} {:>18.3f} {:>18.3f} {:>9}\n", "synchronous", to_us(perSession),
+                             to_us(written), 0);
+  }
+
+  std::error_code ec;
+  std::filesystem::remove(logPath, ec);
+}
+
+/**
+ * Ramp target standing in for an audio session, which counts how often its
+ * volume is written.
+ */
+class SimulatedTarget final : public em::RampTarget {
+public:
+  explicit SimulatedTarget(std::atomic<std::uint64_t> &writes) : mWrites{writes} {}
+
+  float volume() override {
+    return mVolume.load(std::memory_order_relaxed);
+  }
+
+  void set_volume(float volume) override {
+    mVolume.store(volume, std::memory_order_relaxed);
+    mWrites.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<float> mVolume{0.0f};
+  std::atomic<std::uint64_t> &mWrites;
+};
+
+/**
+ * Fade thousands of simulated sessions at once, then retarget every one of
+ * them halfway through, as switching profiles twice in quick succession does.
+ *
+ * Reports the cost of starting and retargeting a ramp while every other ramp
+ * is in flight, how many times each target was written, and how late the last
+ * ramp finished compared to its fade.
+ */
+void bench_ramps() {
+  constexpr em::Fade fade{std::chrono::milliseconds{1000}, em::RampCurve::Smooth};
+
+  std::cout << std::format("{:>8} {:>12} {:>14} {:>14} {:>14} {:>10}\n", "ramps", "start (us)",
+                           "retarget p50", "retarget max", "writes/ramp", "late (ms)");
+  for (const std::size_t numRamps : {1000u, 4000u, 16000u}) {
+    std::atomic<std::uint64_t> writes{0};
+    std::vector<std::shared_ptr<SimulatedTarget>> targets;
+    std::vector<std::string> keys;
+    for (std::size_t i{0}; i < numRamps; ++i) {
+      targets.push_back(std::make_shared<SimulatedTarget>(writes));
+      keys.push_back(std::format("session-{}", i));
+    }
+
+    em::RampScheduler ramps;
+    const auto start{SteadyClock::now()};
+    for (std::size_t i{0}; i < numRamps; ++i) {
+      // Spread the targets so that ramps move at different rates.
+      ramps.start(keys[i], targets[i], static_cast<float>(i % 100 + 1) / 100.0f, fade);
+    }
+    const auto started{SteadyClock::now()};
+
+    std::this_thread::sleep_until(start + fade.duration / 2);
+    std::vector<SteadyClock::duration> retargets;
+    retargets.reserve(numRamps);
+    const auto retargetStart{SteadyClock::now()};
+    for (std::size_t i{0}; i < numRamps; ++i) {
+      const auto before{SteadyClock::now()};
+      ramps.start(keys[i], targets[i], static_cast<float>(numRamps - i) / static_cast<float>(numRamps), fade);
+      retargets.push_back(SteadyClock::now() - before);
+    }
+    ramps.wait_idle();
+    const auto late{SteadyClock::now() - retargetStart - fade.duration};
+
+    std::cout << std::format("{:>8} {:>12.2f} {:>14.2f} {:>14.2f} {:>14.1f} {:>10.1f}\n", numRamps,
+                             to_us(started - start) / static_cast<double>(numRamps), to_us(quantile(retargets, 0.5)),
+                             to_us(quantile(retargets, 1.0)),
+                             static_cast<double>(writes.load()) / static_cast<double>(numRamps),
+                             to_us(late) / 1000.0);
+  }
+}
+
+struct Benchmark {
+  std::string_view name;
+  void (*run)();
+};
+
+constexpr std::array Benchmarks{
+    Benchmark{"ramps", &bench_ramps},
+    Benchmark{"embedded", &bench_embedded},
+    Benchmark{"codec", &bench_codec},
+    Benchmark{"processes", &bench_processes},
+    Benchmark{"resolve", &bench_resolve},
+    Benchmark{"logging", &bench_logging},
+    Benchmark{"dead-controls", &bench_dead_controls},
+};
+
+}// namespace
+
+int main(int argc, char *argv[]) try {
+  std::vector<const Benchmark *> selected;
+  for (int i{1}; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (arg == "--list") {
+      for (const auto &benchmark : Benchmarks) std::cout << benchmark.name << '\n';
+      return 0;
+    }
+    const auto it{std::ranges::find(Benchmarks, arg, &Benchmark::name)};
+    if (it == Benchmarks.end()) {
+      std::cerr << "usage: bench [--list] [<benchmark>...]\n";
+      return 1;
+    }
+    selected.push_back(&*it);
+  }
+  if (selected.empty()) {
+    for (const auto &benchmark : Benchmarks) selected.push_back(&benchmark);
+  }
+
+  for (const auto *benchmark : selected) {
+    std::cout << std::format("== {}\n", benchmark->name);
+    benchmark->run();
+  }
+  return 0;
+} catch (const std::exception &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,132 @@
+// Generate a header containing the profiles of a config file as constexpr
+// tables, so that they can be compiled into the executable.
+//
+// Usage: embed_profiles <config.toml> <output.h>
+
+#include "declvol/profile.h"
+
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+/**
+ * Return `str` as a C++ string literal.
+ */
+std::string to_string_literal(std::string_view str) {
+  std::string literal{"\""};
+  for (const char c : str) {
+    switch (c) {
+    case '"': literal += "\\\""; break;
+    case '\\': literal += "\\\\"; break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20 || c == 0x7f) {
+        // Always use three octal digits so that the escape cannot run into
+        // the following character.
+        literal += std::format("\\{:03o}", static_cast<unsigned char>(c));
+      } else {
+        literal += c;
+      }
+    }
+  }
+  literal += '"';
+  return literal;
+}
+
+/**
+ * Return the spelling of a ramp curve as a C++ enumerator.
+ */
+std::string_view to_enumerator(em::RampCurve curve) {
+  switch (curve) {
+  case em::RampCurve::Linear: return "em::RampCurve::Linear";
+  case em::RampCurve::EaseIn: return "em::RampCurve::EaseIn";
+  case em::RampCurve::EaseOut: return "em::RampCurve::EaseOut";
+  case em::RampCurve::Smooth: return "em::RampCurve::Smooth";
+  }
+  return "em::RampCurve::Linear";
+}
+
+/**
+ * Return the spelling of a match kind as a C++ enumerator.
+ */
+std::string_view to_enumerator(em::MatchKind kind) {
+  switch (kind) {
+  case em::MatchKind::Suffix: return "em::MatchKind::Suffix";
+  case em::MatchKind::DisplayName: return "em::MatchKind::DisplayName";
+  case em::MatchKind::IconPath: return "em::MatchKind::IconPath";
+  case em::MatchKind::SessionId: return "em::MatchKind::SessionId";
+  case em::MatchKind::Ancestor: return "em::MatchKind::Ancestor";
+  }
+  return "em::MatchKind::Suffix";
+}
+
+}// namespace
+
+int main(int argc, char *argv[]) try {
+  if (argc != 3) {
+    std::cerr << "usage: embed_profiles <config.toml> <output.h>\n";
+    return 1;
+  }
+
+  const std::string_view configPath{argv[1]};
+  const auto profiles{em::parse_profiles_toml(configPath)};
+
+  std::string out;
+  out += std::format("// Generated by embed_profiles from {}. Do not edit.\n\n", configPath);
+  out += "#include \"declvol/embedded.h\"\n\n";
+  out += "namespace em::embedded {\n\n";
+
+  // Profiles without any controls use an empty span, because C++ does not
+  // allow empty arrays.
+  std::size_t index{0};
+  for (const auto &[name, profile] : profiles) {
+    if (!profile.controls.empty()) {
+      out += std::format("inline constexpr EmbeddedControl Profile{}Controls[] = {{\n", index);
+      for (const auto &control : profile.controls) {
+        // The alternate form always includes a decimal point, so appending the
+        // suffix gives a valid float literal.
+        out += std::format("    {{{}, {:#}f, {}, {}, {}}},\n",
+                           to_string_literal(control.suffix()),
+                           control.relative_volume(),
+                           control.fade().duration.count(),
+                           to_enumerator(control.fade().curve),
+                           to_enumerator(control.kind()));
+      }
+      out += "};\n\n";
+    }
+    ++index;
+  }
+
+  // `parse_profiles_toml` returns the profiles sorted by name, which is what
+  // `find_embedded_profile` needs to binary search them.
+  out += "inline constexpr EmbeddedProfile Profiles[] = {\n";
+  index = 0;
+  for (const auto &[name, profile] : profiles) {
+    if (profile.controls.empty()) {
+      out += std::format("    {{{}, {{}}}},\n", to_string_literal(name));
+    } else {
+      out += std::format("    {{{}, Profile{}Controls}},\n", to_string_literal(name), index);
+    }
+    ++index;
+  }
+  out += "};\n\n";
+  out += "}// namespace em::embedded\n";
+
+  std::ofstream file{argv[2], std::ios::binary};
+  file << out;
+  if (!file) {
+    std::cerr << "Could not write " << argv[2] << '\n';
+    return 1;
+  }
+  return 0;
+} catch (const em::ProfileError &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+} catch (const std::exception &e) {
+  std::cerr << "Unhandled exception: " << e.what() << '\n';
+  return 1;
+}
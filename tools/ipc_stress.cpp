@@ -0,0 +1,412 @@
+// Load the interprocess queue with requests from many setters at once, and
+// report how many got through, how long the waiter took to see them, and
+// whether it ended up on the profile it was last asked for.
+//
+// Usage: ipc_stress [--clients <n>] [--requests <n>] [--rate <per second>]
+//                   [--capacity <n>] [--queue <name>] [--processes]
+//
+// Each of `--clients` setters sends `--requests` `SwitchProfileRequest`s, at
+// most `--rate` a second each, or as fast as it can if the rate is 0. Setters
+// are threads, or with `--processes` separate processes, each opening the
+// queue for itself as a setter does. Sends that find the queue full are
+// rejected rather than retried, exactly as a setter does.
+//
+// The waiter side pulls requests off the queue the same way as
+// `DeclvolService::wait` and runs them on an event loop, except that running a
+// request only notes which profile it names. The queue is created by this tool
+// under its own name, `--queue`, so that a real waiter is not disturbed, with
+// the same capacity as a waiter's unless `--capacity` is given.
+//
+// Every profile name carries the setter, its sequence number and the time it
+// was sent, so latencies can be measured without any shared state between the
+// two sides.
+
+#include "declvol/event_loop.h"
+#include "declvol/rpc.h"
+#include "declvol/wire.h"
+
+#include <boost/interprocess/ipc/message_queue.hpp>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ipc = boost::interprocess;
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr std::string_view ConfigPath = "ipc_stress";
+
+struct Options {
+  std::uint32_t clients{8};
+  std::uint32_t requests{1000};
+  std::uint32_t rate{0};
+  std::size_t capacity{em::RpcQueueCapacity};
+  std::string queueName{std::string{em::RpcQueueName} + "_stress"};
+  bool processes{};
+};
+
+/**
+ * What one setter managed to send.
+ */
+struct ClientResult {
+  std::uint64_t delivered{};
+  std::uint64_t rejected{};
+  // Sequence number of the last request that was delivered, plus one, or 0 if
+  // none were.
+  std::uint64_t lastDelivered{};
+};
+
+/**
+ * A request as seen by the waiter side, decoded from its profile name.
+ */
+struct Sent {
+  std::uint32_t client{};
+  std::uint64_t seq{};
+  SteadyClock::time_point time;
+};
+
+/**
+ * Return the number at the start of `str`, removing it and one following
+ * separator from `str`, or an empty optional if there is none.
+ */
+template<class T>
+std::optional<T> take_number(std::string_view &str) {
+  T value{};
+  const auto [end, ec]{std::from_chars(str.data(), str.data() + str.size(), value)};
+  if (ec != std::errc{}) return std::nullopt;
+  str.remove_prefix(static_cast<std::size_t>(end - str.data()));
+  if (!str.empty()) str.remove_prefix(1);
+  return value;
+}
+
+std::string make_profile_name(std::uint32_t client, std::uint64_t seq) {
+  const auto now{SteadyClock::now().time_since_epoch()};
+  return std::format("{}-{}-{}", client, seq, std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+std::optional<Sent> parse_profile_name(std::string_view name) {
+  const auto client{take_number<std::uint32_t>(name)};
+  const auto seq{take_number<std::uint64_t>(name)};
+  const auto ns{take_number<std::int64_t>(name)};
+  if (!client || !seq || !ns) return std::nullopt;
+  return Sent{*client, *seq, SteadyClock::time_point{std::chrono::nanoseconds{*ns}}};
+}
+
+/**
+ * Send the requests of one setter, returning how many got through.
+ */
+ClientResult run_client(const Options &options, std::uint32_t client) {
+  ipc::message_queue queue{ipc::open_only, options.queueName.c_str()};
+  ClientResult result;
+  std::array<std::byte, em::MaxMessageSize> buf{};
+  const auto start{SteadyClock::now()};
+
+  for (std::uint64_t seq{0}; seq < options.requests; ++seq) {
+    if (options.rate > 0) {
+      std::this_thread::sleep_until(start + seq * std::chrono::duration_cast<SteadyClock::duration>(
+                                                      std::chrono::seconds{1}) / options.rate);
+    }
+
+    const auto profile{make_profile_name(client, seq)};
+    const em::wire::SwitchProfileRequest request{.profile = profile, .configPath = ConfigPath};
+    const auto size{em::wire::encode(request, buf)};
+    if (queue.try_send(buf.data(), size, 0)) {
+      ++result.delivered;
+      result.lastDelivered = seq + 1;
+    } else {
+      ++result.rejected;
+    }
+  }
+  return result;
+}
+
+/**
+ * Stand-in for the waiter, pulling requests off the queue and running them on
+ * an event loop as `DeclvolService` does.
+ */
+class StressWaiter {
+public:
+  StressWaiter(ipc::message_queue &queue, std::uint32_t clients)
+      : mQueue{queue},
+        mLoop{em::make_event_loop()},
+        mLastHandled(clients, 0) {}
+
+  /**
+   * Start pulling and running requests on threads of their own.
+   */
+  void start() {
+    mLoopThread = std::thread{[this] { mLoop->run(); }};
+    mReceiver = std::thread{[this] { receive(); }};
+  }
+
+  /**
+   * Wait for the queue to empty and every request pulled from it to be run,
+   * then stop.
+   */
+  void finish() {
+    while (mQueue.get_num_msg() > 0) std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    mClosed.store(true, std::memory_order_release);
+    mReceiver.join();
+    // Posted work runs in order, so this runs after every request.
+    mLoop->post([this] { mLoop->stop(); });
+    mLoopThread.join();
+  }
+
+  std::vector<SteadyClock::duration> &queue_latencies() noexcept {
+    return mQueueLatencies;
+  }
+
+  std::vector<SteadyClock::duration> &handle_latencies() noexcept {
+    return mHandleLatencies;
+  }
+
+  [[nodiscard]] std::uint64_t invalid() const noexcept {
+    return mInvalid;
+  }
+
+  [[nodiscard]] const std::string &final_profile() const noexcept {
+    return mFinalProfile;
+  }
+
+  /**
+   * Return, for each setter, the sequence number of the last of its requests
+   * that was run, plus one, or 0 if none were.
+   */
+  [[nodiscard]] const std::vector<std::uint64_t> &last_handled() const noexcept {
+    return mLastHandled;
+  }
+
+private:
+  void receive() {
+    // A waiter polls once a second, which would only make the tool slow to
+    // finish.
+    constexpr auto pollInterval{std::chrono::milliseconds{100}};
+    std::array<std::byte, em::MaxMessageSize> buf{};
+
+    while (!mClosed.load(std::memory_order_acquire)) {
+      std::size_t size{};
+      unsigned int priority{};
+      if (!mQueue.timed_receive(buf.data(), buf.size(), size, priority, SteadyClock::now() + pollInterval)) {
+        continue;
+      }
+      const auto received{SteadyClock::now()};
+
+      const auto request{em::wire::decode_switch_profile(std::span{buf.data(), size})};
+      const auto sent{request ? parse_profile_name(request->profile) : std::nullopt};
+      if (!sent || sent->client >= mLastHandled.size()) {
+        ++mInvalid;
+        continue;
+      }
+      mQueueLatencies.push_back(received - sent->time);
+      mLoop->post([this, sent = *sent, profile = std::string{request->profile}] {
+        mHandleLatencies.push_back(SteadyClock::now() - sent.time);
+        mLastHandled[sent.client] = sent.seq + 1;
+        mFinalProfile = profile;
+      });
+    }
+  }
+
+  ipc::message_queue &mQueue;
+  std::unique_ptr<em::EventLoop> mLoop;
+  std::thread mLoopThread;
+  std::thread mReceiver;
+  std::atomic<bool> mClosed{false};
+  // Only touched by the receiver.
+  std::vector<SteadyClock::duration> mQueueLatencies;
+  std::uint64_t mInvalid{0};
+  // Only touched on the loop.
+  std::vector<SteadyClock::duration> mHandleLatencies;
+  std::vector<std::uint64_t> mLastHandled;
+  std::string mFinalProfile;
+};
+
+void print_latencies(std::string_view what, std::vector<SteadyClock::duration> &samples) {
+  if (samples.empty()) return;
+  std::ranges::sort(samples);
+  const auto at{[&samples](double p) {
+    const auto rank{static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1) + 0.5)};
+    return std::chrono::duration_cast<std::chrono::microseconds>(samples[rank]).count();
+  }};
+  std::cout << std::format("{:<16} {:>10} {:>10} {:>10} {:>10}\n", what, at(0.50), at(0.95), at(0.99), at(1.0));
+}
+
+/**
+ * Return the options given on the command line, or an empty optional if they
+ * are not valid.
+ */
+std::optional<Options> parse_options(int argc, char *argv[]) {
+  Options options;
+  for (int i{1}; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (arg == "--processes") {
+      options.processes = true;
+      continue;
+    }
+    if (i + 1 >= argc) return std::nullopt;
+    std::string_view value{argv[++i]};
+    if (arg == "--queue") {
+      options.queueName = value;
+      continue;
+    }
+
+    std::optional<std::uint64_t> number{take_number<std::uint64_t>(value)};
+    if (!number || !value.empty()) return std::nullopt;
+    if (arg == "--clients" && *number > 0 && *number <= 1024) {
+      options.clients = static_cast<std::uint32_t>(*number);
+    } else if (arg == "--requests" && *number <= UINT32_MAX) {
+      options.requests = static_cast<std::uint32_t>(*number);
+    } else if (arg == "--rate" && *number <= UINT32_MAX) {
+      options.rate = static_cast<std::uint32_t>(*number);
+    } else if (arg == "--capacity" && *number > 0) {
+      options.capacity = *number;
+    } else {
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
+/**
+ * Run every setter, returning what each of them sent.
+ *
+ * `ready` is called once the setters are about to start, which for processes
+ * is after they have been forked, so that no other threads exist when they
+ * are.
+ */
+template<class F>
+std::optional<std::vector<ClientResult>> run_clients(const Options &options, F &&ready) {
+  std::vector<ClientResult> results(options.clients);
+  if (!options.processes) {
+    ready();
+    std::vector<std::thread> threads;
+    for (std::uint32_t client{0}; client < options.clients; ++client) {
+      threads.emplace_back([&options, &results, client] { results[client] = run_client(options, client); });
+    }
+    for (auto &thread : threads) thread.join();
+    return results;
+  }
+
+#ifdef _WIN32
+  std::cerr << "--processes is not supported on Windows\n";
+  return std::nullopt;
+#else
+  // Each setter waits for the start pipe to close, so that they all start
+  // together once the waiter side is running, and reports on a pipe of its own.
+  int start[2];
+  if (::pipe(start) != 0) return std::nullopt;
+  std::vector<std::pair<::pid_t, int>> children;
+  for (std::uint32_t client{0}; client < options.clients; ++client) {
+    int report[2];
+    if (::pipe(report) != 0) return std::nullopt;
+    const auto pid{::fork()};
+    if (pid < 0) return std::nullopt;
+    if (pid == 0) {
+      ::close(start[1]);
+      ::close(report[0]);
+      char c;
+      [[maybe_unused]] const auto ignored{::read(start[0], &c, 1)};
+      const auto result{run_client(options, client)};
+      const auto written{::write(report[1], &result, sizeof(result))};
+      ::_exit(written == sizeof(result) ? 0 : 1);
+    }
+    ::close(report[1]);
+    children.emplace_back(pid, report[0]);
+  }
+  ::close(start[0]);
+
+  ready();
+  ::close(start[1]);
+  bool ok{true};
+  for (std::uint32_t client{0}; client < options.clients; ++client) {
+    const auto [pid, fd]{children[client]};
+    ok = ::read(fd, &results[client], sizeof(ClientResult)) == sizeof(ClientResult) && ok;
+    ::close(fd);
+    int status{};
+    ::waitpid(pid, &status, 0);
+  }
+  if (!ok) return std::nullopt;
+  return results;
+#endif
+}
+
+}// namespace
+
+int main(int argc, char *argv[]) try {
+  const auto options{parse_options(argc, argv)};
+  if (!options) {
+    std::cerr << "usage: ipc_stress [--clients <n>] [--requests <n>] [--rate <per second>]\n"
+                 "                  [--capacity <n>] [--queue <name>] [--processes]\n";
+    return 1;
+  }
+
+  // A queue left behind by an earlier run that was killed is replaced.
+  ipc::message_queue::remove(options->queueName.c_str());
+  ipc::message_queue queue{ipc::create_only, options->queueName.c_str(), options->capacity, em::MaxMessageSize};
+  StressWaiter waiter{queue, options->clients};
+
+  SteadyClock::time_point start;
+  const auto results{run_clients(*options, [&] {
+    waiter.start();
+    start = SteadyClock::now();
+  })};
+  const auto sendElapsed{SteadyClock::now() - start};
+  if (!results) {
+    std::cerr << "Could not run setters\n";
+    ipc::message_queue::remove(options->queueName.c_str());
+    return 1;
+  }
+  waiter.finish();
+  ipc::message_queue::remove(options->queueName.c_str());
+
+  ClientResult total;
+  bool converged{true};
+  for (std::uint32_t client{0}; client < options->clients; ++client) {
+    const auto &result{(*results)[client]};
+    total.delivered += result.delivered;
+    total.rejected += result.rejected;
+    // The queue keeps each setter's requests in order, so the waiter must have
+    // run the last one that was delivered.
+    converged = converged && waiter.last_handled()[client] == result.lastDelivered;
+  }
+
+  const auto sendMs{std::chrono::duration_cast<std::chrono::milliseconds>(sendElapsed).count()};
+  std::cout << std::format("{} {} sent {} requests in {} ms through a queue of {}\n", options->clients,
+                           options->processes ? "processes" : "threads", total.delivered + total.rejected,
+                           sendMs, options->capacity);
+  std::cout << std::format("delivered {}, rejected {} ({:.1f}%), invalid {}\n", total.delivered, total.rejected,
+                           total.delivered + total.rejected > 0
+                               ? 100.0 * static_cast<double>(total.rejected) /
+                                     static_cast<double>(total.delivered + total.rejected)
+                               : 0.0,
+                           waiter.invalid());
+  std::cout << std::format("{:<16} {:>10} {:>10} {:>10} {:>10}\n", "latency", "p50 (us)", "p95 (us)", "p99 (us)",
+                           "max (us)");
+  print_latencies("received", waiter.queue_latencies());
+  print_latencies("handled", waiter.handle_latencies());
+  std::cout << std::format("final profile {}, {}\n",
+                           waiter.final_profile().empty() ? "(none)" : waiter.final_profile(),
+                           converged ? "converged" : "NOT converged");
+  return converged ? 0 : 2;
+} catch (const std::exception &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}
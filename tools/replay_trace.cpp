@@ -0,0 +1,361 @@
+// Replay a trace recorded by a waiter started with `--trace` against an
+// in-memory model of the audio sessions, and report how long each kind of
+// record took to handle.
+//
+// Usage: replay_trace <trace> [--config <config.toml>] [--speed <factor>] [--sessions]
+//
+// Records are replayed at the speed they were recorded, or `factor` times
+// faster. A factor of 0 replays them back to back, which is the one to use
+// when benchmarking. `--config` replaces the config path of every request,
+// since the recorded one is usually on another machine. `--sessions` prints
+// the volume of every session still open at the end of the trace.
+//
+// The session model stands in for the COM sessions that the waiter sets, and
+// the matching mirrors the waiter's: new sessions are matched through the
+// memo of the active profile, pushing or popping a layer only looks at the
+// sessions that the layer's controls match, and replacing the profile looks
+// at every session as the setter making the request would. Overrides are laid
+// over the top layer, and setting or clearing them only looks at the sessions
+// that they match. Each command of a batch is replayed on its own, so a
+// session changed by several of them may be set more than once. Only image paths
+// are recorded, so controls matching the display name, icon path or session
+// identifier never match, and nor do ancestor controls.
+
+#include "declvol/match_memo.h"
+#include "declvol/profile.h"
+#include "declvol/trace.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct Options {
+  std::filesystem::path tracePath;
+  std::optional<std::filesystem::path> configPath;
+  double speed{1.0};
+  bool printSessions{};
+};
+
+/**
+ * A session of the model, standing in for an `IAudioSessionControl`.
+ */
+struct Session {
+  std::uint32_t pid{};
+  std::string name;
+  // Volume last set by a control, if any has matched.
+  std::optional<float> volume;
+};
+
+/**
+ * A layer of the active profile, as kept by the waiter.
+ */
+struct Layer {
+  std::shared_ptr<const em::VolumeProfile> own;
+  std::shared_ptr<em::MatchMemo> merged;
+};
+
+/**
+ * Times taken to handle each record of one kind.
+ */
+struct Timings {
+  std::vector<SteadyClock::duration> samples;
+
+  void print(std::string_view kind) {
+    if (samples.empty()) return;
+    std::ranges::sort(samples);
+    const auto at{[this](double p) {
+      const auto rank{static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1) + 0.5)};
+      return std::chrono::duration_cast<std::chrono::microseconds>(samples[rank]).count();
+    }};
+    std::cout << std::format("{:<16} {:>8} {:>10} {:>10} {:>10} {:>10}\n", kind, samples.size(),
+                             at(0.50), at(0.95), at(0.99), at(1.0));
+  }
+};
+
+/**
+ * Return the options given on the command line, or an empty optional if they
+ * are not valid.
+ */
+std::optional<Options> parse_options(int argc, char *argv[]) {
+  Options options;
+  bool haveTrace{};
+  for (int i{1}; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (arg == "--config" && i + 1 < argc) {
+      options.configPath = argv[++i];
+    } else if (arg == "--speed" && i + 1 < argc) {
+      const std::string_view value{argv[++i]};
+      const auto [end, ec]{std::from_chars(value.data(), value.data() + value.size(), options.speed)};
+      if (ec != std::errc{} || end != value.data() + value.size() || options.speed < 0.0) {
+        return std::nullopt;
+      }
+    } else if (arg == "--sessions") {
+      options.printSessions = true;
+    } else if (!haveTrace && !arg.starts_with("--")) {
+      options.tracePath = arg;
+      haveTrace = true;
+    } else {
+      return std::nullopt;
+    }
+  }
+  if (!haveTrace) return std::nullopt;
+  return options;
+}
+
+/**
+ * Replays the records of a trace against the session model.
+ */
+class Replayer {
+public:
+  explicit Replayer(std::optional<std::filesystem::path> configPath)
+      : mConfigPath{std::move(configPath)} {}
+
+  void replay(const em::TraceRecord &record) {
+    switch (record.kind) {
+    case em::TraceKind::SessionCreated: session_created(record); break;
+    case em::TraceKind::SessionEnded: mSessions.erase(record.session); break;
+    case em::TraceKind::Request: request(record); break;
+    case em::TraceKind::Override: set_override(record); break;
+    case em::TraceKind::ClearOverrides: clear_overrides(); break;
+    }
+  }
+
+  [[nodiscard]] const std::map<std::uint64_t, Session> &sessions() const noexcept {
+    return mSessions;
+  }
+
+  [[nodiscard]] std::size_t volumes_set() const noexcept {
+    return mVolumesSet;
+  }
+
+  [[nodiscard]] std::size_t failed_requests() const noexcept {
+    return mFailedRequests;
+  }
+
+private:
+  void session_created(const em::TraceRecord &record) {
+    Session session{record.pid, record.name, {}};
+    if (mActive) {
+      auto &memo{*mActive};
+      const auto *control{session.name == ":system" ? em::find_control(memo.profile(), ":system")
+                                                    : memo.match(session.name)};
+      control = memo.index().match(control, no_fields);
+      if (control) set_volume(session, *control);
+    }
+    mSessions.insert_or_assign(record.session, std::move(session));
+  }
+
+  void request(const em::TraceRecord &record) {
+    try {
+      const auto previous{active_profile()};
+      std::shared_ptr<const em::VolumeProfile> changed;
+      switch (record.operation) {
+      case em::wire::Operation::Replace:
+        mLayers.clear();
+        mLayers.push_back(make_layer(read_profile(record), nullptr));
+        // As in the waiter, switching profile clears the overrides.
+        mOverrides = std::make_shared<const em::VolumeProfile>();
+        break;
+      case em::wire::Operation::Push:
+        if (mLayers.empty()) throw em::ProfileError("[error] Cannot push a layer without a profile");
+        mLayers.push_back(make_layer(read_profile(record), &mLayers.back().merged->profile()));
+        changed = mLayers.back().own;
+        break;
+      case em::wire::Operation::Pop:
+        if (mLayers.size() < 2) throw em::ProfileError("[error] There is no layer to pop");
+        changed = mLayers.back().own;
+        mLayers.pop_back();
+        break;
+      }
+      mActive = make_active(mLayers.back().merged, *mOverrides);
+      if (previous) apply_change(*previous, *active_profile(), changed.get());
+    } catch (const em::ProfileError &e) {
+      // As in the waiter, a bad request is reported and the profile is left
+      // as it was.
+      std::cerr << e.what() << '\n';
+      ++mFailedRequests;
+    }
+  }
+
+  void set_override(const em::TraceRecord &record) {
+    if (!mActive) return;
+    auto overridden{std::make_shared<em::VolumeProfile>()};
+    try {
+      overridden->controls.emplace_back(record.suffix, record.volume);
+    } catch (const std::invalid_argument &e) {
+      std::cerr << std::format("[error] Could not override {}: {}\n", record.suffix, e.what());
+      ++mFailedRequests;
+      return;
+    }
+    const auto previous{active_profile()};
+    mOverrides = std::make_shared<const em::VolumeProfile>(em::overlay_profile(*mOverrides, *overridden));
+    mActive = make_active(mLayers.back().merged, *mOverrides);
+    apply_change(*previous, *active_profile(), overridden.get());
+  }
+
+  void clear_overrides() {
+    if (!mActive) return;
+    const auto previous{active_profile()};
+    const auto cleared{std::exchange(mOverrides, std::make_shared<const em::VolumeProfile>())};
+    mActive = mLayers.back().merged;
+    apply_change(*previous, *active_profile(), cleared.get());
+  }
+
+  /**
+   * Set the sessions whose winning control has a different volume in
+   * `current`, only looking at those that `changed` matches if it is given.
+   */
+  void apply_change(const em::VolumeProfile &previous, const em::VolumeProfile &current,
+                    const em::VolumeProfile *changed) {
+    const em::ControlIndex previousIndex{previous};
+    const em::ControlIndex currentIndex{current};
+    std::optional<em::ControlIndex> changedIndex;
+    if (changed) changedIndex.emplace(*changed);
+
+    for (auto &[id, session] : mSessions) {
+      if (changedIndex && !changedIndex->match(em::match_control(*changed, session.name), no_fields)) continue;
+      const auto *control{currentIndex.match(em::match_control(current, session.name), no_fields)};
+      if (!control) continue;
+      const auto *before{previousIndex.match(em::match_control(previous, session.name), no_fields)};
+      if (before && before->relative_volume() == control->relative_volume()) continue;
+      set_volume(session, *control);
+    }
+  }
+
+  std::shared_ptr<const em::VolumeProfile> read_profile(const em::TraceRecord &record) {
+    const std::filesystem::path configPath{mConfigPath ? *mConfigPath : std::filesystem::path{record.configPath}};
+    std::pmr::monotonic_buffer_resource arena;
+    const auto profiles{em::parse_profiles_toml(configPath, &arena)};
+    const auto it{profiles.find(std::string_view{record.profile})};
+    if (it == profiles.end()) {
+      throw em::ProfileError(configPath, std::format("Profile {} does not exist", record.profile));
+    }
+    return std::make_shared<const em::VolumeProfile>(it->second);
+  }
+
+  static Layer make_layer(std::shared_ptr<const em::VolumeProfile> own, const em::VolumeProfile *below) {
+    auto merged{below ? std::make_shared<em::MatchMemo>(
+                            std::make_shared<const em::VolumeProfile>(em::overlay_profile(*below, *own)))
+                      : std::make_shared<em::MatchMemo>(own)};
+    return {std::move(own), std::move(merged)};
+  }
+
+  /**
+   * Return the memo of the top layer `top` with `overrides` over it.
+   */
+  static std::shared_ptr<em::MatchMemo> make_active(std::shared_ptr<em::MatchMemo> top,
+                                                    const em::VolumeProfile &overrides) {
+    if (overrides.controls.empty()) return top;
+    return std::make_shared<em::MatchMemo>(
+        std::make_shared<const em::VolumeProfile>(em::overlay_profile(top->profile(), overrides)));
+  }
+
+  std::shared_ptr<const em::VolumeProfile> active_profile() const {
+    // The memo holds the profile, so the profile shares its ownership.
+    if (!mActive) return nullptr;
+    return {mActive, &mActive->profile()};
+  }
+
+  static std::optional<std::string> no_fields(em::MatchKind) {
+    return std::nullopt;
+  }
+
+  void set_volume(Session &session, const em::VolumeControl &control) {
+    session.volume = control.relative_volume();
+    ++mVolumesSet;
+  }
+
+  std::optional<std::filesystem::path> mConfigPath;
+  std::vector<Layer> mLayers;
+  // Controls set by overrides, over the top layer.
+  std::shared_ptr<const em::VolumeProfile> mOverrides{std::make_shared<const em::VolumeProfile>()};
+  // Memo of the top layer with the overrides over it, or null before the
+  // first request.
+  std::shared_ptr<em::MatchMemo> mActive;
+  std::map<std::uint64_t, Session> mSessions;
+  std::size_t mVolumesSet{0};
+  std::size_t mFailedRequests{0};
+};
+
+}// namespace
+
+int main(int argc, char *argv[]) try {
+  const auto options{parse_options(argc, argv)};
+  if (!options) {
+    std::cerr << "usage: replay_trace <trace> [--config <config.toml>] [--speed <factor>] [--sessions]\n";
+    return 1;
+  }
+
+  em::TraceReader reader{options->tracePath};
+  Replayer replayer{options->configPath};
+  Timings created;
+  Timings ended;
+  Timings requests;
+  Timings overrides;
+
+  const auto start{SteadyClock::now()};
+  while (const auto record{reader.next()}) {
+    if (options->speed > 0.0) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration_cast<SteadyClock::duration>(record->time / options->speed));
+    }
+
+    const auto before{SteadyClock::now()};
+    replayer.replay(*record);
+    const auto taken{SteadyClock::now() - before};
+    switch (record->kind) {
+    case em::TraceKind::SessionCreated: created.samples.push_back(taken); break;
+    case em::TraceKind::SessionEnded: ended.samples.push_back(taken); break;
+    case em::TraceKind::Request: requests.samples.push_back(taken); break;
+    case em::TraceKind::Override:
+    case em::TraceKind::ClearOverrides: overrides.samples.push_back(taken); break;
+    }
+  }
+  const auto elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - start)};
+
+  std::cout << std::format("Replayed {} records in {} ms, setting {} volumes\n",
+                           created.samples.size() + ended.samples.size() + requests.samples.size()
+                               + overrides.samples.size(),
+                           elapsed.count(), replayer.volumes_set());
+  if (replayer.failed_requests() > 0) {
+    std::cout << std::format("{} requests failed\n", replayer.failed_requests());
+  }
+  std::cout << std::format("{:<16} {:>8} {:>10} {:>10} {:>10} {:>10}\n", "record", "count",
+                           "p50 (us)", "p95 (us)", "p99 (us)", "max (us)");
+  created.print("session created");
+  ended.print("session ended");
+  requests.print("request");
+  overrides.print("override");
+
+  if (options->printSessions) {
+    for (const auto &[id, session] : replayer.sessions()) {
+      if (session.volume) {
+        std::cout << std::format("{} {} {}\n", session.pid, session.name, *session.volume);
+      } else {
+        std::cout << std::format("{} {} -\n", session.pid, session.name);
+      }
+    }
+  }
+  return 0;
+} catch (const em::VolumeException &e) {
+  std::cerr << e.what() << '\n';
+  return 1;
+}